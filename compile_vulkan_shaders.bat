@@ -7,6 +7,9 @@ if %ERRORLEVEL% EQU 0 (
     echo Using glslc compiler...
     glslc shaders/vulkan/basic.vert -o shaders/vulkan/basic.vert.spv
     glslc shaders/vulkan/basic.frag -o shaders/vulkan/basic.frag.spv
+    glslc shaders/vulkan/instanced.vert -o shaders/vulkan/instanced.vert.spv
+    glslc shaders/vulkan/indirect.vert -o shaders/vulkan/indirect.vert.spv
+    glslc shaders/vulkan/cull.comp -o shaders/vulkan/cull.comp.spv
     echo Shaders compiled successfully!
 ) else (
     REM Try glslangValidator
@@ -15,6 +18,9 @@ if %ERRORLEVEL% EQU 0 (
         echo Using glslangValidator compiler...
         glslangValidator -V shaders/vulkan/basic.vert -o shaders/vulkan/basic.vert.spv
         glslangValidator -V shaders/vulkan/basic.frag -o shaders/vulkan/basic.frag.spv
+        glslangValidator -V shaders/vulkan/instanced.vert -o shaders/vulkan/instanced.vert.spv
+        glslangValidator -V shaders/vulkan/indirect.vert -o shaders/vulkan/indirect.vert.spv
+        glslangValidator -V shaders/vulkan/cull.comp -o shaders/vulkan/cull.comp.spv
         echo Shaders compiled successfully!
     ) else (
         echo ERROR: No Vulkan shader compiler found!
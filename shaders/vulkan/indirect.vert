@@ -0,0 +1,37 @@
+#version 450
+
+// Vertex shader of the GPU-driven path, the model matrix comes from the object buffer
+// indexed by the firstInstance the culling pass wrote, the push constant one is unused
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aColor;
+layout (location = 2) in vec2 aTexCoord;
+
+layout (location = 0) out vec3 vertexColor;
+layout (location = 1) out vec2 texCoord;
+
+struct ObjectData
+{
+    mat4 model;
+    vec4 boundingSphere;
+    uint indexCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint padding;
+};
+
+layout (set = 3, binding = 0) readonly buffer Objects { ObjectData objects[]; };
+
+layout (push_constant) uniform PushConstants {
+    mat4 model;
+    mat4 view;
+    mat4 projection;
+} pushConstants;
+
+void main()
+{
+    mat4 model = objects[gl_InstanceIndex].model;
+    gl_Position = pushConstants.projection * pushConstants.view * model * vec4(aPos, 1.0);
+    vertexColor = aColor;
+    texCoord = aTexCoord;
+}
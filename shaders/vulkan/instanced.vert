@@ -0,0 +1,25 @@
+#version 450
+
+// Vertex shader of instanced draws, the model matrix is a per-instance attribute
+// (RenderMesh::drawInstanced), the push constant one is unused
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aColor;
+layout (location = 2) in vec2 aTexCoord;
+layout (location = 4) in mat4 aInstanceModel;  // Locations 4 to 7
+
+layout (location = 0) out vec3 vertexColor;
+layout (location = 1) out vec2 texCoord;
+
+layout (push_constant) uniform PushConstants {
+    mat4 model;
+    mat4 view;
+    mat4 projection;
+} pushConstants;
+
+void main()
+{
+    gl_Position = pushConstants.projection * pushConstants.view * aInstanceModel * vec4(aPos, 1.0);
+    vertexColor = aColor;
+    texCoord = aTexCoord;
+}
@@ -121,8 +121,12 @@ void Application::run()
 
         onUpdate(m_deltaTime);
 
+        m_renderer->beginFrame();
+        m_renderer->beginPass();
         m_renderer->clear();
         onRender();
+        m_renderer->endPass();
+        m_renderer->endFrame();
 
         m_window->swapBuffers();
         m_window->pollEvents();
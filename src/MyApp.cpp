@@ -59,6 +59,9 @@ void MyApp::onInit()
     // Compute normals
     m_triangleMesh->computeFlatNormals();
 
+    // Mesh and texture uploads go out in one submission
+    m_renderer->beginUploadBatch();
+
     // Upload mesh to GPU using RenderMesh
     LOG_INFO("Creating RenderMesh with {} vertices, {} indices",
              m_triangleMesh->getVertexCount(), m_triangleMesh->getIndexCount());
@@ -75,6 +78,8 @@ void MyApp::onInit()
     m_texture->setWrap(TextureWrap::Repeat, TextureWrap::Repeat);
     LOG_INFO("Checkerboard texture created successfully");
 
+    m_renderer->submitUploadBatch();
+
     // Create material with shader and texture
     m_material = std::make_unique<Graphics::Material>(m_basicShader);
     m_material->setTexture("textureSampler", m_texture, 0);  // Bind texture to sampler uniform at unit 0
@@ -0,0 +1,180 @@
+#include "ComputeProgram.h"
+#include "StorageBuffer.h"
+#include "GLExtensions.h"
+#include "../Logger.h"
+#include <GLFW/glfw3.h>
+#include <glm/gtc/type_ptr.hpp>
+
+// ARB_compute_shader and ARB_shader_storage_buffer_object, not part of the GL 3.3 headers
+#ifndef GL_SHADER_STORAGE_BUFFER
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#endif
+#ifndef GL_DISPATCH_INDIRECT_BUFFER
+#define GL_DISPATCH_INDIRECT_BUFFER 0x90EE
+#endif
+
+namespace OGL
+{
+
+typedef void (APIENTRY *DispatchComputeProc)(GLuint groupsX, GLuint groupsY, GLuint groupsZ);
+typedef void (APIENTRY *DispatchComputeIndirectProc)(GLintptr indirect);
+typedef void (APIENTRY *MemoryBarrierProc)(GLbitfield barriers);
+
+static DispatchComputeProc s_dispatchCompute = nullptr;
+static DispatchComputeIndirectProc s_dispatchComputeIndirect = nullptr;
+static MemoryBarrierProc s_memoryBarrier = nullptr;
+
+bool ComputeProgram::loadFunctions()
+{
+    s_dispatchCompute = nullptr;
+    s_dispatchComputeIndirect = nullptr;
+    s_memoryBarrier = nullptr;
+
+    GLint major = 0;
+    GLint minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+
+    bool core = major > 4 || (major == 4 && minor >= 3);
+    if (!core && !(isExtensionSupported("GL_ARB_compute_shader") &&
+                   isExtensionSupported("GL_ARB_shader_storage_buffer_object")))
+    {
+        LOG_INFO("Compute shaders not supported (OpenGL {}.{}), dispatches are ignored", major, minor);
+        return false;
+    }
+
+    s_dispatchCompute = reinterpret_cast<DispatchComputeProc>(glfwGetProcAddress("glDispatchCompute"));
+    s_dispatchComputeIndirect = reinterpret_cast<DispatchComputeIndirectProc>(glfwGetProcAddress("glDispatchComputeIndirect"));
+    s_memoryBarrier = reinterpret_cast<MemoryBarrierProc>(glfwGetProcAddress("glMemoryBarrier"));
+
+    if (!isSupported())
+    {
+        LOG_WARNING("Failed to load the compute entry points, dispatches are ignored");
+        return false;
+    }
+    return true;
+}
+
+bool ComputeProgram::isSupported()
+{
+    return s_dispatchCompute && s_dispatchComputeIndirect && s_memoryBarrier;
+}
+
+void ComputeProgram::memoryBarrier(GLbitfield barriers)
+{
+    if (s_memoryBarrier)
+    {
+        s_memoryBarrier(barriers);
+    }
+}
+
+ComputeProgram::ComputeProgram(const std::string& name, GLShaderProgram&& program)
+    : m_name(name)
+    , m_program(std::move(program))
+{
+}
+
+void ComputeProgram::setStorageBuffer(unsigned int binding, IStorageBuffer* buffer)
+{
+    if (binding >= m_storageBuffers.size())
+    {
+        m_storageBuffers.resize(binding + 1, nullptr);
+    }
+    m_storageBuffers[binding] = static_cast<StorageBuffer*>(buffer);
+}
+
+GLuint ComputeProgram::useProgram()
+{
+    GLint previous = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &previous);
+    glUseProgram(m_program.get());
+    return static_cast<GLuint>(previous);
+}
+
+void ComputeProgram::setInt(const std::string& name, int value)
+{
+    GLuint previous = useProgram();
+    glUniform1i(glGetUniformLocation(m_program.get(), name.c_str()), value);
+    glUseProgram(previous);
+}
+
+void ComputeProgram::setUInt(const std::string& name, unsigned int value)
+{
+    GLuint previous = useProgram();
+    glUniform1ui(glGetUniformLocation(m_program.get(), name.c_str()), value);
+    glUseProgram(previous);
+}
+
+void ComputeProgram::setFloat(const std::string& name, float value)
+{
+    GLuint previous = useProgram();
+    glUniform1f(glGetUniformLocation(m_program.get(), name.c_str()), value);
+    glUseProgram(previous);
+}
+
+void ComputeProgram::setVec2(const std::string& name, const glm::vec2& value)
+{
+    GLuint previous = useProgram();
+    glUniform2fv(glGetUniformLocation(m_program.get(), name.c_str()), 1, glm::value_ptr(value));
+    glUseProgram(previous);
+}
+
+void ComputeProgram::setVec3(const std::string& name, const glm::vec3& value)
+{
+    GLuint previous = useProgram();
+    glUniform3fv(glGetUniformLocation(m_program.get(), name.c_str()), 1, glm::value_ptr(value));
+    glUseProgram(previous);
+}
+
+void ComputeProgram::setVec4(const std::string& name, const glm::vec4& value)
+{
+    GLuint previous = useProgram();
+    glUniform4fv(glGetUniformLocation(m_program.get(), name.c_str()), 1, glm::value_ptr(value));
+    glUseProgram(previous);
+}
+
+void ComputeProgram::setMat4(const std::string& name, const glm::mat4& value)
+{
+    GLuint previous = useProgram();
+    glUniformMatrix4fv(glGetUniformLocation(m_program.get(), name.c_str()), 1, GL_FALSE, glm::value_ptr(value));
+    glUseProgram(previous);
+}
+
+void ComputeProgram::bindStorageBuffers()
+{
+    for (size_t binding = 0; binding < m_storageBuffers.size(); binding++)
+    {
+        GLuint buffer = m_storageBuffers[binding] ? m_storageBuffers[binding]->getID() : 0;
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, static_cast<GLuint>(binding), buffer);
+    }
+}
+
+void ComputeProgram::dispatch(GLuint groupsX, GLuint groupsY, GLuint groupsZ)
+{
+    if (!isSupported())
+    {
+        return;
+    }
+
+    GLuint previous = useProgram();
+    bindStorageBuffers();
+    s_dispatchCompute(groupsX, groupsY, groupsZ);
+    glUseProgram(previous);
+}
+
+void ComputeProgram::dispatchIndirect(const StorageBuffer& arguments, size_t offset)
+{
+    if (!isSupported())
+    {
+        return;
+    }
+
+    GLuint previous = useProgram();
+    bindStorageBuffers();
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, arguments.getID());
+    s_dispatchComputeIndirect(static_cast<GLintptr>(offset));
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+    glUseProgram(previous);
+}
+
+} // namespace OGL
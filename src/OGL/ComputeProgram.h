@@ -0,0 +1,59 @@
+#pragma once
+
+#include "../RenderAPI/IComputeProgram.h"
+#include "GLResource.h"
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+namespace OGL
+{
+    class StorageBuffer;
+
+    /**
+     * OpenGL implementation of IComputeProgram
+     * Compute shaders and storage buffers are GL 4.3, past the GL 3.3 functions loaded by
+     * GLAD. The few entry points used here are loaded by loadFunctions(), which also
+     * decides whether compute is supported at all.
+     */
+    class ComputeProgram : public IComputeProgram
+    {
+    public:
+        ComputeProgram(const std::string& name, GLShaderProgram&& program);
+        ~ComputeProgram() override = default;
+
+        // IComputeProgram interface
+        void setStorageBuffer(unsigned int binding, IStorageBuffer* buffer) override;
+
+        void setInt(const std::string& name, int value) override;
+        void setUInt(const std::string& name, unsigned int value) override;
+        void setFloat(const std::string& name, float value) override;
+        void setVec2(const std::string& name, const glm::vec2& value) override;
+        void setVec3(const std::string& name, const glm::vec3& value) override;
+        void setVec4(const std::string& name, const glm::vec4& value) override;
+        void setMat4(const std::string& name, const glm::mat4& value) override;
+
+        bool isValid() const override { return m_program.isValid(); }
+        const std::string& getName() const override { return m_name; }
+
+        // The current program is restored afterwards
+        void dispatch(GLuint groupsX, GLuint groupsY, GLuint groupsZ);
+        void dispatchIndirect(const StorageBuffer& arguments, size_t offset);
+
+        // Called once the context is current and GLAD is loaded
+        static bool loadFunctions();
+        static bool isSupported();
+        static void memoryBarrier(GLbitfield barriers);
+
+    private:
+        // Makes the program current for a uniform update, returns the previous one
+        GLuint useProgram();
+        void bindStorageBuffers();
+
+        std::string m_name;
+        GLShaderProgram m_program;
+        std::vector<StorageBuffer*> m_storageBuffers;  // Indexed by binding
+    };
+
+} // namespace OGL
@@ -0,0 +1,23 @@
+#include "GLExtensions.h"
+#include <glad/glad.h>
+#include <cstring>
+
+namespace OGL
+{
+
+bool isExtensionSupported(const char* name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; i++)
+    {
+        const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if (extension && std::strcmp(extension, name) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace OGL
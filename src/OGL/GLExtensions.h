@@ -0,0 +1,7 @@
+#pragma once
+
+namespace OGL
+{
+    // Whether the current context lists the extension, e.g. "GL_ARB_compute_shader"
+    bool isExtensionSupported(const char* name);
+}
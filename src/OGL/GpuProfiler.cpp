@@ -0,0 +1,242 @@
+#include "GpuProfiler.h"
+#include "GLExtensions.h"
+#include "../Logger.h"
+
+// ARB_pipeline_statistics_query, not part of the GL 3.3 headers
+#ifndef GL_VERTICES_SUBMITTED_ARB
+#define GL_VERTICES_SUBMITTED_ARB 0x82EE
+#define GL_PRIMITIVES_SUBMITTED_ARB 0x82EF
+#define GL_VERTEX_SHADER_INVOCATIONS_ARB 0x82F0
+#define GL_FRAGMENT_SHADER_INVOCATIONS_ARB 0x82F4
+#define GL_CLIPPING_INPUT_PRIMITIVES_ARB 0x82F6
+#define GL_CLIPPING_OUTPUT_PRIMITIVES_ARB 0x82F7
+#endif
+
+namespace OGL
+{
+
+GpuProfiler::GpuProfiler()
+    : m_currentFrame(0)
+    , m_overflowWarned(false)
+    , m_statisticsTargets{}
+    , m_statisticsCounters{}
+    , m_statisticsCount(0)
+    , m_statisticsValid(false)
+{
+    if (isExtensionSupported("GL_ARB_pipeline_statistics_query"))
+    {
+        m_statisticsTargets[0] = GL_VERTICES_SUBMITTED_ARB;
+        m_statisticsCounters[0] = &GpuPipelineStatistics::inputVertices;
+        m_statisticsTargets[1] = GL_PRIMITIVES_SUBMITTED_ARB;
+        m_statisticsCounters[1] = &GpuPipelineStatistics::inputPrimitives;
+        m_statisticsTargets[2] = GL_VERTEX_SHADER_INVOCATIONS_ARB;
+        m_statisticsCounters[2] = &GpuPipelineStatistics::vertexShaderInvocations;
+        m_statisticsTargets[3] = GL_CLIPPING_INPUT_PRIMITIVES_ARB;
+        m_statisticsCounters[3] = &GpuPipelineStatistics::clippingInvocations;
+        m_statisticsTargets[4] = GL_CLIPPING_OUTPUT_PRIMITIVES_ARB;
+        m_statisticsCounters[4] = &GpuPipelineStatistics::clippingPrimitives;
+        m_statisticsTargets[5] = GL_FRAGMENT_SHADER_INVOCATIONS_ARB;
+        m_statisticsCounters[5] = &GpuPipelineStatistics::fragmentShaderInvocations;
+        m_statisticsCount = 6;
+    }
+    else
+    {
+        // Primitives leaving the vertex stage are the ones entering clipping
+        m_statisticsTargets[0] = GL_PRIMITIVES_GENERATED;
+        m_statisticsCounters[0] = &GpuPipelineStatistics::clippingInvocations;
+        m_statisticsCount = 1;
+        LOG_INFO("GL_ARB_pipeline_statistics_query not supported, only primitives generated are counted");
+    }
+}
+
+GpuProfiler::~GpuProfiler()
+{
+    for (FrameQueries& frame : m_frames)
+    {
+        if (!frame.queries.empty())
+        {
+            glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+        }
+        if (frame.statisticsQueries[0] != 0)
+        {
+            glDeleteQueries(static_cast<GLsizei>(m_statisticsCount), frame.statisticsQueries);
+        }
+    }
+}
+
+void GpuProfiler::beginFrame(bool collectStatistics)
+{
+    m_currentFrame = (m_currentFrame + 1) % FRAME_LATENCY;
+
+    FrameQueries& frame = m_frames[m_currentFrame];
+    resolve(frame);
+    resolveStatistics(frame);
+
+    frame.zones.clear();
+    frame.queryCount = 0;
+    m_openZones.clear();
+
+    frame.statisticsActive = collectStatistics;
+    if (frame.statisticsActive)
+    {
+        if (frame.statisticsQueries[0] == 0)
+        {
+            glGenQueries(static_cast<GLsizei>(m_statisticsCount), frame.statisticsQueries);
+        }
+        for (uint32_t i = 0; i < m_statisticsCount; i++)
+        {
+            glBeginQuery(m_statisticsTargets[i], frame.statisticsQueries[i]);
+        }
+    }
+}
+
+void GpuProfiler::endFrame()
+{
+    while (!m_openZones.empty())
+    {
+        endZone();
+    }
+
+    if (m_frames[m_currentFrame].statisticsActive)
+    {
+        for (uint32_t i = 0; i < m_statisticsCount; i++)
+        {
+            glEndQuery(m_statisticsTargets[i]);
+        }
+    }
+}
+
+bool GpuProfiler::getPipelineStatistics(GpuPipelineStatistics& statistics) const
+{
+    if (!m_statisticsValid)
+    {
+        return false;
+    }
+
+    statistics = m_statistics;
+    return true;
+}
+
+void GpuProfiler::beginZone(const std::string& name)
+{
+    FrameQueries& frame = m_frames[m_currentFrame];
+
+    // Zones past the limit are dropped, their end is still matched
+    if (frame.zones.size() >= MAX_ZONES_PER_FRAME)
+    {
+        if (!m_overflowWarned)
+        {
+            LOG_WARNING("More than {} GPU zones in a frame, the rest are not timed", MAX_ZONES_PER_FRAME);
+            m_overflowWarned = true;
+        }
+        m_openZones.push_back(UINT32_MAX);
+        return;
+    }
+
+    Zone zone;
+    zone.name = name;
+    zone.depth = static_cast<uint32_t>(m_openZones.size());
+    zone.endQuery = UINT32_MAX;
+    glQueryCounter(acquireQuery(frame, zone.beginQuery), GL_TIMESTAMP);
+
+    m_openZones.push_back(static_cast<uint32_t>(frame.zones.size()));
+    frame.zones.push_back(std::move(zone));
+}
+
+void GpuProfiler::endZone()
+{
+    if (m_openZones.empty())
+    {
+        return;
+    }
+
+    uint32_t zoneIndex = m_openZones.back();
+    m_openZones.pop_back();
+
+    if (zoneIndex == UINT32_MAX)
+    {
+        return;
+    }
+
+    FrameQueries& frame = m_frames[m_currentFrame];
+    Zone& zone = frame.zones[zoneIndex];
+    glQueryCounter(acquireQuery(frame, zone.endQuery), GL_TIMESTAMP);
+}
+
+GLuint GpuProfiler::acquireQuery(FrameQueries& frame, uint32_t& index)
+{
+    if (frame.queryCount == frame.queries.size())
+    {
+        GLuint query = 0;
+        glGenQueries(1, &query);
+        frame.queries.push_back(query);
+    }
+
+    index = frame.queryCount++;
+    return frame.queries[index];
+}
+
+void GpuProfiler::resolve(FrameQueries& frame)
+{
+    if (frame.queryCount == 0)
+    {
+        return;
+    }
+
+    // Queries complete in order, the last one being available means all of them are
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(frame.queries[frame.queryCount - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available == GL_FALSE)
+    {
+        LOG_DEBUG("GPU zone results not available after {} frames, dropped", FRAME_LATENCY);
+        return;
+    }
+
+    m_results.clear();
+    for (const Zone& zone : frame.zones)
+    {
+        if (zone.endQuery == UINT32_MAX)
+        {
+            continue;
+        }
+
+        GLuint64 begin = 0;
+        GLuint64 end = 0;
+        glGetQueryObjectui64v(frame.queries[zone.beginQuery], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(frame.queries[zone.endQuery], GL_QUERY_RESULT, &end);
+
+        // Timestamps are in nanoseconds
+        GpuZoneTime time;
+        time.name = zone.name;
+        time.depth = zone.depth;
+        time.milliseconds = static_cast<double>(end - begin) / 1000000.0;
+        m_results.push_back(std::move(time));
+    }
+}
+
+void GpuProfiler::resolveStatistics(FrameQueries& frame)
+{
+    if (!frame.statisticsActive)
+    {
+        return;
+    }
+
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(frame.statisticsQueries[m_statisticsCount - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available == GL_FALSE)
+    {
+        LOG_DEBUG("Pipeline statistics not available after {} frames, dropped", FRAME_LATENCY);
+        return;
+    }
+
+    m_statistics = GpuPipelineStatistics();
+    for (uint32_t i = 0; i < m_statisticsCount; i++)
+    {
+        GLuint64 value = 0;
+        glGetQueryObjectui64v(frame.statisticsQueries[i], GL_QUERY_RESULT, &value);
+        m_statistics.*m_statisticsCounters[i] = value;
+    }
+    m_statisticsValid = true;
+}
+
+} // namespace OGL
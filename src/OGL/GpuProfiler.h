@@ -0,0 +1,80 @@
+#pragma once
+
+#include "../RenderAPI/IRenderer.h"
+#include <glad/glad.h>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace OGL
+{
+    // GL_TIMESTAMP queries written around named zones, kept in a ring of frames
+    // Timestamps rather than GL_TIME_ELAPSED queries, elapsed-time queries can't nest.
+    // Pipeline statistics are counted over the whole frame with GL_PRIMITIVES_GENERATED,
+    // and with the ARB_pipeline_statistics_query counters where the driver has them.
+    // A frame's results are read when its ring entry comes around again, if the GPU
+    // hasn't finished it by then its results are dropped instead of waited for.
+    class GpuProfiler
+    {
+    public:
+        GpuProfiler();
+        ~GpuProfiler();
+
+        GpuProfiler(const GpuProfiler&) = delete;
+        GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+        // Statistics queries are begun here and ended in endFrame()
+        void beginFrame(bool collectStatistics);
+        void endFrame();  // Closes the zones still open
+
+        void beginZone(const std::string& name);
+        void endZone();
+        size_t getOpenZoneCount() const { return m_openZones.size(); }
+
+        // Zones of the most recently resolved frame
+        const std::vector<GpuZoneTime>& getResults() const { return m_results; }
+
+        // Statistics of the most recently resolved frame that collected them
+        bool getPipelineStatistics(GpuPipelineStatistics& statistics) const;
+
+        static constexpr uint32_t FRAME_LATENCY = 4;
+        static constexpr uint32_t MAX_ZONES_PER_FRAME = 256;
+        static constexpr uint32_t MAX_STATISTICS = 6;
+
+    private:
+        struct Zone
+        {
+            std::string name;
+            uint32_t depth;
+            uint32_t beginQuery;
+            uint32_t endQuery;
+        };
+
+        struct FrameQueries
+        {
+            std::vector<GLuint> queries;  // Created on first use, reused every lap of the ring
+            std::vector<Zone> zones;
+            uint32_t queryCount = 0;
+
+            GLuint statisticsQueries[MAX_STATISTICS] = {};
+            bool statisticsActive = false;  // The frame counted statistics
+        };
+
+        GLuint acquireQuery(FrameQueries& frame, uint32_t& index);
+        void resolve(FrameQueries& frame);
+        void resolveStatistics(FrameQueries& frame);
+
+        FrameQueries m_frames[FRAME_LATENCY];
+        uint32_t m_currentFrame;
+        std::vector<uint32_t> m_openZones;  // Indices into the current frame's zones
+        std::vector<GpuZoneTime> m_results;
+        bool m_overflowWarned;
+
+        // Query targets counted per frame, and the counter each one fills in
+        GLenum m_statisticsTargets[MAX_STATISTICS];
+        uint64_t GpuPipelineStatistics::* m_statisticsCounters[MAX_STATISTICS];
+        uint32_t m_statisticsCount;
+        GpuPipelineStatistics m_statistics;
+        bool m_statisticsValid;
+    };
+}
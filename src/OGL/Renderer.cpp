@@ -3,9 +3,22 @@
 #include "VertexArray.h"
 #include "IndexBuffer.h"
 #include "Texture.h"
+#include "StorageBuffer.h"
+#include "ComputeProgram.h"
 #include "../Logger.h"
 #include <GLFW/glfw3.h>
 
+// ARB_shader_image_load_store barrier bits, not part of the GL 3.3 headers
+#ifndef GL_SHADER_STORAGE_BARRIER_BIT
+#define GL_SHADER_STORAGE_BARRIER_BIT 0x00002000
+#endif
+#ifndef GL_COMMAND_BARRIER_BIT
+#define GL_COMMAND_BARRIER_BIT 0x00000040
+#endif
+#ifndef GL_ALL_BARRIER_BITS
+#define GL_ALL_BARRIER_BITS 0xFFFFFFFF
+#endif
+
 namespace OGL
 {
 
@@ -16,6 +29,11 @@ Renderer::Renderer()
     , m_cullingEnabled(false)
     , m_viewportWidth(800)
     , m_viewportHeight(600)
+    , m_passBegun(false)
+    , m_passZoneDepth(0)
+    , m_framePassCount(0)
+    , m_pipelineStatisticsEnabled(false)
+    , m_computeSupported(false)
 {
     // Clear color should be set by Application class via setClearColor()
 }
@@ -28,6 +46,8 @@ Renderer::~Renderer()
 void Renderer::initialize()
 {
     enableDepthTest(true);
+    m_gpuProfiler = std::make_unique<GpuProfiler>();
+    m_computeSupported = ComputeProgram::loadFunctions();
     LOG_INFO("OpenGL Renderer initialized");
 }
 
@@ -48,6 +68,8 @@ void Renderer::initialize(GLFWwindow* window)
 
 void Renderer::shutdown()
 {
+    // Query objects must be deleted while the context is current
+    m_gpuProfiler.reset();
 }
 
 void Renderer::setClearColor(float r, float g, float b, float a)
@@ -155,6 +177,99 @@ GLenum toGLPrimitiveType(PrimitiveType type)
     }
 }
 
+void Renderer::beginFrame()
+{
+    // OpenGL records commands implicitly - nothing to prepare
+    m_framePassCount = 0;
+
+    if (m_gpuProfiler)
+    {
+        m_gpuProfiler->beginFrame(m_pipelineStatisticsEnabled);
+        m_gpuProfiler->beginZone("Frame");
+    }
+}
+
+void Renderer::beginPass()
+{
+    // Default framebuffer is always bound, clearing is done through clear()
+    if (m_gpuProfiler)
+    {
+        m_passZoneDepth = m_gpuProfiler->getOpenZoneCount();
+        m_gpuProfiler->beginZone("Pass " + std::to_string(m_framePassCount));
+    }
+    m_framePassCount++;
+    m_passBegun = true;
+}
+
+void Renderer::endPass()
+{
+    // Zones left open in the pass end with it
+    if (m_gpuProfiler && m_passBegun)
+    {
+        while (m_gpuProfiler->getOpenZoneCount() > m_passZoneDepth)
+        {
+            m_gpuProfiler->endZone();
+        }
+    }
+    m_passBegun = false;
+}
+
+void Renderer::endFrame()
+{
+    // Presentation is handled by WindowManager::swapBuffers()
+    if (m_gpuProfiler)
+    {
+        m_gpuProfiler->endFrame();
+    }
+}
+
+void Renderer::beginGpuZone(const char* name)
+{
+    if (m_gpuProfiler)
+    {
+        m_gpuProfiler->beginZone(name);
+    }
+}
+
+void Renderer::endGpuZone()
+{
+    if (!m_gpuProfiler)
+    {
+        return;
+    }
+
+    // The frame zone and the pass zone are closed by the renderer
+    size_t rendererZones = m_passBegun ? m_passZoneDepth + 1 : 1;
+    if (m_gpuProfiler->getOpenZoneCount() <= rendererZones)
+    {
+        LOG_WARNING("endGpuZone() without a matching beginGpuZone() in the same pass");
+        return;
+    }
+
+    m_gpuProfiler->endZone();
+}
+
+void Renderer::setPipelineStatisticsEnabled(bool enable)
+{
+    m_pipelineStatisticsEnabled = enable;
+}
+
+bool Renderer::getPipelineStatistics(GpuPipelineStatistics& statistics) const
+{
+    return m_gpuProfiler && m_gpuProfiler->getPipelineStatistics(statistics);
+}
+
+void Renderer::getGpuZoneTimes(std::vector<GpuZoneTime>& zones) const
+{
+    if (!m_gpuProfiler)
+    {
+        zones.clear();
+        return;
+    }
+
+    zones = m_gpuProfiler->getResults();
+}
+
 void Renderer::drawArrays(PrimitiveType mode, int first, int count)
 {
     glDrawArrays(toGLPrimitiveType(mode), first, count);
@@ -165,6 +280,17 @@ void Renderer::drawElements(PrimitiveType mode, int count, unsigned int indexTyp
     glDrawElements(toGLPrimitiveType(mode), count, indexType, indices);
 }
 
+void Renderer::drawArraysInstanced(PrimitiveType mode, int first, int count, int instanceCount)
+{
+    glDrawArraysInstanced(toGLPrimitiveType(mode), first, count, instanceCount);
+}
+
+void Renderer::drawElementsInstanced(PrimitiveType mode, int count, unsigned int indexType, const void* indices,
+                                     int instanceCount)
+{
+    glDrawElementsInstanced(toGLPrimitiveType(mode), count, indexType, indices, instanceCount);
+}
+
 void Renderer::checkError(const char* location)
 {
     GLenum error = glGetError();
@@ -196,6 +322,58 @@ void Renderer::checkError(const char* location)
     }
 }
 
+void Renderer::dispatch(IComputeProgram* program, unsigned int groupsX, unsigned int groupsY, unsigned int groupsZ)
+{
+    if (!m_computeSupported || !program || !program->isValid())
+    {
+        return;
+    }
+
+    static_cast<ComputeProgram*>(program)->dispatch(groupsX, groupsY, groupsZ);
+}
+
+void Renderer::dispatchIndirect(IComputeProgram* program, IStorageBuffer* arguments, size_t offset)
+{
+    if (!m_computeSupported || !program || !program->isValid() || !arguments)
+    {
+        return;
+    }
+
+    if (offset % 4 != 0 || offset + 3 * sizeof(GLuint) > arguments->getSize())
+    {
+        LOG_ERROR("Indirect dispatch arguments at offset {} are misaligned or past the buffer's end", offset);
+        return;
+    }
+
+    static_cast<ComputeProgram*>(program)->dispatchIndirect(*static_cast<StorageBuffer*>(arguments), offset);
+}
+
+void Renderer::memoryBarrier(BarrierFlags flags)
+{
+    if (!m_computeSupported)
+    {
+        return;
+    }
+
+    GLbitfield barriers = 0;
+    if (flags == BarrierFlags::All)
+    {
+        barriers = GL_ALL_BARRIER_BITS;
+    }
+    else
+    {
+        if (hasBarrierFlag(flags, BarrierFlags::StorageBuffer))
+        {
+            barriers |= GL_SHADER_STORAGE_BARRIER_BIT;
+        }
+        if (hasBarrierFlag(flags, BarrierFlags::IndirectCommand))
+        {
+            barriers |= GL_COMMAND_BARRIER_BIT;
+        }
+    }
+    ComputeProgram::memoryBarrier(barriers);
+}
+
 std::unique_ptr<IVertexBuffer> Renderer::createVertexBuffer()
 {
     return std::make_unique<OGL::VertexBuffer>();
@@ -216,4 +394,9 @@ std::unique_ptr<ITexture> Renderer::createTexture()
     return std::make_unique<OGL::Texture>();
 }
 
+std::unique_ptr<IStorageBuffer> Renderer::createStorageBuffer()
+{
+    return std::make_unique<OGL::StorageBuffer>();
+}
+
 } // namespace OGL
@@ -4,6 +4,7 @@
 #include "../RenderAPI/IVertexBuffer.h"
 #include "../RenderAPI/IVertexArray.h"
 #include "../RenderAPI/IIndexBuffer.h"
+#include "GpuProfiler.h"
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <memory>
@@ -36,13 +37,34 @@ namespace OGL
         void getRenderDimensions(int& width, int& height) const override;
         void onShaderLoaded(const std::string& shaderName) override {} // OpenGL doesn't need pipeline creation
 
+        void beginFrame() override;
+        void beginPass() override;
+        void endPass() override;
+        void endFrame() override;
+
         void drawArrays(PrimitiveType mode, int first, int count) override;
         void drawElements(PrimitiveType mode, int count, unsigned int indexType, const void* indices) override;
+        void drawArraysInstanced(PrimitiveType mode, int first, int count, int instanceCount) override;
+        void drawElementsInstanced(PrimitiveType mode, int count, unsigned int indexType, const void* indices,
+                                   int instanceCount) override;
+
+        void beginGpuZone(const char* name) override;
+        void endGpuZone() override;
+        void getGpuZoneTimes(std::vector<GpuZoneTime>& zones) const override;
+        void setPipelineStatisticsEnabled(bool enable) override;
+        bool getPipelineStatistics(GpuPipelineStatistics& statistics) const override;
+
+        bool isComputeSupported() const override { return m_computeSupported; }
+        void dispatch(IComputeProgram* program, unsigned int groupsX, unsigned int groupsY = 1,
+                      unsigned int groupsZ = 1) override;
+        void dispatchIndirect(IComputeProgram* program, IStorageBuffer* arguments, size_t offset = 0) override;
+        void memoryBarrier(BarrierFlags flags) override;
 
         std::unique_ptr<IVertexBuffer> createVertexBuffer() override;
         std::unique_ptr<IVertexArray> createVertexArray() override;
         std::unique_ptr<IIndexBuffer> createIndexBuffer() override;
         std::unique_ptr<ITexture> createTexture() override;
+        std::unique_ptr<IStorageBuffer> createStorageBuffer() override;
 
         static void checkError(const char* location);
 
@@ -53,5 +75,14 @@ namespace OGL
         bool m_cullingEnabled;
         int m_viewportWidth;
         int m_viewportHeight;
+
+        // GPU timestamps, the frame and each pass are timed as zones
+        std::unique_ptr<GpuProfiler> m_gpuProfiler;
+        bool m_passBegun;
+        size_t m_passZoneDepth;  // Open zones before the pass zone
+        uint32_t m_framePassCount;
+        bool m_pipelineStatisticsEnabled;
+
+        bool m_computeSupported;  // GL 4.3, or the compute and storage buffer extensions
     };
 }
@@ -1,10 +1,16 @@
 #include "ShaderManager.h"
 #include "ShaderProgram.h"
+#include "ComputeProgram.h"
 #include "../Logger.h"
 #include <glm/gtc/type_ptr.hpp>
 #include <fstream>
 #include <sstream>
 
+// ARB_compute_shader, not part of the GL 3.3 headers
+#ifndef GL_COMPUTE_SHADER
+#define GL_COMPUTE_SHADER 0x91B9
+#endif
+
 namespace OGL
 {
 
@@ -60,10 +66,66 @@ IShaderProgram* ShaderManager::getShader(const std::string& name)
     return nullptr;
 }
 
+IComputeProgram* ShaderManager::createComputeProgram(
+    const std::string& name,
+    const std::string& computePath)
+{
+    if (!ComputeProgram::isSupported())
+    {
+        LOG_ERROR("Compute program '{}' not created, compute shaders are not supported", name);
+        return nullptr;
+    }
+
+    std::string computeSource = readFile(m_shaderBasePath + computePath);
+    if (computeSource.empty())
+    {
+        LOG_ERROR("Failed to read compute shader file: '{}'", computePath);
+        return nullptr;
+    }
+
+    GLShader computeShader = compileShader(GL_COMPUTE_SHADER, computeSource);
+    if (!computeShader.isValid())
+    {
+        LOG_ERROR("Failed to compile compute shader for: '{}'", name);
+        return nullptr;
+    }
+
+    GLuint programId = glCreateProgram();
+    glAttachShader(programId, computeShader.get());
+    glLinkProgram(programId);
+
+    if (!checkLinkErrors(programId))
+    {
+        glDeleteProgram(programId);
+        LOG_ERROR("Failed to link compute program for: '{}'", name);
+        return nullptr;
+    }
+
+    if (m_computePrograms.find(name) != m_computePrograms.end())
+    {
+        LOG_WARNING("Replacing existing compute program: '{}'", name);
+    }
+
+    m_computePrograms[name] = std::make_unique<ComputeProgram>(name, GLShaderProgram(programId));
+    LOG_INFO("Compute program '{}' loaded successfully (Program ID: {})", name, programId);
+    return m_computePrograms[name].get();
+}
+
+IComputeProgram* ShaderManager::getComputeProgram(const std::string& name)
+{
+    auto it = m_computePrograms.find(name);
+    if (it != m_computePrograms.end())
+    {
+        return it->second.get();
+    }
+    return nullptr;
+}
+
 void ShaderManager::cleanup()
 {
     // Shader programs are automatically deleted by unique_ptr destructors
     m_shaders.clear();
+    m_computePrograms.clear();
 }
 
 bool ShaderManager::loadShader(const std::string& name, const std::string& vertexSource, const std::string& fragmentSource)
@@ -112,7 +174,8 @@ GLShader ShaderManager::compileShader(GLenum type, const std::string& source)
     glShaderSource(shaderId, 1, &src, nullptr);
     glCompileShader(shaderId);
 
-    if (!checkCompileErrors(shaderId, type == GL_VERTEX_SHADER ? "VERTEX" : "FRAGMENT"))
+    const char* stage = type == GL_VERTEX_SHADER ? "VERTEX" : type == GL_COMPUTE_SHADER ? "COMPUTE" : "FRAGMENT";
+    if (!checkCompileErrors(shaderId, stage))
     {
         glDeleteShader(shaderId);
         return GLShader(); // Return invalid shader
@@ -11,6 +11,7 @@
 namespace OGL
 {
     class ShaderProgram;  // Forward declaration
+    class ComputeProgram;
 
     class ShaderManager : public IShaderManager
     {
@@ -26,6 +27,12 @@ namespace OGL
 
         IShaderProgram* getShader(const std::string& name) override;
 
+        IComputeProgram* createComputeProgram(
+            const std::string& name,
+            const std::string& computePath) override;
+
+        IComputeProgram* getComputeProgram(const std::string& name) override;
+
         void cleanup() override;
 
     private:
@@ -41,6 +48,7 @@ namespace OGL
 
         // Storage for shader programs (ShaderManager owns them)
         std::unordered_map<std::string, std::unique_ptr<ShaderProgram>> m_shaders;
+        std::unordered_map<std::string, std::unique_ptr<ComputeProgram>> m_computePrograms;
         std::string m_shaderBasePath;
     };
 } // namespace OGL
@@ -0,0 +1,60 @@
+#include "StorageBuffer.h"
+#include "../Logger.h"
+#include <vector>
+
+namespace OGL
+{
+    StorageBuffer::StorageBuffer()
+        : m_bufferID(0)
+        , m_size(0)
+    {
+        glGenBuffers(1, &m_bufferID);
+    }
+
+    StorageBuffer::~StorageBuffer()
+    {
+        if (m_bufferID != 0)
+        {
+            glDeleteBuffers(1, &m_bufferID);
+            m_bufferID = 0;
+        }
+    }
+
+    void StorageBuffer::setData(const void* data, size_t size, ::BufferUsage usage)
+    {
+        GLenum glUsage;
+        switch (usage)
+        {
+            case ::BufferUsage::Static:  glUsage = GL_STATIC_DRAW; break;
+            case ::BufferUsage::Dynamic: glUsage = GL_DYNAMIC_DRAW; break;
+            case ::BufferUsage::Stream:  glUsage = GL_STREAM_DRAW; break;
+            default: glUsage = GL_STATIC_DRAW; break;
+        }
+
+        // glClearBufferData is GL 4.3, zeroes are uploaded instead
+        std::vector<char> zeroes;
+        if (!data)
+        {
+            zeroes.resize(size, 0);
+            data = zeroes.data();
+        }
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_bufferID);
+        glBufferData(GL_COPY_WRITE_BUFFER, size, data, glUsage);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        m_size = size;
+    }
+
+    void StorageBuffer::updateData(const void* data, size_t size, size_t offset)
+    {
+        if (offset + size > m_size)
+        {
+            LOG_ERROR("Storage buffer update of {} bytes at offset {} exceeds its size of {} bytes", size, offset, m_size);
+            return;
+        }
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_bufferID);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "../RenderAPI/IStorageBuffer.h"
+#include <glad/glad.h>
+
+namespace OGL
+{
+    // GL_SHADER_STORAGE_BUFFER object, bound to its block by ComputeProgram at dispatch
+    // Data is uploaded through GL_COPY_WRITE_BUFFER so the vertex buffer binding is left alone.
+    class StorageBuffer : public IStorageBuffer
+    {
+    public:
+        StorageBuffer();
+        ~StorageBuffer() override;
+
+        StorageBuffer(const StorageBuffer&) = delete;
+        StorageBuffer& operator=(const StorageBuffer&) = delete;
+
+        void setData(const void* data, size_t size, ::BufferUsage usage) override;
+        void updateData(const void* data, size_t size, size_t offset = 0) override;
+
+        size_t getSize() const override { return m_size; }
+
+        GLuint getID() const { return m_bufferID; }
+
+    private:
+        GLuint m_bufferID;
+        size_t m_size;
+    };
+}
@@ -57,6 +57,9 @@ namespace OGL
             case ::DataType::UnsignedInt: oglType = OGL::DataType::UnsignedInt; break;
             case ::DataType::Byte: oglType = OGL::DataType::Byte; break;
             case ::DataType::UnsignedByte: oglType = OGL::DataType::UnsignedByte; break;
+            case ::DataType::Short: oglType = OGL::DataType::Short; break;
+            case ::DataType::UnsignedShort: oglType = OGL::DataType::UnsignedShort; break;
+            case ::DataType::HalfFloat: oglType = OGL::DataType::HalfFloat; break;
         }
 
         OGL::VertexAttribute oglAttr(
@@ -65,7 +68,8 @@ namespace OGL
             oglType,
             attribute.normalized ? GL_TRUE : GL_FALSE,
             static_cast<GLsizei>(attribute.stride),
-            attribute.offset
+            attribute.offset,
+            attribute.divisor
         );
 
         addAttribute(oglAttr);
@@ -82,6 +86,7 @@ namespace OGL
             attribute.stride,
             attribute.offset
         );
+        glVertexAttribDivisor(attribute.index, attribute.divisor);
         enableAttribute(attribute.index);
     }
 
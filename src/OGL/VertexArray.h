@@ -12,7 +12,10 @@ namespace OGL
         Int = GL_INT,
         UnsignedInt = GL_UNSIGNED_INT,
         Byte = GL_BYTE,
-        UnsignedByte = GL_UNSIGNED_BYTE
+        UnsignedByte = GL_UNSIGNED_BYTE,
+        Short = GL_SHORT,
+        UnsignedShort = GL_UNSIGNED_SHORT,
+        HalfFloat = GL_HALF_FLOAT
     };
 
     struct VertexAttribute
@@ -23,9 +26,11 @@ namespace OGL
         GLboolean normalized;
         GLsizei stride;
         const void* offset;
+        GLuint divisor;
 
-        VertexAttribute(GLuint idx, GLint sz, DataType t, GLboolean norm, GLsizei str, const void* off)
-            : index(idx), size(sz), type(t), normalized(norm), stride(str), offset(off) {}
+        VertexAttribute(GLuint idx, GLint sz, DataType t, GLboolean norm, GLsizei str, const void* off,
+                        GLuint div = 0)
+            : index(idx), size(sz), type(t), normalized(norm), stride(str), offset(off), divisor(div) {}
     };
 
     class VertexArray : public IVertexArray
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <string>
+
+class IStorageBuffer;
+
+/**
+ * Abstract interface for compute programs
+ * Created by IShaderManager::createComputeProgram() and run with IRenderer::dispatch()
+ * Storage blocks are declared std430 with layout(binding = N), in set 0 for Vulkan.
+ * Uniforms are push constants in Vulkan and plain uniforms in OpenGL.
+ */
+class IComputeProgram
+{
+public:
+    virtual ~IComputeProgram() = default;
+
+    /**
+     * Attach a buffer to the storage block at binding, read by the following dispatches
+     * The buffer must outlive its use by the GPU, null detaches it
+     */
+    virtual void setStorageBuffer(unsigned int binding, IStorageBuffer* buffer) = 0;
+
+    // Uniform setters
+    virtual void setInt(const std::string& name, int value) = 0;
+    virtual void setUInt(const std::string& name, unsigned int value) = 0;
+    virtual void setFloat(const std::string& name, float value) = 0;
+    virtual void setVec2(const std::string& name, const glm::vec2& value) = 0;
+    virtual void setVec3(const std::string& name, const glm::vec3& value) = 0;
+    virtual void setVec4(const std::string& name, const glm::vec4& value) = 0;
+    virtual void setMat4(const std::string& name, const glm::mat4& value) = 0;
+
+    /**
+     * Check if the compute program is valid and can be dispatched
+     */
+    virtual bool isValid() const = 0;
+
+    /**
+     * Get the name of this compute program
+     */
+    virtual const std::string& getName() const = 0;
+};
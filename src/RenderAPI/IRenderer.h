@@ -4,19 +4,93 @@
 #include <glm/glm.hpp>
 #include <memory>
 #include <cstddef>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 struct GLFWwindow;
 class IVertexBuffer;
 class IVertexArray;
 class IIndexBuffer;
 class ITexture;
+class IStorageBuffer;
+class IComputeProgram;
 
 // Forward declare OpenGL types to avoid including glad.h
 typedef unsigned int GLenum;
 typedef int GLint;
 typedef int GLsizei;
 
+// GPU time of a zone in a completed frame
+struct GpuZoneTime
+{
+    std::string name;
+    unsigned int depth;  // Nesting level, the frame zone is 0 and its passes are 1
+    double milliseconds;
+};
+
+// Work counted by the GPU over a completed frame
+// Counters the backend can't measure are left UNAVAILABLE
+struct GpuPipelineStatistics
+{
+    static constexpr uint64_t UNAVAILABLE = UINT64_MAX;
+
+    uint64_t inputVertices = UNAVAILABLE;
+    uint64_t inputPrimitives = UNAVAILABLE;
+    uint64_t vertexShaderInvocations = UNAVAILABLE;
+    uint64_t clippingInvocations = UNAVAILABLE;  // Primitives entering clipping
+    uint64_t clippingPrimitives = UNAVAILABLE;   // Primitives leaving clipping
+    uint64_t fragmentShaderInvocations = UNAVAILABLE;
+};
+
+// Presentation policy of the swapchain
+// Fifo waits for vertical blank and never tears, FifoRelaxed tears when a frame is late,
+// Mailbox replaces the queued image with a newer one, Immediate presents without waiting
+enum class PresentMode
+{
+    Fifo,
+    FifoRelaxed,
+    Mailbox,
+    Immediate
+};
+
+// CPU-side timing of the most recently presented frame
+struct FramePresentTiming
+{
+    double limiterMilliseconds = 0.0;          // Waited by the frame limiter
+    double acquireMilliseconds = 0.0;          // Blocked acquiring the swapchain image
+    double acquireToPresentMilliseconds = 0.0; // From the acquired image to the present call returning
+};
+
+// Object drawn by the GPU-driven path, its indices are a range of the bound index buffer
+struct GpuDrivenObject
+{
+    glm::mat4 model = glm::mat4(1.0f);
+    glm::vec3 boundsCenter = glm::vec3(0.0f);  // Bounding sphere in object space
+    float boundsRadius = 0.0f;
+    unsigned int indexCount = 0;
+    unsigned int firstIndex = 0;
+    int vertexOffset = 0;
+};
+
+// Writes of earlier dispatches that a memoryBarrier() makes visible to later commands
+enum class BarrierFlags : unsigned int
+{
+    StorageBuffer = 1u << 0,    // Storage buffer reads and writes of later dispatches
+    IndirectCommand = 1u << 1,  // Work group counts read by later dispatchIndirect() calls
+    All = ~0u
+};
+
+inline BarrierFlags operator|(BarrierFlags a, BarrierFlags b)
+{
+    return static_cast<BarrierFlags>(static_cast<unsigned int>(a) | static_cast<unsigned int>(b));
+}
+
+inline bool hasBarrierFlag(BarrierFlags flags, BarrierFlags flag)
+{
+    return (static_cast<unsigned int>(flags) & static_cast<unsigned int>(flag)) != 0;
+}
+
 class IRenderer
 {
 public:
@@ -41,12 +115,94 @@ public:
     // Notify renderer that a shader was loaded (for pipeline creation in Vulkan)
     virtual void onShaderLoaded(const std::string& shaderName) {}
 
+    // Frame and pass boundaries
+    // All draws issued between beginPass() and endPass() are recorded into the
+    // frame's command stream; endFrame() submits and presents it once.
+    virtual void beginFrame() = 0;
+    virtual void beginPass() = 0;
+    virtual void endPass() = 0;
+    virtual void endFrame() = 0;
+
     virtual void drawArrays(PrimitiveType mode, int first, int count) = 0;
     virtual void drawElements(PrimitiveType mode, int count, unsigned int indexType, const void* indices) = 0;
 
+    // Draw instanceCount copies in one call, per-instance attributes (divisor > 0)
+    // and gl_InstanceID / gl_InstanceIndex tell the instances apart
+    virtual void drawArraysInstanced(PrimitiveType mode, int first, int count, int instanceCount) = 0;
+    virtual void drawElementsInstanced(PrimitiveType mode, int count, unsigned int indexType, const void* indices,
+                                       int instanceCount) = 0;
+
+    // Number of worker threads used to record a pass's draws (0 or 1 records on the calling thread)
+    // Backends without explicit command buffers ignore this
+    virtual void setRecordingThreadCount(unsigned int threadCount) {}
+
+    // Number of frames the CPU may record ahead of the GPU (lower = less latency)
+    virtual void setFramesInFlight(unsigned int count) {}
+
+    // Presentation mode and number of swapchain images (0 lets the backend choose), applied
+    // by recreating the swapchain. Modes the surface doesn't offer fall back to Fifo.
+    // Backends without a swapchain ignore this
+    virtual void setPresentMode(PresentMode mode) {}
+    virtual void setSwapchainImageCount(unsigned int count) {}
+
+    // CPU frame limiter, beginFrame() waits so frames start at most this often (0 = unlimited)
+    // Backends presenting through the window's own swap ignore this
+    virtual void setFrameRateLimit(double framesPerSecond) {}
+
+    // Returns false until a frame has been presented
+    virtual bool getFramePresentTiming(FramePresentTiming& timing) const { return false; }
+
+    // Group resource uploads (texture and buffer setData) issued in between into a
+    // single submission. Submit the batch before the frame that uses the resources.
+    virtual void beginUploadBatch() {}
+    virtual void submitUploadBatch() {}
+
+    // Select textures by index from one large descriptor array instead of binding
+    // a descriptor set per texture. Shaders must read the texture index pushed by the backend.
+    // Backends without descriptor indexing ignore this
+    virtual void setBindlessTextures(bool enable) {}
+
+    // GPU timing of the commands issued between beginGpuZone() and endGpuZone()
+    // Zones may nest but must not cross a pass boundary. Every frame and pass is timed as
+    // a zone of its own. Results are read without stalling once the GPU has finished a frame,
+    // so getGpuZoneTimes() returns the zones of a frame one or more frames back, in begin order.
+    // Backends without timer queries return no zones
+    virtual void beginGpuZone(const char* name) {}
+    virtual void endGpuZone() {}
+    virtual void getGpuZoneTimes(std::vector<GpuZoneTime>& zones) const { zones.clear(); }
+
+    // Count each frame's work with pipeline statistics queries, off by default since the
+    // queries aren't free. Results arrive with the same latency as the GPU zones,
+    // getPipelineStatistics() returns false until a frame with statistics has been read
+    virtual void setPipelineStatisticsEnabled(bool enable) {}
+    virtual bool getPipelineStatistics(GpuPipelineStatistics& statistics) const { return false; }
+
+    // GPU-driven drawing: objects are kept on the GPU, culled against the view frustum
+    // by a compute pass and drawn with one indirect call, so the CPU cost doesn't grow
+    // with the object count. All objects share the bound vertex array, the vertex shader
+    // reads the model matrix of its object by instance index (shaders/vulkan/indirect.vert).
+    // Cull between beginFrame() and beginPass(), then draw inside the pass with the shader
+    // bound. Backends without support return false and ignore the other calls.
+    virtual bool isGpuDrivenRenderingSupported() const { return false; }
+    virtual void setGpuDrivenObjects(const std::vector<GpuDrivenObject>& objects) {}
+    virtual void updateGpuDrivenObject(unsigned int index, const glm::mat4& model) {}
+    virtual void cullGpuDrivenObjects(const glm::mat4& viewProjection) {}
+    virtual void drawGpuDrivenObjects(PrimitiveType mode) {}
+
+    // Compute dispatches run outside passes, between beginFrame() and endFrame() in Vulkan
+    // Dispatches aren't ordered against each other, a memoryBarrier() between a writer
+    // and its readers is required. Backends without compute support ignore them.
+    virtual bool isComputeSupported() const { return false; }
+    virtual void dispatch(IComputeProgram* program, unsigned int groupsX, unsigned int groupsY = 1,
+                          unsigned int groupsZ = 1) {}
+    // Work group counts are three uints at offset in arguments
+    virtual void dispatchIndirect(IComputeProgram* program, IStorageBuffer* arguments, size_t offset = 0) {}
+    virtual void memoryBarrier(BarrierFlags flags) {}
+
     // Factory methods for creating renderer-specific objects
     virtual std::unique_ptr<IVertexBuffer> createVertexBuffer() = 0;
     virtual std::unique_ptr<IVertexArray> createVertexArray() = 0;
     virtual std::unique_ptr<IIndexBuffer> createIndexBuffer() = 0;
     virtual std::unique_ptr<ITexture> createTexture() = 0;
+    virtual std::unique_ptr<IStorageBuffer> createStorageBuffer() = 0;
 };
@@ -4,6 +4,7 @@
 #include <string>
 
 class IShaderProgram;  // Forward declaration
+class IComputeProgram;
 
 /**
  * Shader Manager Interface
@@ -35,6 +36,24 @@ public:
      */
     virtual IShaderProgram* getShader(const std::string& name) = 0;
 
+    /**
+     * Create and load a compute program from a compute shader file
+     * Returns a non-owning pointer to the compute program (ShaderManager retains ownership)
+     * @param name Unique name for this compute program
+     * @param computePath Path to compute shader file (relative to shader base path)
+     * @return Non-owning pointer to compute program, or nullptr on failure or without compute support
+     */
+    virtual IComputeProgram* createComputeProgram(
+        const std::string& name,
+        const std::string& computePath) = 0;
+
+    /**
+     * Get an existing compute program by name
+     * @param name Name of the compute program to retrieve
+     * @return Non-owning pointer to compute program, or nullptr if not found
+     */
+    virtual IComputeProgram* getComputeProgram(const std::string& name) = 0;
+
     /**
      * Clean up all shader resources
      */
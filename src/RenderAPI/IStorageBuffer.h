@@ -0,0 +1,18 @@
+#pragma once
+
+#include "IVertexBuffer.h"
+#include <cstddef>
+
+// Buffer read and written by compute programs, attached with IComputeProgram::setStorageBuffer()
+// Also holds the work group counts read by IRenderer::dispatchIndirect().
+class IStorageBuffer
+{
+public:
+    virtual ~IStorageBuffer() = default;
+
+    // Contents are zeroed when data is null
+    virtual void setData(const void* data, size_t size, BufferUsage usage) = 0;
+    virtual void updateData(const void* data, size_t size, size_t offset = 0) = 0;
+
+    virtual size_t getSize() const = 0;
+};
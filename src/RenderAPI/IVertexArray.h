@@ -8,7 +8,10 @@ enum class DataType
     Int,
     UnsignedInt,
     Byte,
-    UnsignedByte
+    UnsignedByte,
+    Short,
+    UnsignedShort,
+    HalfFloat
 };
 
 struct VertexAttribute
@@ -19,9 +22,13 @@ struct VertexAttribute
     bool normalized;
     size_t stride;
     const void* offset;
+    // 0 advances per vertex, N advances once every N instances. Vulkan supports 0 and 1
+    // only (no VK_EXT_vertex_attribute_divisor), larger divisors advance every instance there.
+    unsigned int divisor;
 
-    VertexAttribute(unsigned int idx, int sz, DataType t, bool norm, size_t str, const void* off)
-        : index(idx), size(sz), type(t), normalized(norm), stride(str), offset(off)
+    VertexAttribute(unsigned int idx, int sz, DataType t, bool norm, size_t str, const void* off,
+                    unsigned int div = 0)
+        : index(idx), size(sz), type(t), normalized(norm), stride(str), offset(off), divisor(div)
     {
     }
 };
@@ -33,5 +40,7 @@ public:
 
     virtual void bind() = 0;
     virtual void unbind() = 0;
+    // Like glVertexAttribPointer, the attribute reads from the vertex buffer bound when it
+    // is added. Adding an attribute at a location already in use replaces it.
     virtual void addAttribute(const VertexAttribute& attribute) = 0;
 };
@@ -137,6 +137,29 @@ void RenderMesh::drawSubset(size_t indexCount, size_t indexOffset) const {
     );
 }
 
+void RenderMesh::drawInstanced(IVertexBuffer& instanceBuffer, size_t instanceCount) const {
+    if (instanceCount == 0) {
+        return;
+    }
+
+    vertexArray_->bind();
+
+    // The attributes capture the buffer bound when they're set up
+    if (&instanceBuffer != instanceBuffer_) {
+        instanceBuffer.bind();
+        setupInstanceAttributes();
+        instanceBuffer_ = &instanceBuffer;
+    }
+
+    renderer_->drawElementsInstanced(
+        primitiveType_,
+        static_cast<int>(indexCount_),
+        0,  // Index type from IIndexBuffer
+        nullptr,
+        static_cast<int>(instanceCount)
+    );
+}
+
 // ============================================================================
 // Update Interface
 // ============================================================================
@@ -365,6 +388,23 @@ void RenderMesh::setupVertexAttributes(size_t stride) {
     }
 }
 
+void RenderMesh::setupInstanceAttributes() const {
+    const size_t stride = sizeof(float) * 16;
+
+    // One vec4 column per location, advancing once per instance (divisor 1)
+    for (unsigned int column = 0; column < 4; ++column) {
+        vertexArray_->addAttribute(VertexAttribute(
+            ATTRIB_INSTANCE_MODEL + column,
+            4,                  // size: 4 components per column
+            DataType::Float,
+            false,              // normalized: false
+            stride,
+            reinterpret_cast<const void*>(column * sizeof(float) * 4),
+            1                   // divisor: one matrix per instance
+        ));
+    }
+}
+
 void RenderMesh::validateMesh(const Mesh& mesh) const {
     // Check that mesh has required data
     if (mesh.getVertexCount() == 0) {
@@ -111,6 +111,19 @@ public:
      */
     void drawSubset(size_t indexCount, size_t indexOffset = 0) const;
 
+    /**
+     * @brief Renders many copies of the mesh with one instanced draw call.
+     *
+     * The instance buffer holds one glm::mat4 model matrix per instance, read
+     * as a per-instance attribute at locations 4-7 (ATTRIB_INSTANCE_MODEL).
+     * The attributes are only re-pointed when a different buffer is passed.
+     *
+     * @param instanceBuffer Buffer of at least instanceCount model matrices
+     * @param instanceCount Number of instances to draw
+     * @note Use a shader reading the per-instance matrix (shaders/<api>/instanced.vert)
+     */
+    void drawInstanced(IVertexBuffer& instanceBuffer, size_t instanceCount) const;
+
     // ========================================================================
     // Update Interface
     // ========================================================================
@@ -225,6 +238,14 @@ private:
      */
     void setupVertexAttributes(size_t stride);
 
+    /**
+     * @brief Sets up the per-instance model matrix attributes (locations 4-7).
+     *
+     * A mat4 attribute takes four locations, one per column. The attributes
+     * read from the vertex buffer bound when this is called.
+     */
+    void setupInstanceAttributes() const;
+
     /**
      * @brief Validates that mesh data is consistent and renderable.
      * @throws std::invalid_argument if validation fails
@@ -249,6 +270,9 @@ private:
     BufferUsage bufferUsage_;      // Usage hint for GPU buffers
     PrimitiveType primitiveType_;  // Rendering topology
 
+    // Instance buffer the per-instance attributes currently read from
+    mutable const IVertexBuffer* instanceBuffer_ = nullptr;
+
     // Vertex layout flags (determine what attributes are present)
     bool hasColors_;    // Whether mesh has per-vertex colors
     bool hasTexCoords_; // Whether mesh has texture coordinates
@@ -259,6 +283,7 @@ private:
     static constexpr unsigned int ATTRIB_COLOR     = 1;
     static constexpr unsigned int ATTRIB_TEXCOORD  = 2;
     static constexpr unsigned int ATTRIB_NORMAL    = 3;
+    static constexpr unsigned int ATTRIB_INSTANCE_MODEL = 4;  // Through 7
 };
 
 } // namespace Graphics
@@ -0,0 +1,193 @@
+#include "ComputeProgram.h"
+#include "Renderer.h"
+#include "StorageBuffer.h"
+#include "ShaderReflection.h"
+#include "../Logger.h"
+#include <algorithm>
+#include <cstring>
+
+namespace VK
+{
+
+ComputeProgram::ComputeProgram(const std::string& name,
+                               VkDevice device,
+                               VkShaderModule module,
+                               const ShaderReflection& reflection,
+                               Renderer* renderer)
+    : m_name(name)
+    , m_device(device)
+    , m_renderer(renderer)
+    , m_setLayout(VK_NULL_HANDLE)
+    , m_pipelineLayout(VK_NULL_HANDLE)
+    , m_pipeline(VK_NULL_HANDLE)
+    , m_pushConstantRange{}
+{
+    if (!createLayouts(reflection))
+    {
+        return;
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = module;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = m_pipelineLayout;
+
+    if (vkCreateComputePipelines(m_device, m_renderer->getPipelineCache(), 1, &pipelineInfo, nullptr,
+                                 &m_pipeline) != VK_SUCCESS)
+    {
+        LOG_ERROR("[Vulkan] Failed to create compute pipeline for '{}'", m_name);
+        m_pipeline = VK_NULL_HANDLE;
+    }
+}
+
+ComputeProgram::~ComputeProgram()
+{
+    // Dispatches recorded in frames still in flight use all three
+    m_renderer->deferDeletePipeline(m_pipeline);
+    m_renderer->deferDeletePipelineLayout(m_pipelineLayout);
+    m_renderer->deferDeleteDescriptorSetLayout(m_setLayout);
+}
+
+bool ComputeProgram::createLayouts(const ShaderReflection& reflection)
+{
+    if (!(reflection.stages & VK_SHADER_STAGE_COMPUTE_BIT))
+    {
+        LOG_ERROR("[Vulkan] Compute program '{}' is not a compute shader", m_name);
+        return false;
+    }
+
+    std::vector<VkDescriptorSetLayoutBinding> bindings;
+    for (const ReflectedBinding& reflected : reflection.bindings)
+    {
+        if (reflected.set != 0 || reflected.type != VK_DESCRIPTOR_TYPE_STORAGE_BUFFER || reflected.count != 1)
+        {
+            LOG_ERROR("[Vulkan] Compute program '{}': set {} binding {} must be a single storage block in set 0",
+                      m_name, reflected.set, reflected.binding);
+            return false;
+        }
+
+        VkDescriptorSetLayoutBinding binding{};
+        binding.binding = reflected.binding;
+        binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        binding.descriptorCount = 1;
+        binding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        bindings.push_back(binding);
+        m_storageBindings.push_back(reflected.binding);
+    }
+    std::sort(m_storageBindings.begin(), m_storageBindings.end());
+
+    if (!bindings.empty())
+    {
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+        layoutInfo.pBindings = bindings.data();
+
+        if (vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &m_setLayout) != VK_SUCCESS)
+        {
+            LOG_ERROR("[Vulkan] Failed to create descriptor set layout for compute program '{}'", m_name);
+            m_setLayout = VK_NULL_HANDLE;
+            return false;
+        }
+    }
+
+    m_pushConstantRange = reflection.pushConstantRange;
+    if (m_pushConstantRange.size > 0)
+    {
+        m_pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        m_pushConstantData.resize(m_pushConstantRange.offset + m_pushConstantRange.size, 0);
+        for (const auto& [memberName, member] : reflection.pushConstantMembers)
+        {
+            m_pushConstantMembers[memberName] = {member.offset, member.size};
+        }
+    }
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = m_setLayout != VK_NULL_HANDLE ? 1 : 0;
+    pipelineLayoutInfo.pSetLayouts = &m_setLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = m_pushConstantRange.size > 0 ? 1 : 0;
+    pipelineLayoutInfo.pPushConstantRanges = &m_pushConstantRange;
+
+    if (vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS)
+    {
+        LOG_ERROR("[Vulkan] Failed to create pipeline layout for compute program '{}'", m_name);
+        m_pipelineLayout = VK_NULL_HANDLE;
+        return false;
+    }
+
+    return true;
+}
+
+void ComputeProgram::setStorageBuffer(unsigned int binding, IStorageBuffer* buffer)
+{
+    if (std::find(m_storageBindings.begin(), m_storageBindings.end(), binding) == m_storageBindings.end())
+    {
+        LOG_WARNING("[Vulkan] Compute program '{}' has no storage block at binding {}", m_name, binding);
+        return;
+    }
+
+    m_storageBuffers[binding] = static_cast<StorageBuffer*>(buffer);
+}
+
+StorageBuffer* ComputeProgram::getStorageBuffer(uint32_t binding) const
+{
+    auto it = m_storageBuffers.find(binding);
+    return it != m_storageBuffers.end() ? it->second : nullptr;
+}
+
+void ComputeProgram::setInt(const std::string& name, int value)
+{
+    setPushConstant(name, &value, sizeof(value));
+}
+
+void ComputeProgram::setUInt(const std::string& name, unsigned int value)
+{
+    setPushConstant(name, &value, sizeof(value));
+}
+
+void ComputeProgram::setFloat(const std::string& name, float value)
+{
+    setPushConstant(name, &value, sizeof(value));
+}
+
+void ComputeProgram::setVec2(const std::string& name, const glm::vec2& value)
+{
+    setPushConstant(name, &value, sizeof(value));
+}
+
+void ComputeProgram::setVec3(const std::string& name, const glm::vec3& value)
+{
+    setPushConstant(name, &value, sizeof(value));
+}
+
+void ComputeProgram::setVec4(const std::string& name, const glm::vec4& value)
+{
+    setPushConstant(name, &value, sizeof(value));
+}
+
+void ComputeProgram::setMat4(const std::string& name, const glm::mat4& value)
+{
+    setPushConstant(name, &value, sizeof(value));
+}
+
+void ComputeProgram::setPushConstant(const std::string& name, const void* data, uint32_t size)
+{
+    // Values are pushed with each dispatch, so changing them never affects earlier ones
+    auto it = m_pushConstantMembers.find(name);
+    if (it == m_pushConstantMembers.end() || size > it->second.second)
+    {
+        if (m_warnedUniforms.insert(name).second)
+        {
+            LOG_WARNING("[Vulkan] Compute program '{}' has no uniform '{}' of this type", m_name, name);
+        }
+        return;
+    }
+
+    std::memcpy(m_pushConstantData.data() + it->second.first, data, size);
+}
+
+} // namespace VK
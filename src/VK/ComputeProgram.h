@@ -0,0 +1,94 @@
+#pragma once
+
+#include "../RenderAPI/IComputeProgram.h"
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+
+namespace VK
+{
+    class Renderer;  // Forward declaration
+    class StorageBuffer;
+    struct ShaderReflection;
+
+    /**
+     * Vulkan implementation of IComputeProgram
+     * Owns its compute pipeline and layouts. The descriptor set layout is built from the
+     * storage blocks the shader declares in set 0, uniforms are its push constant members.
+     * Renderer::dispatch() writes a transient set from the attached buffers per dispatch.
+     */
+    class ComputeProgram : public IComputeProgram
+    {
+    public:
+        /**
+         * Constructor
+         * @param name Compute program name
+         * @param device Vulkan device
+         * @param module Compute shader module, only used while the pipeline is created
+         * @param reflection Interface of the shader, bindings and uniform names are resolved from it
+         * @param renderer Pointer to renderer (for deferred deletion and the pipeline cache)
+         */
+        ComputeProgram(const std::string& name,
+                       VkDevice device,
+                       VkShaderModule module,
+                       const ShaderReflection& reflection,
+                       Renderer* renderer);
+
+        ~ComputeProgram() override;
+
+        // Delete copy constructor and assignment
+        ComputeProgram(const ComputeProgram&) = delete;
+        ComputeProgram& operator=(const ComputeProgram&) = delete;
+
+        // IComputeProgram interface
+        void setStorageBuffer(unsigned int binding, IStorageBuffer* buffer) override;
+
+        void setInt(const std::string& name, int value) override;
+        void setUInt(const std::string& name, unsigned int value) override;
+        void setFloat(const std::string& name, float value) override;
+        void setVec2(const std::string& name, const glm::vec2& value) override;
+        void setVec3(const std::string& name, const glm::vec3& value) override;
+        void setVec4(const std::string& name, const glm::vec4& value) override;
+        void setMat4(const std::string& name, const glm::mat4& value) override;
+
+        bool isValid() const override { return m_pipeline != VK_NULL_HANDLE; }
+        const std::string& getName() const override { return m_name; }
+
+        // Vulkan-specific accessors
+        VkPipeline getPipeline() const { return m_pipeline; }
+        VkPipelineLayout getPipelineLayout() const { return m_pipelineLayout; }
+        VkDescriptorSetLayout getDescriptorSetLayout() const { return m_setLayout; }  // Null without storage blocks
+
+        // Storage block bindings the shader declares, and the buffer attached to each
+        const std::vector<uint32_t>& getStorageBindings() const { return m_storageBindings; }
+        StorageBuffer* getStorageBuffer(uint32_t binding) const;
+
+        const VkPushConstantRange& getPushConstantRange() const { return m_pushConstantRange; }
+        const uint8_t* getPushConstantData() const { return m_pushConstantData.data() + m_pushConstantRange.offset; }
+
+    private:
+        bool createLayouts(const ShaderReflection& reflection);
+        void setPushConstant(const std::string& name, const void* data, uint32_t size);
+
+        std::string m_name;
+        VkDevice m_device;
+        Renderer* m_renderer;
+
+        VkDescriptorSetLayout m_setLayout;
+        VkPipelineLayout m_pipelineLayout;
+        VkPipeline m_pipeline;
+
+        std::vector<uint32_t> m_storageBindings;
+        std::unordered_map<uint32_t, StorageBuffer*> m_storageBuffers;
+
+        VkPushConstantRange m_pushConstantRange;
+        std::vector<uint8_t> m_pushConstantData;  // Starts at offset 0, only the range is pushed
+        std::unordered_map<std::string, std::pair<uint32_t, uint32_t>> m_pushConstantMembers;  // Offset and size
+        std::unordered_set<std::string> m_warnedUniforms;  // Unknown names are reported once
+    };
+
+} // namespace VK
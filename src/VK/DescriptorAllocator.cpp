@@ -0,0 +1,165 @@
+#include "DescriptorAllocator.h"
+#include "../Logger.h"
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+namespace VK
+{
+
+DescriptorAllocator::DescriptorAllocator(VkDevice device, uint32_t frameSlotCount)
+    : m_device(device)
+    , m_framePools(frameSlotCount)
+    , m_currentSlot(0)
+{
+}
+
+DescriptorAllocator::~DescriptorAllocator()
+{
+    // Sets are owned by their pools, destroying the pools releases everything
+    destroyChain(m_staticPools);
+    for (PoolChain& chain : m_framePools)
+    {
+        destroyChain(chain);
+    }
+}
+
+void DescriptorAllocator::beginFrame(uint32_t frameSlot, uint64_t completedFrameNumber)
+{
+    m_currentSlot = frameSlot;
+
+    // Reset every pool the slot used, keeping them for this frame's allocations
+    PoolChain& chain = m_framePools[frameSlot];
+    for (VkDescriptorPool pool : chain.fullPools)
+    {
+        chain.readyPools.push_back(pool);
+    }
+    chain.fullPools.clear();
+
+    for (VkDescriptorPool pool : chain.readyPools)
+    {
+        vkResetDescriptorPool(m_device, pool, 0);
+    }
+
+    // Static sets no frame in flight can reference any more may be rewritten
+    for (auto& [layout, retired] : m_retiredSets)
+    {
+        auto it = retired.begin();
+        while (it != retired.end() && it->frameNumber <= completedFrameNumber)
+        {
+            m_recycledSets[layout].push_back(it->set);
+            ++it;
+        }
+        retired.erase(retired.begin(), it);
+    }
+}
+
+VkDescriptorSet DescriptorAllocator::allocateStatic(VkDescriptorSetLayout layout)
+{
+    auto it = m_recycledSets.find(layout);
+    if (it != m_recycledSets.end() && !it->second.empty())
+    {
+        VkDescriptorSet set = it->second.back();
+        it->second.pop_back();
+        return set;
+    }
+
+    return allocate(m_staticPools, layout);
+}
+
+VkDescriptorSet DescriptorAllocator::allocateTransient(VkDescriptorSetLayout layout)
+{
+    return allocate(m_framePools[m_currentSlot], layout);
+}
+
+void DescriptorAllocator::freeStatic(VkDescriptorSetLayout layout, VkDescriptorSet set, uint64_t lastFrameNumber)
+{
+    if (set == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    // Frames are freed in increasing order, so each list stays sorted
+    m_retiredSets[layout].push_back(RetiredSet{set, lastFrameNumber});
+}
+
+VkDescriptorSet DescriptorAllocator::allocate(PoolChain& chain, VkDescriptorSetLayout layout)
+{
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = acquirePool(chain);
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &layout;
+
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    VkResult result = vkAllocateDescriptorSets(m_device, &allocInfo, &set);
+
+    if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL)
+    {
+        // Pool exhausted, retire it and retry once with a fresh one
+        chain.fullPools.push_back(chain.readyPools.back());
+        chain.readyPools.pop_back();
+
+        allocInfo.descriptorPool = acquirePool(chain);
+        result = vkAllocateDescriptorSets(m_device, &allocInfo, &set);
+    }
+
+    if (result != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to allocate descriptor set");
+    }
+
+    return set;
+}
+
+VkDescriptorPool DescriptorAllocator::acquirePool(PoolChain& chain)
+{
+    if (chain.readyPools.empty())
+    {
+        chain.readyPools.push_back(createPool(chain.nextPoolSize));
+        chain.nextPoolSize = std::min(chain.nextPoolSize * 2, MAX_POOL_SETS);
+    }
+
+    return chain.readyPools.back();
+}
+
+VkDescriptorPool DescriptorAllocator::createPool(uint32_t maxSets)
+{
+    // Room for every descriptor type the renderer's layouts use
+    std::array<VkDescriptorPoolSize, 4> poolSizes{};
+    poolSizes[0] = {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, maxSets};
+    poolSizes[1] = {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, maxSets};
+    poolSizes[2] = {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, maxSets};
+    poolSizes[3] = {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, maxSets};
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    poolInfo.maxSets = maxSets;
+
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    if (vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &pool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create descriptor pool");
+    }
+
+    LOG_DEBUG("[Vulkan] Descriptor pool created ({} sets)", maxSets);
+    return pool;
+}
+
+void DescriptorAllocator::destroyChain(PoolChain& chain)
+{
+    for (VkDescriptorPool pool : chain.fullPools)
+    {
+        vkDestroyDescriptorPool(m_device, pool, nullptr);
+    }
+    for (VkDescriptorPool pool : chain.readyPools)
+    {
+        vkDestroyDescriptorPool(m_device, pool, nullptr);
+    }
+    chain.fullPools.clear();
+    chain.readyPools.clear();
+}
+
+} // namespace VK
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+namespace VK
+{
+    // Descriptor sets from chains of pools that grow on demand
+    // Static sets live until freed and are recycled per layout once the frames that
+    // may still use them have completed, so nothing is ever freed individually.
+    // Transient sets are only valid for the frame they were allocated in, their
+    // pools are reset as a whole when the frame slot comes around again.
+    class DescriptorAllocator
+    {
+    public:
+        DescriptorAllocator(VkDevice device, uint32_t frameSlotCount);
+        ~DescriptorAllocator();
+
+        DescriptorAllocator(const DescriptorAllocator&) = delete;
+        DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+        // Called once the frame that last used the slot has completed on the GPU
+        void beginFrame(uint32_t frameSlot, uint64_t completedFrameNumber);
+
+        VkDescriptorSet allocateStatic(VkDescriptorSetLayout layout);
+        VkDescriptorSet allocateTransient(VkDescriptorSetLayout layout);  // From the slot of beginFrame()
+
+        // The set becomes reusable after frame lastFrameNumber has completed
+        void freeStatic(VkDescriptorSetLayout layout, VkDescriptorSet set, uint64_t lastFrameNumber);
+
+    private:
+        struct PoolChain
+        {
+            std::vector<VkDescriptorPool> fullPools;
+            std::vector<VkDescriptorPool> readyPools;
+            uint32_t nextPoolSize = INITIAL_POOL_SETS;
+        };
+
+        struct RetiredSet
+        {
+            VkDescriptorSet set;
+            uint64_t frameNumber;
+        };
+
+        VkDescriptorSet allocate(PoolChain& chain, VkDescriptorSetLayout layout);
+        VkDescriptorPool acquirePool(PoolChain& chain);
+        VkDescriptorPool createPool(uint32_t maxSets);
+        void destroyChain(PoolChain& chain);
+
+        VkDevice m_device;
+        PoolChain m_staticPools;
+        std::vector<PoolChain> m_framePools;  // One chain per frame slot
+        uint32_t m_currentSlot;
+
+        // Freed static sets by layout, reused in the order they were freed
+        std::unordered_map<VkDescriptorSetLayout, std::vector<RetiredSet>> m_retiredSets;
+        std::unordered_map<VkDescriptorSetLayout, std::vector<VkDescriptorSet>> m_recycledSets;
+
+        // Pools double in size up to MAX_POOL_SETS
+        static constexpr uint32_t INITIAL_POOL_SETS = 64;
+        static constexpr uint32_t MAX_POOL_SETS = 4096;
+    };
+
+} // namespace VK
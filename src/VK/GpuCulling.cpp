@@ -0,0 +1,323 @@
+#include "GpuCulling.h"
+#include "Renderer.h"
+#include "DescriptorAllocator.h"
+#include "../Logger.h"
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+namespace VK
+{
+
+// Planes of the clip volume as (normal, distance), normals pointing inwards
+// The near plane is the one of a -1..1 depth range, which for 0..1 projections is
+// only less tight, never culls visible objects
+static void extractFrustumPlanes(const glm::mat4& viewProjection, glm::vec4 planes[6])
+{
+    glm::mat4 rows = glm::transpose(viewProjection);
+    planes[0] = rows[3] + rows[0];  // Left
+    planes[1] = rows[3] - rows[0];  // Right
+    planes[2] = rows[3] + rows[1];  // Bottom
+    planes[3] = rows[3] - rows[1];  // Top
+    planes[4] = rows[3] + rows[2];  // Near
+    planes[5] = rows[3] - rows[2];  // Far
+
+    for (int i = 0; i < 6; i++)
+    {
+        planes[i] /= glm::length(glm::vec3(planes[i]));
+    }
+}
+
+GpuCulling::GpuCulling(Renderer* renderer, VkDescriptorSetLayout objectSetLayout,
+                       const std::vector<char>& cullShaderCode)
+    : m_renderer(renderer)
+    , m_device(renderer->getDevice())
+    , m_objectSetLayout(objectSetLayout)
+    , m_cullSetLayout(VK_NULL_HANDLE)
+    , m_cullPipelineLayout(VK_NULL_HANDLE)
+    , m_cullPipeline(VK_NULL_HANDLE)
+    , m_dirtyBegin(0)
+    , m_dirtyEnd(0)
+    , m_cullSet(VK_NULL_HANDLE)
+    , m_objectSet(VK_NULL_HANDLE)
+{
+    // Objects, draw commands and draw count
+    std::array<VkDescriptorSetLayoutBinding, 3> bindings{};
+    for (uint32_t i = 0; i < bindings.size(); i++)
+    {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &m_cullSetLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create culling descriptor set layout");
+    }
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(CullConstants);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &m_cullSetLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, nullptr, &m_cullPipelineLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create culling pipeline layout");
+    }
+
+    VkShaderModuleCreateInfo moduleInfo{};
+    moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    moduleInfo.codeSize = cullShaderCode.size();
+    moduleInfo.pCode = reinterpret_cast<const uint32_t*>(cullShaderCode.data());
+
+    VkShaderModule module = VK_NULL_HANDLE;
+    if (vkCreateShaderModule(m_device, &moduleInfo, nullptr, &module) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create culling shader module");
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = module;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = m_cullPipelineLayout;
+
+    VkResult result = vkCreateComputePipelines(m_device, m_renderer->getPipelineCache(), 1, &pipelineInfo, nullptr,
+                                               &m_cullPipeline);
+    vkDestroyShaderModule(m_device, module, nullptr);
+    if (result != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create culling pipeline");
+    }
+
+    // Valid buffers and sets before the first setObjects(), culling nothing
+    setObjects({});
+}
+
+GpuCulling::~GpuCulling()
+{
+    // The owner guarantees that no frame is still in flight
+    // Descriptor sets are released with the descriptor allocator's pools
+    for (Buffer* buffer : {&m_objectBuffer, &m_drawBuffer, &m_countBuffer})
+    {
+        if (buffer->buffer != VK_NULL_HANDLE)
+        {
+            vkDestroyBuffer(m_device, buffer->buffer, nullptr);
+            m_renderer->getMemoryAllocator()->free(buffer->allocation);
+        }
+    }
+
+    vkDestroyPipeline(m_device, m_cullPipeline, nullptr);
+    vkDestroyPipelineLayout(m_device, m_cullPipelineLayout, nullptr);
+    vkDestroyDescriptorSetLayout(m_device, m_cullSetLayout, nullptr);
+}
+
+void GpuCulling::setObjects(const std::vector<GpuObjectData>& objects)
+{
+    // Frames in flight still read the current buffers, so the new objects get fresh ones
+    // and the upload needs no synchronization with the graphics queue
+    retireBuffer(m_objectBuffer);
+    retireBuffer(m_drawBuffer);
+    retireBuffer(m_countBuffer);
+
+    m_objects = objects;
+    m_dirtyBegin = 0;
+    m_dirtyEnd = 0;
+
+    // Zero-sized buffers aren't allowed
+    VkDeviceSize capacity = std::max<VkDeviceSize>(m_objects.size(), 1);
+    m_objectBuffer = createBuffer(capacity * sizeof(GpuObjectData),
+                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    m_drawBuffer = createBuffer(capacity * sizeof(VkDrawIndexedIndirectCommand),
+                                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+    m_countBuffer = createBuffer(sizeof(uint32_t),
+                                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                                 VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+
+    if (!m_objects.empty())
+    {
+        m_renderer->uploadToBuffer(m_objectBuffer.buffer, 0, m_objects.data(),
+                                   m_objects.size() * sizeof(GpuObjectData));
+    }
+
+    writeDescriptorSets();
+
+    LOG_INFO("[Vulkan] GPU culling set to {} objects", m_objects.size());
+}
+
+void GpuCulling::updateObjectTransform(uint32_t index, const glm::mat4& model)
+{
+    if (index >= m_objects.size())
+    {
+        LOG_WARNING("[Vulkan] GPU-driven object {} out of range ({} objects)", index, m_objects.size());
+        return;
+    }
+
+    m_objects[index].model = model;
+
+    if (m_dirtyBegin == m_dirtyEnd)
+    {
+        m_dirtyBegin = index;
+        m_dirtyEnd = index + 1;
+    }
+    else
+    {
+        m_dirtyBegin = std::min(m_dirtyBegin, index);
+        m_dirtyEnd = std::max(m_dirtyEnd, index + 1);
+    }
+}
+
+void GpuCulling::cull(VkCommandBuffer commandBuffer, const glm::mat4& viewProjection)
+{
+    // The previous frame's draws read the buffers written below
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 0, nullptr, 0, nullptr, 0, nullptr);
+
+    flushObjectUpdates(commandBuffer);
+    vkCmdFillBuffer(commandBuffer, m_countBuffer.buffer, 0, sizeof(uint32_t), 0);
+
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    uint32_t objectCount = getObjectCount();
+    if (objectCount > 0)
+    {
+        CullConstants constants{};
+        extractFrustumPlanes(viewProjection, constants.frustumPlanes);
+        constants.objectCount = objectCount;
+
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_cullPipeline);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_cullPipelineLayout,
+                                0, 1, &m_cullSet, 0, nullptr);
+        vkCmdPushConstants(commandBuffer, m_cullPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT,
+                           0, sizeof(CullConstants), &constants);
+        vkCmdDispatch(commandBuffer, (objectCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+    }
+
+    // Draw commands and count are read as indirect parameters, objects by the vertex shader
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+void GpuCulling::flushObjectUpdates(VkCommandBuffer commandBuffer)
+{
+    if (m_dirtyBegin == m_dirtyEnd)
+    {
+        return;
+    }
+
+    // Recorded into the frame's command buffer, so the write is ordered after the previous
+    // frames' reads on the same queue. vkCmdUpdateBuffer takes at most 64KB per call.
+    constexpr VkDeviceSize MAX_UPDATE_SIZE = 65536;
+    VkDeviceSize offset = static_cast<VkDeviceSize>(m_dirtyBegin) * sizeof(GpuObjectData);
+    VkDeviceSize end = static_cast<VkDeviceSize>(m_dirtyEnd) * sizeof(GpuObjectData);
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(m_objects.data());
+
+    while (offset < end)
+    {
+        VkDeviceSize size = std::min(end - offset, MAX_UPDATE_SIZE);
+        vkCmdUpdateBuffer(commandBuffer, m_objectBuffer.buffer, offset, size, data + offset);
+        offset += size;
+    }
+
+    m_dirtyBegin = 0;
+    m_dirtyEnd = 0;
+}
+
+GpuCulling::Buffer GpuCulling::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage)
+{
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = usage;
+    m_renderer->applyUploadSharingMode(bufferInfo);
+
+    Buffer buffer;
+    if (vkCreateBuffer(m_device, &bufferInfo, nullptr, &buffer.buffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create GPU culling buffer");
+    }
+
+    buffer.allocation = m_renderer->getMemoryAllocator()->allocateBufferMemory(
+        buffer.buffer, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    vkBindBufferMemory(m_device, buffer.buffer, buffer.allocation.memory, buffer.allocation.offset);
+    return buffer;
+}
+
+void GpuCulling::retireBuffer(Buffer& buffer)
+{
+    if (buffer.buffer == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    m_renderer->cancelPendingUploads(buffer.buffer);
+    m_renderer->deferDeleteBuffer(buffer.buffer);
+    m_renderer->deferFreeAllocation(buffer.allocation);
+    buffer = Buffer();
+}
+
+void GpuCulling::writeDescriptorSets()
+{
+    // The old sets may be bound by frames in flight
+    DescriptorAllocator* descriptorAllocator = m_renderer->getDescriptorAllocator();
+    uint64_t lastFrameNumber = m_renderer->getFrameNumber() + 1;
+    if (m_cullSet != VK_NULL_HANDLE)
+    {
+        descriptorAllocator->freeStatic(m_cullSetLayout, m_cullSet, lastFrameNumber);
+        descriptorAllocator->freeStatic(m_objectSetLayout, m_objectSet, lastFrameNumber);
+    }
+    m_cullSet = descriptorAllocator->allocateStatic(m_cullSetLayout);
+    m_objectSet = descriptorAllocator->allocateStatic(m_objectSetLayout);
+
+    std::array<VkDescriptorBufferInfo, 3> bufferInfos{};
+    bufferInfos[0] = {m_objectBuffer.buffer, 0, VK_WHOLE_SIZE};
+    bufferInfos[1] = {m_drawBuffer.buffer, 0, VK_WHOLE_SIZE};
+    bufferInfos[2] = {m_countBuffer.buffer, 0, VK_WHOLE_SIZE};
+
+    std::array<VkWriteDescriptorSet, 4> writes{};
+    for (uint32_t i = 0; i < writes.size(); i++)
+    {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].descriptorCount = 1;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    }
+    for (uint32_t i = 0; i < bufferInfos.size(); i++)
+    {
+        writes[i].dstSet = m_cullSet;
+        writes[i].dstBinding = i;
+        writes[i].pBufferInfo = &bufferInfos[i];
+    }
+    writes[3].dstSet = m_objectSet;
+    writes[3].dstBinding = 0;
+    writes[3].pBufferInfo = &bufferInfos[0];
+
+    vkUpdateDescriptorSets(m_device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+}
+
+} // namespace VK
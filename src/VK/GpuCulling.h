@@ -0,0 +1,95 @@
+#pragma once
+
+#include "MemoryAllocator.h"
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <cstdint>
+
+namespace VK
+{
+    class Renderer;
+
+    // Object of the GPU-driven path, std430 layout of ObjectData in
+    // shaders/vulkan/cull.comp and shaders/vulkan/indirect.vert
+    struct GpuObjectData
+    {
+        glm::mat4 model;
+        glm::vec4 boundingSphere;  // Object-space center and radius
+        uint32_t indexCount;
+        uint32_t firstIndex;
+        int32_t vertexOffset;
+        uint32_t padding;
+    };
+
+    // Frustum culling and indirect draws of objects sharing one vertex and index buffer
+    // Objects live in a device-local storage buffer, read by the vertex shader at OBJECT_SET.
+    // cull() records a compute dispatch that tests every object's bounding sphere against
+    // the frustum and appends a VkDrawIndexedIndirectCommand for each visible one, with
+    // the object index as firstInstance, plus the number of commands written. The pass
+    // then draws them all with a single vkCmdDrawIndexedIndirectCount.
+    class GpuCulling
+    {
+    public:
+        GpuCulling(Renderer* renderer, VkDescriptorSetLayout objectSetLayout, const std::vector<char>& cullShaderCode);
+        ~GpuCulling();
+
+        GpuCulling(const GpuCulling&) = delete;
+        GpuCulling& operator=(const GpuCulling&) = delete;
+
+        // Replaces every object, the buffers of the previous set are retired
+        void setObjects(const std::vector<GpuObjectData>& objects);
+
+        // Written into the object buffer by the next cull()
+        void updateObjectTransform(uint32_t index, const glm::mat4& model);
+
+        // Recorded outside a render pass, before the frame's indirect draws
+        void cull(VkCommandBuffer commandBuffer, const glm::mat4& viewProjection);
+
+        uint32_t getObjectCount() const { return static_cast<uint32_t>(m_objects.size()); }
+        VkDescriptorSet getObjectSet() const { return m_objectSet; }
+        VkBuffer getDrawBuffer() const { return m_drawBuffer.buffer; }
+        VkBuffer getDrawCountBuffer() const { return m_countBuffer.buffer; }
+
+        static constexpr uint32_t WORKGROUP_SIZE = 64;  // local_size_x of cull.comp
+
+    private:
+        struct Buffer
+        {
+            VkBuffer buffer = VK_NULL_HANDLE;
+            Allocation allocation{};
+        };
+
+        // Push constants of cull.comp
+        struct CullConstants
+        {
+            glm::vec4 frustumPlanes[6];
+            uint32_t objectCount;
+        };
+
+        Buffer createBuffer(VkDeviceSize size, VkBufferUsageFlags usage);
+        void retireBuffer(Buffer& buffer);
+        void writeDescriptorSets();
+        void flushObjectUpdates(VkCommandBuffer commandBuffer);
+
+        Renderer* m_renderer;
+        VkDevice m_device;
+        VkDescriptorSetLayout m_objectSetLayout;
+
+        VkDescriptorSetLayout m_cullSetLayout;
+        VkPipelineLayout m_cullPipelineLayout;
+        VkPipeline m_cullPipeline;
+
+        // CPU copy of the objects, transform updates are copied from it in dirty ranges
+        std::vector<GpuObjectData> m_objects;
+        uint32_t m_dirtyBegin;
+        uint32_t m_dirtyEnd;
+
+        Buffer m_objectBuffer;
+        Buffer m_drawBuffer;   // VkDrawIndexedIndirectCommand per object
+        Buffer m_countBuffer;  // Number of commands written by the last cull
+        VkDescriptorSet m_cullSet;
+        VkDescriptorSet m_objectSet;
+    };
+
+} // namespace VK
@@ -0,0 +1,236 @@
+#include "GpuProfiler.h"
+#include "../Logger.h"
+#include <stdexcept>
+
+namespace VK
+{
+
+// Results are returned in bit order, GpuProfiler::resolveStatistics() relies on it
+static constexpr VkQueryPipelineStatisticFlags PIPELINE_STATISTICS =
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+GpuProfiler::GpuProfiler(VkDevice device, float timestampPeriod, uint32_t timestampValidBits,
+                         bool pipelineStatisticsSupported, uint32_t frameSlotCount)
+    : m_device(device)
+    , m_nanosecondsPerTick(timestampPeriod)
+    , m_timestampMask(timestampValidBits >= 64 ? UINT64_MAX : (uint64_t(1) << timestampValidBits) - 1)
+    , m_frames(frameSlotCount)
+    , m_currentSlot(0)
+    , m_timestamps(MAX_ZONES_PER_FRAME * 2)
+    , m_overflowWarned(false)
+    , m_statisticsFlags(pipelineStatisticsSupported ? PIPELINE_STATISTICS : 0)
+    , m_statisticsValid(false)
+{
+    VkQueryPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    poolInfo.queryCount = MAX_ZONES_PER_FRAME * 2;
+
+    VkQueryPoolCreateInfo statisticsPoolInfo{};
+    statisticsPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    statisticsPoolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+    statisticsPoolInfo.queryCount = 1;
+    statisticsPoolInfo.pipelineStatistics = m_statisticsFlags;
+
+    for (FrameQueries& frame : m_frames)
+    {
+        if (hasTimestamps() && vkCreateQueryPool(m_device, &poolInfo, nullptr, &frame.pool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create timestamp query pool");
+        }
+        if (hasPipelineStatistics() &&
+            vkCreateQueryPool(m_device, &statisticsPoolInfo, nullptr, &frame.statisticsPool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create pipeline statistics query pool");
+        }
+        frame.zones.reserve(MAX_ZONES_PER_FRAME);
+    }
+}
+
+GpuProfiler::~GpuProfiler()
+{
+    // The owner guarantees that no frame is still in flight
+    for (FrameQueries& frame : m_frames)
+    {
+        vkDestroyQueryPool(m_device, frame.pool, nullptr);
+        vkDestroyQueryPool(m_device, frame.statisticsPool, nullptr);
+    }
+}
+
+void GpuProfiler::beginFrame(uint32_t frameSlot, VkCommandBuffer commandBuffer, bool collectStatistics)
+{
+    m_currentSlot = frameSlot;
+
+    FrameQueries& frame = m_frames[frameSlot];
+    resolve(frame);
+    resolveStatistics(frame);
+
+    frame.zones.clear();
+    frame.queryCount = 0;
+    m_openZones.clear();
+
+    if (hasTimestamps())
+    {
+        vkCmdResetQueryPool(commandBuffer, frame.pool, 0, MAX_ZONES_PER_FRAME * 2);
+    }
+
+    frame.statisticsActive = collectStatistics && hasPipelineStatistics();
+    if (frame.statisticsActive)
+    {
+        vkCmdResetQueryPool(commandBuffer, frame.statisticsPool, 0, 1);
+        vkCmdBeginQuery(commandBuffer, frame.statisticsPool, 0, 0);
+    }
+}
+
+void GpuProfiler::endFrame(VkCommandBuffer commandBuffer)
+{
+    while (!m_openZones.empty())
+    {
+        endZone(commandBuffer);
+    }
+
+    if (m_frames[m_currentSlot].statisticsActive)
+    {
+        vkCmdEndQuery(commandBuffer, m_frames[m_currentSlot].statisticsPool, 0);
+    }
+}
+
+bool GpuProfiler::getPipelineStatistics(GpuPipelineStatistics& statistics) const
+{
+    if (!m_statisticsValid)
+    {
+        return false;
+    }
+
+    statistics = m_statistics;
+    return true;
+}
+
+VkQueryPipelineStatisticFlags GpuProfiler::getActiveStatisticsFlags() const
+{
+    return m_frames[m_currentSlot].statisticsActive ? m_statisticsFlags : 0;
+}
+
+void GpuProfiler::beginZone(VkCommandBuffer commandBuffer, const std::string& name)
+{
+    FrameQueries& frame = m_frames[m_currentSlot];
+
+    // Without timestamps zones are only tracked so their ends still match
+    if (!hasTimestamps())
+    {
+        m_openZones.push_back(UINT32_MAX);
+        return;
+    }
+
+    // Zones past the limit are dropped, their end is still matched
+    if (frame.zones.size() >= MAX_ZONES_PER_FRAME)
+    {
+        if (!m_overflowWarned)
+        {
+            LOG_WARNING("[Vulkan] More than {} GPU zones in a frame, the rest are not timed", MAX_ZONES_PER_FRAME);
+            m_overflowWarned = true;
+        }
+        m_openZones.push_back(UINT32_MAX);
+        return;
+    }
+
+    Zone zone;
+    zone.name = name;
+    zone.depth = static_cast<uint32_t>(m_openZones.size());
+    zone.beginQuery = frame.queryCount++;
+    zone.endQuery = UINT32_MAX;
+
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.pool, zone.beginQuery);
+
+    m_openZones.push_back(static_cast<uint32_t>(frame.zones.size()));
+    frame.zones.push_back(std::move(zone));
+}
+
+void GpuProfiler::endZone(VkCommandBuffer commandBuffer)
+{
+    if (m_openZones.empty())
+    {
+        return;
+    }
+
+    uint32_t zoneIndex = m_openZones.back();
+    m_openZones.pop_back();
+
+    if (zoneIndex == UINT32_MAX)
+    {
+        return;
+    }
+
+    FrameQueries& frame = m_frames[m_currentSlot];
+    Zone& zone = frame.zones[zoneIndex];
+    zone.endQuery = frame.queryCount++;
+
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.pool, zone.endQuery);
+}
+
+void GpuProfiler::resolve(FrameQueries& frame)
+{
+    if (frame.queryCount == 0)
+    {
+        return;
+    }
+
+    // The frame has completed, so the results are available without waiting
+    VkResult result = vkGetQueryPoolResults(m_device, frame.pool, 0, frame.queryCount,
+                                            frame.queryCount * sizeof(uint64_t), m_timestamps.data(),
+                                            sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS)
+    {
+        LOG_DEBUG("[Vulkan] GPU zone results of frame slot {} not available", m_currentSlot);
+        return;
+    }
+
+    m_results.clear();
+    for (const Zone& zone : frame.zones)
+    {
+        if (zone.endQuery == UINT32_MAX)
+        {
+            continue;
+        }
+
+        uint64_t ticks = (m_timestamps[zone.endQuery] - m_timestamps[zone.beginQuery]) & m_timestampMask;
+
+        GpuZoneTime time;
+        time.name = zone.name;
+        time.depth = zone.depth;
+        time.milliseconds = static_cast<double>(ticks) * m_nanosecondsPerTick / 1000000.0;
+        m_results.push_back(std::move(time));
+    }
+}
+
+void GpuProfiler::resolveStatistics(FrameQueries& frame)
+{
+    if (!frame.statisticsActive)
+    {
+        return;
+    }
+
+    uint64_t counters[6] = {};
+    VkResult result = vkGetQueryPoolResults(m_device, frame.statisticsPool, 0, 1, sizeof(counters), counters,
+                                            sizeof(counters), VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS)
+    {
+        LOG_DEBUG("[Vulkan] Pipeline statistics of frame slot {} not available", m_currentSlot);
+        return;
+    }
+
+    m_statistics.inputVertices = counters[0];
+    m_statistics.inputPrimitives = counters[1];
+    m_statistics.vertexShaderInvocations = counters[2];
+    m_statistics.clippingInvocations = counters[3];
+    m_statistics.clippingPrimitives = counters[4];
+    m_statistics.fragmentShaderInvocations = counters[5];
+    m_statisticsValid = true;
+}
+
+} // namespace VK
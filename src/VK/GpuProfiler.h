@@ -0,0 +1,91 @@
+#pragma once
+
+#include "../RenderAPI/IRenderer.h"
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace VK
+{
+    // Timestamps written around named zones of a frame's command buffer, and a pipeline
+    // statistics query spanning the whole frame
+    // Every frame slot owns its query pools. A slot's results are read when the slot is
+    // reused, after its frame has completed, so reading never waits on the GPU and the
+    // results lag the recorded frame by the number of frames in flight.
+    class GpuProfiler
+    {
+    public:
+        // timestampValidBits is 0 without timestamp support, zones are then not timed
+        GpuProfiler(VkDevice device, float timestampPeriod, uint32_t timestampValidBits,
+                    bool pipelineStatisticsSupported, uint32_t frameSlotCount);
+        ~GpuProfiler();
+
+        GpuProfiler(const GpuProfiler&) = delete;
+        GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+        // Called at the start of the slot's command buffer, outside a render pass,
+        // once the frame that last used the slot has completed on the GPU
+        // The statistics query is skipped if collectStatistics is false
+        void beginFrame(uint32_t frameSlot, VkCommandBuffer commandBuffer, bool collectStatistics);
+
+        // Closes the zones still open and ends the statistics query
+        void endFrame(VkCommandBuffer commandBuffer);
+
+        void beginZone(VkCommandBuffer commandBuffer, const std::string& name);
+        void endZone(VkCommandBuffer commandBuffer);
+        uint32_t getOpenZoneCount() const { return static_cast<uint32_t>(m_openZones.size()); }
+
+        // Zones of the most recently resolved frame
+        const std::vector<GpuZoneTime>& getResults() const { return m_results; }
+
+        bool hasTimestamps() const { return m_timestampMask != 0; }
+        bool hasPipelineStatistics() const { return m_statisticsFlags != 0; }
+
+        // Statistics of the most recently resolved frame that collected them
+        bool getPipelineStatistics(GpuPipelineStatistics& statistics) const;
+
+        // Statistics counted by the frame being recorded, secondary command buffers
+        // executed in it must inherit them (0 if no query is active)
+        VkQueryPipelineStatisticFlags getActiveStatisticsFlags() const;
+
+        static constexpr uint32_t MAX_ZONES_PER_FRAME = 256;
+
+    private:
+        struct Zone
+        {
+            std::string name;
+            uint32_t depth;
+            uint32_t beginQuery;
+            uint32_t endQuery;
+        };
+
+        struct FrameQueries
+        {
+            VkQueryPool pool = VK_NULL_HANDLE;
+            std::vector<Zone> zones;
+            uint32_t queryCount = 0;
+
+            VkQueryPool statisticsPool = VK_NULL_HANDLE;
+            bool statisticsActive = false;  // The frame recorded a statistics query
+        };
+
+        void resolve(FrameQueries& frame);
+        void resolveStatistics(FrameQueries& frame);
+
+        VkDevice m_device;
+        double m_nanosecondsPerTick;
+        uint64_t m_timestampMask;
+        std::vector<FrameQueries> m_frames;
+        uint32_t m_currentSlot;
+        std::vector<uint32_t> m_openZones;  // Indices into the current frame's zones
+        std::vector<uint64_t> m_timestamps;
+        std::vector<GpuZoneTime> m_results;
+        bool m_overflowWarned;
+
+        VkQueryPipelineStatisticFlags m_statisticsFlags;
+        GpuPipelineStatistics m_statistics;
+        bool m_statisticsValid;
+    };
+
+} // namespace VK
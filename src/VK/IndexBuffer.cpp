@@ -14,6 +14,7 @@ IndexBuffer::IndexBuffer(VkDevice device, VkPhysicalDevice physicalDevice, Rende
     , m_buffer(VK_NULL_HANDLE)
     , m_memory(VK_NULL_HANDLE)
     , m_size(0)
+    , m_deviceLocal(false)
     , m_count(0)
     , m_indexType(IndexType::UnsignedInt)
 {
@@ -31,6 +32,7 @@ IndexBuffer::IndexBuffer(IndexBuffer&& other) noexcept
     , m_buffer(other.m_buffer)
     , m_memory(other.m_memory)
     , m_size(other.m_size)
+    , m_deviceLocal(other.m_deviceLocal)
     , m_count(other.m_count)
     , m_indexType(other.m_indexType)
 {
@@ -53,6 +55,7 @@ IndexBuffer& IndexBuffer::operator=(IndexBuffer&& other) noexcept
         m_buffer = other.m_buffer;
         m_memory = other.m_memory;
         m_size = other.m_size;
+        m_deviceLocal = other.m_deviceLocal;
         m_count = other.m_count;
         m_indexType = other.m_indexType;
 
@@ -85,15 +88,27 @@ void IndexBuffer::setData(const void* data, size_t count, IndexType type, Buffer
     m_indexType = type;
     m_size = count * getIndexSize(type);
 
-    // Create buffer with host visible memory for simplicity
-    createBuffer(m_size, VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    // Static indices live in device-local memory and are uploaded through the staging ring
+    m_deviceLocal = (usage == BufferUsage::Static && m_renderer != nullptr);
 
-    // Copy data to buffer
-    void* mappedData;
-    vkMapMemory(m_device, m_memory, 0, m_size, 0, &mappedData);
-    std::memcpy(mappedData, data, m_size);
-    vkUnmapMemory(m_device, m_memory);
+    if (m_deviceLocal)
+    {
+        createBuffer(m_size, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        m_renderer->uploadToBuffer(m_buffer, 0, data, m_size);
+    }
+    else
+    {
+        // Updates are still copied in the frame's command buffer, see updateData()
+        createBuffer(m_size, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+        // Copy data to buffer
+        void* mappedData;
+        vkMapMemory(m_device, m_memory, 0, m_size, 0, &mappedData);
+        std::memcpy(mappedData, data, m_size);
+        vkUnmapMemory(m_device, m_memory);
+    }
 
     // Register this index buffer with the currently bound VAO
     if (m_renderer)
@@ -125,10 +140,10 @@ void IndexBuffer::updateData(const void* data, size_t count, size_t offset)
         return;
     }
 
-    void* mappedData;
-    vkMapMemory(m_device, m_memory, byteOffset, size, 0, &mappedData);
-    std::memcpy(mappedData, data, size);
-    vkUnmapMemory(m_device, m_memory);
+    // Ordered with the draws of the frame, frames in flight keep reading the old contents.
+    // Host-visible buffers too: written in place, the data would change under those frames.
+    m_renderer->updateBuffer(m_buffer, byteOffset, data, size,
+                             VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDEX_READ_BIT);
 }
 
 VkIndexType IndexBuffer::getVkIndexType() const
@@ -144,6 +159,12 @@ void IndexBuffer::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMe
     bufferInfo.usage = usage;
     bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
+    // Device-local buffers are written by the transfer queue
+    if (m_deviceLocal)
+    {
+        m_renderer->applyUploadSharingMode(bufferInfo);
+    }
+
     if (vkCreateBuffer(m_device, &bufferInfo, nullptr, &m_buffer) != VK_SUCCESS)
     {
         throw std::runtime_error("Failed to create Vulkan index buffer");
@@ -186,24 +207,20 @@ void IndexBuffer::cleanup()
 {
     if (m_buffer != VK_NULL_HANDLE || m_memory != VK_NULL_HANDLE)
     {
-        // CRITICAL: Wait for device to finish using this buffer before destroying it
-        // This prevents validation errors about destroying in-use resources
-        if (m_device != VK_NULL_HANDLE)
-        {
-            vkDeviceWaitIdle(m_device);
-        }
-
-        if (m_buffer != VK_NULL_HANDLE)
-        {
-            vkDestroyBuffer(m_device, m_buffer, nullptr);
-            m_buffer = VK_NULL_HANDLE;
-        }
-
-        if (m_memory != VK_NULL_HANDLE)
+        if (m_renderer)
         {
-            vkFreeMemory(m_device, m_memory, nullptr);
-            m_memory = VK_NULL_HANDLE;
+            // Drop a copy still queued in an open upload batch
+            if (m_deviceLocal)
+            {
+                m_renderer->cancelPendingUploads(m_buffer);
+            }
+
+            // Destroyed once the frames that may still read the buffer have completed
+            m_renderer->deferDeleteBuffer(m_buffer);
+            m_renderer->deferDeleteDeviceMemory(m_memory);
         }
+        m_buffer = VK_NULL_HANDLE;
+        m_memory = VK_NULL_HANDLE;
 
         m_size = 0;
         m_count = 0;
@@ -12,7 +12,8 @@ namespace VK
     class IndexBuffer : public IIndexBuffer
     {
     public:
-        IndexBuffer(VkDevice device, VkPhysicalDevice physicalDevice, Renderer* renderer = nullptr);
+        // Required, destruction is deferred on the renderer's frame timeline
+        IndexBuffer(VkDevice device, VkPhysicalDevice physicalDevice, Renderer* renderer);
         ~IndexBuffer() override;
 
         IndexBuffer(const IndexBuffer&) = delete;
@@ -47,6 +48,7 @@ namespace VK
         VkBuffer m_buffer;
         VkDeviceMemory m_memory;
         VkDeviceSize m_size;
+        bool m_deviceLocal;  // Static data, written through the staging ring
         size_t m_count;
         IndexType m_indexType;
     };
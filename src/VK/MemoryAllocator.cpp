@@ -18,7 +18,7 @@ MemoryAllocator::~MemoryAllocator()
     cleanup();
 }
 
-Allocation MemoryAllocator::allocateBufferMemory(VkBuffer buffer, VkMemoryPropertyFlags properties)
+Allocation MemoryAllocator::allocateBufferMemory(VkBuffer buffer, VkMemoryPropertyFlags properties, bool dedicated)
 {
     VkMemoryRequirements memRequirements;
     vkGetBufferMemoryRequirements(m_device, buffer, &memRequirements);
@@ -27,7 +27,7 @@ Allocation MemoryAllocator::allocateBufferMemory(VkBuffer buffer, VkMemoryProper
 
     // For small allocations, try to use pooled memory
     // For large allocations (>16MB), allocate separately
-    if (memRequirements.size < 16 * 1024 * 1024)
+    if (!dedicated && memRequirements.size < 16 * 1024 * 1024)
     {
         MemoryBlock* block = findOrCreateBlock(memoryTypeIndex, memRequirements.size, memRequirements.alignment);
 
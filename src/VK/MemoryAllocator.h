@@ -32,7 +32,8 @@ namespace VK
         ~MemoryAllocator();
 
         // Allocate memory for a buffer
-        Allocation allocateBufferMemory(VkBuffer buffer, VkMemoryPropertyFlags properties);
+        // Dedicated allocations bypass the pools so free() returns the memory right away
+        Allocation allocateBufferMemory(VkBuffer buffer, VkMemoryPropertyFlags properties, bool dedicated = false);
 
         // Allocate memory for an image
         Allocation allocateImageMemory(VkImage image, VkMemoryPropertyFlags properties);
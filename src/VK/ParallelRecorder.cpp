@@ -0,0 +1,387 @@
+#include "ParallelRecorder.h"
+#include "../Logger.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace VK
+{
+
+void recordDrawCommand(VkCommandBuffer commandBuffer,
+                       const DynamicStateFunctions& dynamicState,
+                       const DrawCommand& draw,
+                       CommandBindState& state)
+{
+    if (draw.pipeline != state.pipeline)
+    {
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, draw.pipeline);
+        state.pipeline = draw.pipeline;
+    }
+
+    // Layouts with other push constant ranges disturb bound sets and push constants
+    VkPipelineLayout pipelineLayout = draw.pipelineLayout;
+    if (pipelineLayout != state.pipelineLayout)
+    {
+        state.pipelineLayout = pipelineLayout;
+        state.descriptorSet = VK_NULL_HANDLE;
+        state.bindlessSet = VK_NULL_HANDLE;
+        state.textureIndexValid = false;
+        state.uniformSet = VK_NULL_HANDLE;
+        state.objectSet = VK_NULL_HANDLE;
+        state.pushConstantsValid = false;
+    }
+
+    // Every pipeline declares the same dynamic states, so values survive pipeline switches
+    if (!state.renderStateValid || draw.renderState != state.renderState)
+    {
+        const RenderState& renderState = draw.renderState;
+        if (dynamicState.hasDynamicRasterState())
+        {
+            dynamicState.setDepthTestEnable(commandBuffer, renderState.depthTest ? VK_TRUE : VK_FALSE);
+            dynamicState.setDepthWriteEnable(commandBuffer, renderState.depthWrite ? VK_TRUE : VK_FALSE);
+            dynamicState.setCullMode(commandBuffer, renderState.cullMode);
+            dynamicState.setFrontFace(commandBuffer, renderState.frontFace);
+        }
+        if (dynamicState.hasDynamicBlendEnable())
+        {
+            VkBool32 blendEnable = renderState.blend ? VK_TRUE : VK_FALSE;
+            dynamicState.setColorBlendEnable(commandBuffer, 0, 1, &blendEnable);
+        }
+        state.renderState = renderState;
+        state.renderStateValid = true;
+    }
+
+    if (draw.descriptorSet != VK_NULL_HANDLE && draw.descriptorSet != state.descriptorSet)
+    {
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout,
+                                TEXTURE_SET, 1, &draw.descriptorSet, 0, nullptr);
+        state.descriptorSet = draw.descriptorSet;
+    }
+
+    // The bindless array is bound once, after that only the texture index changes
+    if (draw.bindlessSet != VK_NULL_HANDLE)
+    {
+        if (draw.bindlessSet != state.bindlessSet)
+        {
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout,
+                                    BINDLESS_SET, 1, &draw.bindlessSet, 0, nullptr);
+            state.bindlessSet = draw.bindlessSet;
+        }
+
+        const VkPushConstantRange& range = draw.pushConstantRange;
+        bool hasTextureIndex = range.offset <= BINDLESS_TEXTURE_INDEX_OFFSET &&
+                               range.offset + range.size >= BINDLESS_TEXTURE_INDEX_OFFSET + sizeof(uint32_t);
+        if (hasTextureIndex && (!state.textureIndexValid || draw.textureIndex != state.textureIndex))
+        {
+            vkCmdPushConstants(commandBuffer, pipelineLayout, range.stageFlags,
+                               BINDLESS_TEXTURE_INDEX_OFFSET, sizeof(uint32_t), &draw.textureIndex);
+            state.textureIndex = draw.textureIndex;
+            state.textureIndexValid = true;
+        }
+    }
+
+    if (draw.uniformSet != VK_NULL_HANDLE &&
+        (draw.uniformSet != state.uniformSet || draw.uniformOffset != state.uniformOffset))
+    {
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout,
+                                UNIFORM_SET, 1, &draw.uniformSet, 1, &draw.uniformOffset);
+        state.uniformSet = draw.uniformSet;
+        state.uniformOffset = draw.uniformOffset;
+    }
+
+    if (draw.objectSet != VK_NULL_HANDLE && draw.objectSet != state.objectSet)
+    {
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout,
+                                OBJECT_SET, 1, &draw.objectSet, 0, nullptr);
+        state.objectSet = draw.objectSet;
+    }
+
+    // Only the part of the matrices the layout's range covers, with all of its stages
+    const VkPushConstantRange& range = draw.pushConstantRange;
+    uint32_t matrixEnd = std::min<uint32_t>(range.offset + range.size, sizeof(PushConstantData));
+    if (range.offset < matrixEnd &&
+        (!state.pushConstantsValid ||
+         std::memcmp(&state.pushConstants, &draw.pushConstants, sizeof(PushConstantData)) != 0))
+    {
+        vkCmdPushConstants(commandBuffer, pipelineLayout, range.stageFlags, range.offset, matrixEnd - range.offset,
+                           reinterpret_cast<const uint8_t*>(&draw.pushConstants) + range.offset);
+        state.pushConstants = draw.pushConstants;
+        state.pushConstantsValid = true;
+    }
+
+    if (draw.vertexBuffer != VK_NULL_HANDLE && draw.vertexBuffer != state.vertexBuffer)
+    {
+        VkDeviceSize offsets[] = {0};
+        vkCmdBindVertexBuffers(commandBuffer, 0, 1, &draw.vertexBuffer, offsets);
+        state.vertexBuffer = draw.vertexBuffer;
+    }
+
+    if (draw.instanceBuffer != VK_NULL_HANDLE && draw.instanceBuffer != state.instanceBuffer)
+    {
+        VkDeviceSize offsets[] = {0};
+        vkCmdBindVertexBuffers(commandBuffer, VertexInputLayout::INSTANCE_BINDING, 1, &draw.instanceBuffer, offsets);
+        state.instanceBuffer = draw.instanceBuffer;
+    }
+
+    if (draw.indexed)
+    {
+        if (draw.indexBuffer != VK_NULL_HANDLE && draw.indexBuffer != state.indexBuffer)
+        {
+            vkCmdBindIndexBuffer(commandBuffer, draw.indexBuffer, 0, draw.indexType);
+            state.indexBuffer = draw.indexBuffer;
+        }
+        if (draw.indirectBuffer != VK_NULL_HANDLE)
+        {
+            vkCmdDrawIndexedIndirectCount(commandBuffer, draw.indirectBuffer, 0, draw.indirectCountBuffer, 0,
+                                          draw.count, sizeof(VkDrawIndexedIndirectCommand));
+        }
+        else
+        {
+            vkCmdDrawIndexed(commandBuffer, draw.count, draw.instanceCount, draw.first, 0, 0);
+        }
+    }
+    else
+    {
+        vkCmdDraw(commandBuffer, draw.count, draw.instanceCount, draw.first, 0);
+    }
+}
+
+ParallelRecorder::ParallelRecorder(VkDevice device, uint32_t queueFamilyIndex,
+                                   uint32_t threadCount, uint32_t framesInFlight,
+                                   const DynamicStateFunctions& dynamicState)
+    : m_device(device)
+    , m_dynamicState(dynamicState)
+    , m_frameIndex(0)
+    , m_draws(nullptr)
+    , m_inheritanceInfo(nullptr)
+    , m_viewport{}
+    , m_scissor{}
+    , m_sliceCount(0)
+    , m_sliceSize(0)
+    , m_jobGeneration(0)
+    , m_pendingWorkers(0)
+    , m_stop(false)
+{
+    m_threadData.resize(threadCount);
+    m_results.resize(threadCount, VK_NULL_HANDLE);
+
+    for (uint32_t t = 0; t < threadCount; t++)
+    {
+        m_threadData[t].resize(framesInFlight);
+        for (uint32_t f = 0; f < framesInFlight; f++)
+        {
+            // Transient: the pool is reset as a whole at the start of every frame
+            VkCommandPoolCreateInfo poolInfo{};
+            poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            poolInfo.queueFamilyIndex = queueFamilyIndex;
+
+            ThreadFrameData& data = m_threadData[t][f];
+            if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &data.commandPool) != VK_SUCCESS)
+            {
+                throw std::runtime_error("Failed to create worker command pool");
+            }
+        }
+    }
+
+    for (uint32_t t = 0; t < threadCount; t++)
+    {
+        m_workers.emplace_back(&ParallelRecorder::workerLoop, this, t);
+    }
+
+    LOG_INFO("[Vulkan] Parallel command recording enabled with {} threads", threadCount);
+}
+
+ParallelRecorder::~ParallelRecorder()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_workCondition.notify_all();
+
+    for (std::thread& worker : m_workers)
+    {
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+
+    // Destroying the pools also frees their command buffers
+    for (auto& frames : m_threadData)
+    {
+        for (ThreadFrameData& data : frames)
+        {
+            if (data.commandPool != VK_NULL_HANDLE)
+            {
+                vkDestroyCommandPool(m_device, data.commandPool, nullptr);
+            }
+        }
+    }
+}
+
+void ParallelRecorder::beginFrame(uint32_t frameIndex)
+{
+    // Workers only touch their pools inside record(), which has returned by now
+    for (auto& frames : m_threadData)
+    {
+        ThreadFrameData& data = frames[frameIndex];
+        if (data.usedCount > 0)
+        {
+            vkResetCommandPool(m_device, data.commandPool, 0);
+            data.usedCount = 0;
+        }
+    }
+}
+
+void ParallelRecorder::record(uint32_t frameIndex,
+                              const std::vector<DrawCommand>& draws,
+                              const VkCommandBufferInheritanceInfo& inheritanceInfo,
+                              const VkViewport& viewport,
+                              const VkRect2D& scissor,
+                              std::vector<VkCommandBuffer>& outCommandBuffers)
+{
+    outCommandBuffers.clear();
+    if (draws.empty() || m_workers.empty())
+    {
+        return;
+    }
+
+    uint32_t threadCount = static_cast<uint32_t>(m_workers.size());
+    uint32_t drawCount = static_cast<uint32_t>(draws.size());
+
+    // Contiguous slices keep the submission order of the draws intact
+    uint32_t sliceCount = std::min(threadCount, (drawCount + MIN_DRAWS_PER_SLICE - 1) / MIN_DRAWS_PER_SLICE);
+    sliceCount = std::max(sliceCount, 1u);
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_frameIndex = frameIndex;
+        m_draws = &draws;
+        m_inheritanceInfo = &inheritanceInfo;
+        m_viewport = viewport;
+        m_scissor = scissor;
+        m_sliceCount = sliceCount;
+        m_sliceSize = (drawCount + sliceCount - 1) / sliceCount;
+        m_pendingWorkers = threadCount;
+        m_jobGeneration++;
+    }
+    m_workCondition.notify_all();
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_doneCondition.wait(lock, [this]() { return m_pendingWorkers == 0; });
+        m_draws = nullptr;
+        m_inheritanceInfo = nullptr;
+    }
+
+    for (uint32_t t = 0; t < sliceCount; t++)
+    {
+        if (m_results[t] != VK_NULL_HANDLE)
+        {
+            outCommandBuffers.push_back(m_results[t]);
+        }
+    }
+}
+
+void ParallelRecorder::workerLoop(uint32_t threadIndex)
+{
+    uint64_t seenGeneration = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_workCondition.wait(lock, [this, seenGeneration]() {
+                return m_stop || m_jobGeneration != seenGeneration;
+            });
+
+            if (m_stop)
+            {
+                return;
+            }
+            seenGeneration = m_jobGeneration;
+        }
+
+        recordSlice(threadIndex);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_pendingWorkers == 0)
+            {
+                m_doneCondition.notify_one();
+            }
+        }
+    }
+}
+
+void ParallelRecorder::recordSlice(uint32_t threadIndex)
+{
+    m_results[threadIndex] = VK_NULL_HANDLE;
+
+    if (threadIndex >= m_sliceCount)
+    {
+        return;
+    }
+
+    const std::vector<DrawCommand>& draws = *m_draws;
+    size_t begin = static_cast<size_t>(threadIndex) * m_sliceSize;
+    size_t end = std::min(begin + m_sliceSize, draws.size());
+    if (begin >= end)
+    {
+        return;
+    }
+
+    // Earlier passes of the frame keep their secondaries, this pass takes the next one
+    ThreadFrameData& data = m_threadData[threadIndex][m_frameIndex];
+    if (data.usedCount == data.commandBuffers.size())
+    {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = data.commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocInfo.commandBufferCount = 1;
+
+        VkCommandBuffer newBuffer = VK_NULL_HANDLE;
+        if (vkAllocateCommandBuffers(m_device, &allocInfo, &newBuffer) != VK_SUCCESS)
+        {
+            LOG_ERROR("[Vulkan] Failed to allocate secondary command buffer on worker {}", threadIndex);
+            return;
+        }
+        data.commandBuffers.push_back(newBuffer);
+    }
+    VkCommandBuffer commandBuffer = data.commandBuffers[data.usedCount++];
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
+                      VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = m_inheritanceInfo;
+
+    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+    {
+        LOG_ERROR("[Vulkan] Failed to begin secondary command buffer on worker {}", threadIndex);
+        return;
+    }
+
+    // Dynamic state is not inherited from the primary command buffer
+    vkCmdSetViewport(commandBuffer, 0, 1, &m_viewport);
+    vkCmdSetScissor(commandBuffer, 0, 1, &m_scissor);
+
+    CommandBindState state;
+    for (size_t i = begin; i < end; i++)
+    {
+        recordDrawCommand(commandBuffer, m_dynamicState, draws[i], state);
+    }
+
+    if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+    {
+        LOG_ERROR("[Vulkan] Failed to record secondary command buffer on worker {}", threadIndex);
+        return;
+    }
+
+    m_results[threadIndex] = commandBuffer;
+}
+
+} // namespace VK
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "ShaderProgram.h"
+#include "PipelineState.h"
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+namespace VK
+{
+    // Extended dynamic state entry points, null when the device doesn't support them
+    // Render state that isn't dynamic is baked into pipeline variants instead
+    struct DynamicStateFunctions
+    {
+        PFN_vkCmdSetCullModeEXT setCullMode = nullptr;
+        PFN_vkCmdSetFrontFaceEXT setFrontFace = nullptr;
+        PFN_vkCmdSetDepthTestEnableEXT setDepthTestEnable = nullptr;
+        PFN_vkCmdSetDepthWriteEnableEXT setDepthWriteEnable = nullptr;
+        PFN_vkCmdSetColorBlendEnableEXT setColorBlendEnable = nullptr;
+
+        bool hasDynamicRasterState() const { return setCullMode != nullptr; }
+        bool hasDynamicBlendEnable() const { return setColorBlendEnable != nullptr; }
+    };
+
+    // Descriptor sets of the shared pipeline layout
+    constexpr uint32_t TEXTURE_SET = 0;   // Per-texture combined image sampler
+    constexpr uint32_t BINDLESS_SET = 1;  // Texture array, empty without bindless support
+    constexpr uint32_t UNIFORM_SET = 2;   // Shader uniform block, dynamic offset into the uniform ring
+    constexpr uint32_t OBJECT_SET = 3;    // Object buffer of the GPU-driven path
+
+    // Fragment-stage push constant following PushConstantData in bindless mode
+    constexpr uint32_t BINDLESS_TEXTURE_INDEX_OFFSET = sizeof(PushConstantData);
+
+    // Everything needed to record one draw, captured when the draw is issued
+    struct DrawCommand
+    {
+        VkPipeline pipeline;
+        VkPipelineLayout pipelineLayout;
+        VkPushConstantRange pushConstantRange;  // Of the pipeline layout, zero size without push constants
+        RenderState renderState;
+        VkDescriptorSet descriptorSet;  // Null in bindless mode
+        VkDescriptorSet bindlessSet;    // Null unless in bindless mode
+        uint32_t textureIndex;
+        VkDescriptorSet uniformSet;     // Null when the shader has no uniforms set
+        uint32_t uniformOffset;
+        PushConstantData pushConstants;
+        VkBuffer vertexBuffer;
+        VkBuffer indexBuffer;
+        VkIndexType indexType;
+        VkBuffer instanceBuffer;        // Null without per-instance attributes
+        uint32_t count;
+        uint32_t first;
+        uint32_t instanceCount;
+        bool indexed;
+
+        // GPU-driven draws: up to count indexed draws read from indirectBuffer, the number
+        // written by the culling pass is read from indirectCountBuffer
+        VkDescriptorSet objectSet;
+        VkBuffer indirectBuffer;
+        VkBuffer indirectCountBuffer;
+    };
+
+    // State bound in a command buffer, used to skip redundant binds
+    struct CommandBindState
+    {
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        VkDescriptorSet bindlessSet = VK_NULL_HANDLE;
+        uint32_t textureIndex = 0;
+        bool textureIndexValid = false;
+        VkDescriptorSet uniformSet = VK_NULL_HANDLE;
+        uint32_t uniformOffset = 0;
+        VkDescriptorSet objectSet = VK_NULL_HANDLE;
+        VkBuffer vertexBuffer = VK_NULL_HANDLE;
+        VkBuffer instanceBuffer = VK_NULL_HANDLE;
+        VkBuffer indexBuffer = VK_NULL_HANDLE;
+        PushConstantData pushConstants;
+        bool pushConstantsValid = false;
+        RenderState renderState;
+        bool renderStateValid = false;  // Dynamic state is not inherited by secondaries
+    };
+
+    // Record a single draw, binding only the state that changed since the previous one
+    void recordDrawCommand(VkCommandBuffer commandBuffer,
+                           const DynamicStateFunctions& dynamicState,
+                           const DrawCommand& draw,
+                           CommandBindState& state);
+
+    // Records slices of a pass's draw list into secondary command buffers on worker threads
+    // Each worker owns one command pool per frame in flight, reset in beginFrame() once the
+    // frame that used it has completed on the GPU. Every pass of a frame records into its
+    // own secondaries from that pool, so later passes never overwrite earlier ones.
+    class ParallelRecorder
+    {
+    public:
+        ParallelRecorder(VkDevice device, uint32_t queueFamilyIndex,
+                         uint32_t threadCount, uint32_t framesInFlight,
+                         const DynamicStateFunctions& dynamicState);
+        ~ParallelRecorder();
+
+        ParallelRecorder(const ParallelRecorder&) = delete;
+        ParallelRecorder& operator=(const ParallelRecorder&) = delete;
+
+        // Resets the workers' pools of the frame slot, its previous frame must have completed
+        void beginFrame(uint32_t frameIndex);
+
+        // Record draws into secondary command buffers, returned in draw order
+        // Blocks until every worker has finished its slice
+        void record(uint32_t frameIndex,
+                    const std::vector<DrawCommand>& draws,
+                    const VkCommandBufferInheritanceInfo& inheritanceInfo,
+                    const VkViewport& viewport,
+                    const VkRect2D& scissor,
+                    std::vector<VkCommandBuffer>& outCommandBuffers);
+
+        uint32_t getThreadCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+    private:
+        struct ThreadFrameData
+        {
+            VkCommandPool commandPool = VK_NULL_HANDLE;
+            std::vector<VkCommandBuffer> commandBuffers;  // Grown on demand, reused every frame
+            uint32_t usedCount = 0;                       // Handed out since the pool was reset
+        };
+
+        void workerLoop(uint32_t threadIndex);
+        void recordSlice(uint32_t threadIndex);
+
+        VkDevice m_device;
+        DynamicStateFunctions m_dynamicState;
+        std::vector<std::thread> m_workers;
+        std::vector<std::vector<ThreadFrameData>> m_threadData; // [thread][frame]
+
+        // Current job, only valid while record() is waiting on the workers
+        uint32_t m_frameIndex;
+        const std::vector<DrawCommand>* m_draws;
+        const VkCommandBufferInheritanceInfo* m_inheritanceInfo;
+        VkViewport m_viewport;
+        VkRect2D m_scissor;
+        uint32_t m_sliceCount;
+        uint32_t m_sliceSize;
+        std::vector<VkCommandBuffer> m_results;
+
+        std::mutex m_mutex;
+        std::condition_variable m_workCondition;
+        std::condition_variable m_doneCondition;
+        uint64_t m_jobGeneration;
+        uint32_t m_pendingWorkers;
+        bool m_stop;
+
+        // Below this many draws per slice, threading overhead outweighs the gain
+        static constexpr uint32_t MIN_DRAWS_PER_SLICE = 64;
+    };
+
+} // namespace VK
@@ -0,0 +1,229 @@
+#include "PipelineCache.h"
+#include "../Logger.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <vector>
+
+namespace VK
+{
+
+PipelineCache::PipelineCache(VkDevice device, VkPhysicalDevice physicalDevice, bool creationFeedbackSupported)
+    : m_device(device)
+    , m_cache(VK_NULL_HANDLE)
+    , m_properties{}
+    , m_creationFeedbackSupported(creationFeedbackSupported)
+    , m_hits(0)
+    , m_misses(0)
+    , m_unclassified(0)
+    , m_hitMilliseconds(0.0)
+    , m_missMilliseconds(0.0)
+    , m_unclassifiedMilliseconds(0.0)
+{
+    vkGetPhysicalDeviceProperties(physicalDevice, &m_properties);
+
+    std::ostringstream path;
+    path << "vk_pipeline_cache_" << std::hex << std::setfill('0')
+         << std::setw(4) << m_properties.vendorID << "_"
+         << std::setw(4) << m_properties.deviceID << "_";
+    for (uint32_t i = 0; i < VK_UUID_SIZE; i++)
+    {
+        path << std::setw(2) << static_cast<uint32_t>(m_properties.pipelineCacheUUID[i]);
+    }
+    path << ".bin";
+    m_filePath = path.str();
+
+    std::string initialData;
+    bool loaded = loadInitialData(initialData);
+
+    VkPipelineCacheCreateInfo cacheInfo{};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.initialDataSize = loaded ? initialData.size() : 0;
+    cacheInfo.pInitialData = loaded ? initialData.data() : nullptr;
+
+    if (vkCreatePipelineCache(m_device, &cacheInfo, nullptr, &m_cache) != VK_SUCCESS)
+    {
+        // Drivers may still reject data that passed the header check, start empty
+        cacheInfo.initialDataSize = 0;
+        cacheInfo.pInitialData = nullptr;
+        loaded = false;
+
+        if (vkCreatePipelineCache(m_device, &cacheInfo, nullptr, &m_cache) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create pipeline cache");
+        }
+    }
+
+    if (loaded)
+    {
+        LOG_INFO("[Vulkan] Pipeline cache loaded from {} ({} bytes)", m_filePath, initialData.size());
+    }
+    else
+    {
+        LOG_INFO("[Vulkan] Pipeline cache created empty ({})", m_filePath);
+    }
+}
+
+PipelineCache::~PipelineCache()
+{
+    if (m_cache != VK_NULL_HANDLE)
+    {
+        save();
+        logStatistics();
+
+        vkDestroyPipelineCache(m_device, m_cache, nullptr);
+        m_cache = VK_NULL_HANDLE;
+    }
+}
+
+bool PipelineCache::loadInitialData(std::string& data) const
+{
+    std::ifstream file(m_filePath, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    // Validate the header ourselves, not every driver handles foreign data gracefully
+    VkPipelineCacheHeaderVersionOne header{};
+    if (data.size() < sizeof(header))
+    {
+        LOG_WARNING("[Vulkan] Ignoring truncated pipeline cache file {}", m_filePath);
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    if (header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+        header.vendorID != m_properties.vendorID ||
+        header.deviceID != m_properties.deviceID ||
+        std::memcmp(header.pipelineCacheUUID, m_properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+    {
+        LOG_WARNING("[Vulkan] Ignoring pipeline cache file {} from another device or driver", m_filePath);
+        return false;
+    }
+
+    return true;
+}
+
+VkPipeline PipelineCache::createGraphicsPipeline(const VkGraphicsPipelineCreateInfo& pipelineInfo)
+{
+    VkGraphicsPipelineCreateInfo createInfo = pipelineInfo;
+
+    VkPipelineCreationFeedbackEXT pipelineFeedback{};
+    VkPipelineCreationFeedbackCreateInfoEXT feedbackInfo{};
+    if (m_creationFeedbackSupported)
+    {
+        feedbackInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT;
+        feedbackInfo.pNext = createInfo.pNext;
+        feedbackInfo.pPipelineCreationFeedback = &pipelineFeedback;
+        createInfo.pNext = &feedbackInfo;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    if (vkCreateGraphicsPipelines(m_device, m_cache, 1, &createInfo, nullptr, &pipeline) != VK_SUCCESS)
+    {
+        return VK_NULL_HANDLE;
+    }
+
+    double milliseconds = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    if (m_creationFeedbackSupported && (pipelineFeedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT))
+    {
+        if (pipelineFeedback.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT)
+        {
+            m_hits++;
+            m_hitMilliseconds += milliseconds;
+            LOG_DEBUG("[Vulkan] Pipeline cache hit: {} ms", milliseconds);
+        }
+        else
+        {
+            m_misses++;
+            m_missMilliseconds += milliseconds;
+            LOG_DEBUG("[Vulkan] Pipeline cache miss: {} ms", milliseconds);
+        }
+    }
+    else
+    {
+        m_unclassified++;
+        m_unclassifiedMilliseconds += milliseconds;
+        LOG_DEBUG("[Vulkan] Pipeline created in {} ms", milliseconds);
+    }
+
+    return pipeline;
+}
+
+void PipelineCache::save()
+{
+    size_t dataSize = 0;
+    if (vkGetPipelineCacheData(m_device, m_cache, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0)
+    {
+        return;
+    }
+
+    std::vector<char> data(dataSize);
+    if (vkGetPipelineCacheData(m_device, m_cache, &dataSize, data.data()) != VK_SUCCESS)
+    {
+        LOG_WARNING("[Vulkan] Failed to read pipeline cache data");
+        return;
+    }
+
+    // Written next to the cache file and renamed over it, so an interrupted save
+    // leaves the previous cache intact instead of a truncated one
+    std::string tempPath = m_filePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            LOG_WARNING("[Vulkan] Failed to write pipeline cache file {}", tempPath);
+            return;
+        }
+
+        file.write(data.data(), static_cast<std::streamsize>(dataSize));
+        file.close();
+        if (file.fail())
+        {
+            LOG_WARNING("[Vulkan] Failed to write pipeline cache file {}", tempPath);
+            std::error_code removeError;
+            std::filesystem::remove(tempPath, removeError);
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, m_filePath, error);
+    if (error)
+    {
+        LOG_WARNING("[Vulkan] Failed to replace pipeline cache file {}: {}", m_filePath, error.message());
+        std::filesystem::remove(tempPath, error);
+        return;
+    }
+
+    LOG_INFO("[Vulkan] Pipeline cache saved to {} ({} bytes)", m_filePath, dataSize);
+}
+
+void PipelineCache::logStatistics() const
+{
+    if (m_hits + m_misses > 0)
+    {
+        LOG_INFO("[Vulkan] Pipeline cache: {} hits ({} ms), {} misses ({} ms)",
+                 m_hits, m_hitMilliseconds, m_misses, m_missMilliseconds);
+    }
+
+    if (m_unclassified > 0)
+    {
+        LOG_INFO("[Vulkan] Pipeline cache: {} pipelines created in {} ms", m_unclassified, m_unclassifiedMilliseconds);
+    }
+}
+
+} // namespace VK
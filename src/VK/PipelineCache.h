@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <string>
+#include <mutex>
+#include <cstdint>
+
+namespace VK
+{
+    // VkPipelineCache persisted between runs
+    // The file name is keyed by vendor, device and driver UUID so a driver update
+    // or a different GPU starts from an empty cache instead of rejected data.
+    class PipelineCache
+    {
+    public:
+        PipelineCache(VkDevice device, VkPhysicalDevice physicalDevice, bool creationFeedbackSupported);
+        ~PipelineCache();
+
+        PipelineCache(const PipelineCache&) = delete;
+        PipelineCache& operator=(const PipelineCache&) = delete;
+
+        // vkCreateGraphicsPipelines through the cache, timed and classified as hit or miss
+        // Thread safe, the VkPipelineCache is internally synchronized
+        VkPipeline createGraphicsPipeline(const VkGraphicsPipelineCreateInfo& pipelineInfo);
+
+        // Write the cache contents back to disk
+        void save();
+
+        VkPipelineCache getHandle() const { return m_cache; }
+
+    private:
+        bool loadInitialData(std::string& data) const;
+        void logStatistics() const;
+
+        VkDevice m_device;
+        VkPipelineCache m_cache;
+        VkPhysicalDeviceProperties m_properties;
+        std::string m_filePath;
+        bool m_creationFeedbackSupported;
+
+        // Without VK_EXT_pipeline_creation_feedback pipelines are only timed
+        std::mutex m_statsMutex;
+        uint32_t m_hits;
+        uint32_t m_misses;
+        uint32_t m_unclassified;
+        double m_hitMilliseconds;
+        double m_missMilliseconds;
+        double m_unclassifiedMilliseconds;
+    };
+
+} // namespace VK
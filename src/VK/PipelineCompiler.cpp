@@ -0,0 +1,97 @@
+#include "PipelineCompiler.h"
+#include "../Logger.h"
+
+namespace VK
+{
+
+PipelineCompiler::PipelineCompiler(uint32_t threadCount, CreateFunction createFunction)
+    : m_createFunction(std::move(createFunction))
+    , m_activeJobs(0)
+    , m_stop(false)
+{
+    if (threadCount == 0)
+    {
+        threadCount = 1;
+    }
+
+    for (uint32_t t = 0; t < threadCount; t++)
+    {
+        m_workers.emplace_back(&PipelineCompiler::workerLoop, this);
+    }
+
+    LOG_INFO("[Vulkan] Pipeline compiler started with {} threads", threadCount);
+}
+
+PipelineCompiler::~PipelineCompiler()
+{
+    // Queued jobs are finished first, their results are owned by the renderer
+    waitIdle();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_workCondition.notify_all();
+
+    for (std::thread& worker : m_workers)
+    {
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+}
+
+void PipelineCompiler::enqueue(const PipelineKey& key, CompiledPipeline* result)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(Job{key, result});
+    }
+    m_workCondition.notify_one();
+}
+
+void PipelineCompiler::waitIdle()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idleCondition.wait(lock, [this]() { return m_jobs.empty() && m_activeJobs == 0; });
+}
+
+void PipelineCompiler::workerLoop()
+{
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_workCondition.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+
+            if (m_stop && m_jobs.empty())
+            {
+                return;
+            }
+
+            job = m_jobs.front();
+            m_jobs.pop_front();
+            m_activeJobs++;
+        }
+
+        VkPipeline pipeline = m_createFunction(job.key);
+
+        job.result->pipeline = pipeline;
+        job.result->status.store(pipeline != VK_NULL_HANDLE ? CompiledPipeline::Status::Ready
+                                                            : CompiledPipeline::Status::Failed,
+                                 std::memory_order_release);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_activeJobs--;
+            if (m_jobs.empty() && m_activeJobs == 0)
+            {
+                m_idleCondition.notify_all();
+            }
+        }
+    }
+}
+
+} // namespace VK
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "PipelineState.h"
+#include <vulkan/vulkan.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+namespace VK
+{
+    // Result of a pipeline compilation, status is published by the worker with
+    // release semantics so the render thread can poll it without locking
+    struct CompiledPipeline
+    {
+        enum class Status : uint32_t { Pending, Ready, Failed };
+
+        std::atomic<Status> status{Status::Pending};
+        VkPipeline pipeline = VK_NULL_HANDLE;  // Only read once status is Ready
+        VkPipeline fallback = VK_NULL_HANDLE;  // Drawn with while pending, may be null
+    };
+
+    // Worker pool creating graphics pipelines off the render thread
+    // Results must stay alive until their job has completed (see waitIdle()).
+    class PipelineCompiler
+    {
+    public:
+        using CreateFunction = std::function<VkPipeline(const PipelineKey&)>;
+
+        PipelineCompiler(uint32_t threadCount, CreateFunction createFunction);
+        ~PipelineCompiler();
+
+        PipelineCompiler(const PipelineCompiler&) = delete;
+        PipelineCompiler& operator=(const PipelineCompiler&) = delete;
+
+        void enqueue(const PipelineKey& key, CompiledPipeline* result);
+
+        // Block until every queued job has completed
+        void waitIdle();
+
+        uint32_t getThreadCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+    private:
+        struct Job
+        {
+            PipelineKey key;
+            CompiledPipeline* result = nullptr;
+        };
+
+        void workerLoop();
+
+        CreateFunction m_createFunction;
+        std::vector<std::thread> m_workers;
+
+        std::mutex m_mutex;
+        std::condition_variable m_workCondition;
+        std::condition_variable m_idleCondition;
+        std::deque<Job> m_jobs;
+        uint32_t m_activeJobs;
+        bool m_stop;
+    };
+
+} // namespace VK
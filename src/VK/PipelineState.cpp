@@ -0,0 +1,99 @@
+#include "PipelineState.h"
+
+namespace VK
+{
+
+namespace
+{
+    // 64-bit FNV-1a, fed field by field so struct padding never contributes
+    constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+    constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+    void hashValue(uint64_t& hash, uint64_t value)
+    {
+        for (int i = 0; i < 8; i++)
+        {
+            hash ^= (value >> (i * 8)) & 0xFF;
+            hash *= FNV_PRIME;
+        }
+    }
+}
+
+void VertexInputLayout::computeHash()
+{
+    uint64_t h = FNV_OFFSET_BASIS;
+
+    hashValue(h, stride);
+    hashValue(h, instanceStride);
+    hashValue(h, attributeCount);
+    for (uint32_t i = 0; i < attributeCount; i++)
+    {
+        const VkVertexInputAttributeDescription& attribute = attributes[i];
+        hashValue(h, (static_cast<uint64_t>(attribute.location) << 32) | attribute.binding);
+        hashValue(h, (static_cast<uint64_t>(attribute.format) << 32) | attribute.offset);
+    }
+
+    hash = h;
+}
+
+bool VertexInputLayout::operator==(const VertexInputLayout& other) const
+{
+    if (hash != other.hash || stride != other.stride || instanceStride != other.instanceStride ||
+        attributeCount != other.attributeCount)
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < attributeCount; i++)
+    {
+        const VkVertexInputAttributeDescription& a = attributes[i];
+        const VkVertexInputAttributeDescription& b = other.attributes[i];
+        if (a.location != b.location || a.binding != b.binding ||
+            a.format != b.format || a.offset != b.offset)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void PipelineKey::computeHash()
+{
+    uint64_t h = FNV_OFFSET_BASIS;
+
+    hashValue(h, reinterpret_cast<uint64_t>(vertexModule));
+    hashValue(h, reinterpret_cast<uint64_t>(fragmentModule));
+    hashValue(h, reinterpret_cast<uint64_t>(renderPass));
+    hashValue(h, static_cast<uint64_t>(colorFormat));
+    hashValue(h, static_cast<uint64_t>(depthFormat));
+    hashValue(h, reinterpret_cast<uint64_t>(pipelineLayout));
+    hashValue(h, static_cast<uint64_t>(topology));
+
+    hashValue(h, (renderState.depthTest ? 1u : 0u) |
+                 (renderState.depthWrite ? 2u : 0u) |
+                 (renderState.blend ? 4u : 0u));
+    hashValue(h, static_cast<uint64_t>(renderState.cullMode));
+    hashValue(h, static_cast<uint64_t>(renderState.frontFace));
+
+    // Precomputed by the owner of the layout, keeps per-draw hashing constant
+    hashValue(h, vertexInput.hash);
+
+    hash = h;
+}
+
+bool PipelineKey::operator==(const PipelineKey& other) const
+{
+    return hash == other.hash &&
+           vertexModule == other.vertexModule &&
+           fragmentModule == other.fragmentModule &&
+           renderPass == other.renderPass &&
+           colorFormat == other.colorFormat &&
+           depthFormat == other.depthFormat &&
+           pipelineLayout == other.pipelineLayout &&
+           topology == other.topology &&
+           renderState == other.renderState &&
+           vertexInput == other.vertexInput;
+}
+
+} // namespace VK
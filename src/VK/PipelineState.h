@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <array>
+#include <cstdint>
+
+namespace VK
+{
+    // Fixed-function state toggled through IRenderer::enable*()
+    struct RenderState
+    {
+        bool depthTest = true;
+        bool depthWrite = true;
+        bool blend = false;
+        VkCullModeFlags cullMode = VK_CULL_MODE_NONE;
+        VkFrontFace frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;  // OpenGL convention (after Y-axis flip)
+
+        bool operator==(const RenderState& other) const
+        {
+            return depthTest == other.depthTest && depthWrite == other.depthWrite &&
+                   blend == other.blend && cullMode == other.cullMode && frontFace == other.frontFace;
+        }
+        bool operator!=(const RenderState& other) const { return !(*this == other); }
+    };
+
+    // Vertex input of a pipeline: an interleaved per-vertex binding, plus a per-instance
+    // binding when some attributes step once per instance
+    // Built once per vertex array, computeHash() must be called after changing it
+    struct VertexInputLayout
+    {
+        static constexpr uint32_t MAX_ATTRIBUTES = 16;
+        static constexpr uint32_t VERTEX_BINDING = 0;
+        static constexpr uint32_t INSTANCE_BINDING = 1;
+
+        uint32_t stride = 0;
+        uint32_t instanceStride = 0;  // 0 without per-instance attributes
+        uint32_t attributeCount = 0;
+        std::array<VkVertexInputAttributeDescription, MAX_ATTRIBUTES> attributes{};
+        uint64_t hash = 0;
+
+        void computeHash();
+
+        bool operator==(const VertexInputLayout& other) const;
+        bool operator!=(const VertexInputLayout& other) const { return !(*this == other); }
+    };
+
+    // Everything a graphics pipeline is created from, used as the key of the
+    // renderer's pipeline map. computeHash() must be called after filling it in.
+    struct PipelineKey
+    {
+        VkShaderModule vertexModule = VK_NULL_HANDLE;
+        VkShaderModule fragmentModule = VK_NULL_HANDLE;
+        VkRenderPass renderPass = VK_NULL_HANDLE;  // Null with dynamic rendering
+        VkFormat colorFormat = VK_FORMAT_UNDEFINED;
+        VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+        VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        RenderState renderState;  // Only the state that isn't set dynamically
+        VertexInputLayout vertexInput;
+        uint64_t hash = 0;
+
+        void computeHash();
+
+        bool operator==(const PipelineKey& other) const;
+    };
+
+    // Pipeline layout of a shader program with the push constant range it was created from
+    struct ShaderLayout
+    {
+        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+        VkPushConstantRange pushConstantRange{};  // Zero size without push constants
+    };
+
+    struct PipelineKeyHash
+    {
+        size_t operator()(const PipelineKey& key) const { return static_cast<size_t>(key.hash); }
+    };
+
+} // namespace VK
@@ -3,12 +3,16 @@
 #include "Texture.h"
 #include "ShaderManager.h"
 #include "ShaderProgram.h"
+#include "ComputeProgram.h"
+#include "StorageBuffer.h"
 #include "../Logger.h"
 #include <stdexcept>
 #include <set>
 #include <algorithm>
 #include <fstream>
 #include <array>
+#include <cstring>
+#include <thread>
 
 namespace VK
 {
@@ -20,6 +24,18 @@ struct Vertex {
     float texCoord[2];
 };
 
+static const char* presentModeName(VkPresentModeKHR mode)
+{
+    switch (mode)
+    {
+        case VK_PRESENT_MODE_IMMEDIATE_KHR:    return "immediate";
+        case VK_PRESENT_MODE_MAILBOX_KHR:      return "mailbox";
+        case VK_PRESENT_MODE_FIFO_KHR:         return "FIFO";
+        case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return "FIFO relaxed";
+        default:                               return "unknown";
+    }
+}
+
 Renderer::Renderer()
     : m_window(nullptr)
     , m_clearColor(0.0f, 0.0f, 0.0f, 1.0f)
@@ -27,17 +43,43 @@ Renderer::Renderer()
     , m_surface(VK_NULL_HANDLE)
     , m_physicalDevice(VK_NULL_HANDLE)
     , m_device(VK_NULL_HANDLE)
+    , m_pipelineCreationFeedbackSupported(false)
     , m_graphicsQueue(VK_NULL_HANDLE)
     , m_presentQueue(VK_NULL_HANDLE)
+    , m_transferQueue(VK_NULL_HANDLE)
     , m_swapChain(VK_NULL_HANDLE)
+    , m_headless(false)
+    , m_readbackEnabled(false)
+    , m_frameRendered(false)
+    , m_dynamicRendering(false)
+    , m_cmdBeginRendering(nullptr)
+    , m_cmdEndRendering(nullptr)
     , m_renderPass(VK_NULL_HANDLE)
+    , m_loadRenderPass(VK_NULL_HANDLE)
     , m_descriptorSetLayout(VK_NULL_HANDLE)
-    , m_pipelineLayout(VK_NULL_HANDLE)
-    , m_descriptorPool(VK_NULL_HANDLE)
+    , m_bindlessSupported(false)
+    , m_bindlessEnabled(false)
+    , m_bindlessCapacity(0)
+    , m_bindlessSetLayout(VK_NULL_HANDLE)
+    , m_bindlessPool(VK_NULL_HANDLE)
+    , m_bindlessSet(VK_NULL_HANDLE)
+    , m_nextBindlessIndex(0)
+    , m_uniformSetLayout(VK_NULL_HANDLE)
+    , m_lastUniformShader(nullptr)
+    , m_lastUniformVersion(0)
+    , m_lastUniformBlock{}
+    , m_objectSetLayout(VK_NULL_HANDLE)
+    , m_gpuDrivenSupported(false)
+    , m_gpuCulledFrame(0)
+    , m_computeFrame(0)
     , m_commandPool(VK_NULL_HANDLE)
     , m_transferCommandPool(VK_NULL_HANDLE)
+    , m_uploadTimeline(VK_NULL_HANDLE)
+    , m_uploadValue(0)
+    , m_uploadWaitValue(0)
+    , m_uploadBatchDepth(0)
     , m_depthImage(VK_NULL_HANDLE)
-    , m_depthImageMemory(VK_NULL_HANDLE)
+    , m_depthAllocation{}
     , m_depthImageView(VK_NULL_HANDLE)
     , m_depthFormat(VK_FORMAT_UNDEFINED)
     , m_vertexBuffer(VK_NULL_HANDLE)
@@ -46,14 +88,42 @@ Renderer::Renderer()
     , m_shaderManager(nullptr)
     , m_currentShader(nullptr)
     , m_currentTexture(nullptr)
+    , m_frameTimeline(VK_NULL_HANDLE)
+    , m_frameNumber(0)
+    , m_framesInFlight(2)
     , m_currentFrame(0)
     , m_imageIndex(0)
     , m_framebufferResized(false)
+    , m_swapChainRecreatePending(false)
     , m_frameBegun(false)
-    , m_cullingEnabled(false)
-    , m_depthTestEnabled(true)
+    , m_passBegun(false)
+    , m_passCleared(false)
+    , m_clearPending(false)
+    , m_presentMode(PresentMode::Mailbox)
+    , m_swapchainImageCount(0)
+    , m_presentSettingsChanged(false)
+    , m_frameInterval(0)
+    , m_presentTimingValid(false)
+    , m_passRecordsSecondaries(false)
+    , m_passViewport{}
+    , m_passScissor{}
+    , m_passZoneDepth(0)
+    , m_ignoredGpuZones(0)
+    , m_framePassCount(0)
+    , m_pipelineStatisticsSupported(false)
+    , m_inheritedQueriesSupported(false)
+    , m_pipelineStatisticsEnabled(false)
+    , m_recordingThreadCount(0)
 {
     // Clear color should be set by Application class via setClearColor()
+
+    // Layout of the built-in Vertex struct, used until a vertex array describes its own
+    m_defaultVertexInput.stride = sizeof(Vertex);
+    m_defaultVertexInput.attributeCount = 3;
+    m_defaultVertexInput.attributes[0] = {0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, pos)};
+    m_defaultVertexInput.attributes[1] = {1, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, color)};
+    m_defaultVertexInput.attributes[2] = {2, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, texCoord)};
+    m_defaultVertexInput.computeHash();
 }
 
 Renderer::~Renderer()
@@ -63,34 +133,84 @@ Renderer::~Renderer()
 
 void Renderer::initialize()
 {
-    LOG_WARNING("[Vulkan] Warning: initialize() called without window handle");
-    LOG_WARNING("[Vulkan] Please call initialize(GLFWwindow*) instead");
+    LOG_INFO("[Vulkan] initialize() called without window handle, rendering headless");
+    initializeHeadless(DEFAULT_HEADLESS_WIDTH, DEFAULT_HEADLESS_HEIGHT);
 }
 
 void Renderer::initialize(GLFWwindow* window)
 {
     m_window = window;
+    m_headless = false;
 
     LOG_INFO("[Vulkan] Initializing Vulkan renderer...");
+    initializeRenderer();
+}
+
+void Renderer::initializeHeadless(uint32_t width, uint32_t height)
+{
+    if (width == 0 || height == 0)
+    {
+        throw std::runtime_error("Headless render target size must not be zero");
+    }
+
+    m_window = nullptr;
+    m_headless = true;
+    m_swapChainExtent = {width, height};
 
+    LOG_INFO("[Vulkan] Initializing headless Vulkan renderer ({}x{})...", width, height);
+    initializeRenderer();
+}
+
+void Renderer::initializeRenderer()
+{
     createInstance();
-    createSurface();
+    if (!m_headless)
+    {
+        createSurface();
+    }
     pickPhysicalDevice();
     createLogicalDevice();
-    createSwapChain();
+    if (m_headless)
+    {
+        createOffscreenTargets();
+    }
+    else
+    {
+        createSwapChain();
+    }
     createImageViews();
-    createRenderPass();
+    if (!m_dynamicRendering)
+    {
+        createRenderPass();
+    }
     createDescriptorSetLayout();
     createPipelineLayout();
-    createDescriptorPool();
+    createDescriptorAllocator();
+    createBindlessResources();
+    createUniformRing();
     // Pipeline creation removed - will be created dynamically when shaders are loaded
     createDepthResources();
-    createFramebuffers();
+    if (!m_dynamicRendering)
+    {
+        createFramebuffers();
+    }
     createCommandPool();
     createTransferCommandPool();
     //initializeVertexBuffer();
     createCommandBuffers();
     createSyncObjects();
+    createGpuProfiler();
+    createGpuCulling();
+
+    if (m_headless && m_readbackEnabled)
+    {
+        createReadbackBuffers();
+    }
+
+    if (m_recordingThreadCount > 1)
+    {
+        setRecordingThreadCount(m_recordingThreadCount);
+    }
 
     // Initialize shader manager with device and renderer pointer
     if (m_shaderManager)
@@ -110,7 +230,20 @@ void Renderer::shutdown()
     {
         vkDeviceWaitIdle(m_device);
 
+        // Every frame has completed, so all deferred resources can go now,
+        // including those queued for a frame that was never submitted
+        releaseRetiredSwapChains();
+        processDeferredDeletions(UINT64_MAX);
+        destroyAllPipelines();
+        m_pipelineCompiler.reset();
+
+        // Worker command pools must go before the device
+        m_parallelRecorder.reset();
+        m_gpuProfiler.reset();
+        m_gpuCulling.reset();
+
         cleanupSwapChain();
+        destroyReadbackBuffers();
 
         if (m_vertexBuffer != VK_NULL_HANDLE)
         {
@@ -142,14 +275,11 @@ void Renderer::shutdown()
         }
         m_imageAvailableSemaphores.clear();
 
-        for (size_t i = 0; i < m_inFlightFences.size(); i++)
+        if (m_frameTimeline != VK_NULL_HANDLE)
         {
-            if (m_inFlightFences[i] != VK_NULL_HANDLE)
-            {
-                vkDestroyFence(m_device, m_inFlightFences[i], nullptr);
-            }
+            vkDestroySemaphore(m_device, m_frameTimeline, nullptr);
+            m_frameTimeline = VK_NULL_HANDLE;
         }
-        m_inFlightFences.clear();
 
         cleanupTransferCommandPool();
 
@@ -160,17 +290,21 @@ void Renderer::shutdown()
         }
 
         // Destroy descriptor resources (not destroyed in cleanupSwapChain)
-        if (m_descriptorPool != VK_NULL_HANDLE)
+        m_uniformRing.reset();
+        m_descriptorAllocator.reset();
+
+        if (m_bindlessPool != VK_NULL_HANDLE)
         {
-            vkDestroyDescriptorPool(m_device, m_descriptorPool, nullptr);
-            m_descriptorPool = VK_NULL_HANDLE;
+            vkDestroyDescriptorPool(m_device, m_bindlessPool, nullptr);
+            m_bindlessPool = VK_NULL_HANDLE;
+            m_bindlessSet = VK_NULL_HANDLE;
         }
 
-        if (m_pipelineLayout != VK_NULL_HANDLE)
+        for (const auto& [range, layout] : m_pipelineLayouts)
         {
-            vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr);
-            m_pipelineLayout = VK_NULL_HANDLE;
+            vkDestroyPipelineLayout(m_device, layout, nullptr);
         }
+        m_pipelineLayouts.clear();
 
         if (m_descriptorSetLayout != VK_NULL_HANDLE)
         {
@@ -178,10 +312,31 @@ void Renderer::shutdown()
             m_descriptorSetLayout = VK_NULL_HANDLE;
         }
 
+        if (m_bindlessSetLayout != VK_NULL_HANDLE)
+        {
+            vkDestroyDescriptorSetLayout(m_device, m_bindlessSetLayout, nullptr);
+            m_bindlessSetLayout = VK_NULL_HANDLE;
+        }
+
+        if (m_uniformSetLayout != VK_NULL_HANDLE)
+        {
+            vkDestroyDescriptorSetLayout(m_device, m_uniformSetLayout, nullptr);
+            m_uniformSetLayout = VK_NULL_HANDLE;
+        }
+
+        if (m_objectSetLayout != VK_NULL_HANDLE)
+        {
+            vkDestroyDescriptorSetLayout(m_device, m_objectSetLayout, nullptr);
+            m_objectSetLayout = VK_NULL_HANDLE;
+        }
+
         // Clear vectors to prevent double-cleanup
         m_commandBuffers.clear();
         m_swapChainImages.clear();
 
+        // Writes the pipeline cache back to disk
+        m_pipelineCache.reset();
+
         // Cleanup memory allocator
         m_memoryAllocator.reset();
 
@@ -220,13 +375,18 @@ void Renderer::createInstance()
     appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
     appInfo.pEngineName = "No Engine";
     appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-    appInfo.apiVersion = VK_API_VERSION_1_0;
+    // Vulkan 1.3 for core extended dynamic state and dynamic rendering, 1.2 devices
+    // (the minimum, for timeline semaphores) fall back to the extensions
+    appInfo.apiVersion = VK_API_VERSION_1_3;
 
-    // Get required extensions
-    uint32_t glfwExtensionCount = 0;
-    const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-
-    std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+    // Get required extensions, headless rendering needs no surface extensions
+    std::vector<const char*> extensions;
+    if (!m_headless)
+    {
+        uint32_t glfwExtensionCount = 0;
+        const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+        extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+    }
 
     // Add validation layer extensions
     auto validationExtensions = m_validationLayers.getRequiredExtensions();
@@ -314,9 +474,10 @@ void Renderer::pickPhysicalDevice()
 void Renderer::createLogicalDevice()
 {
     QueueFamilyIndices indices = findQueueFamilies(m_physicalDevice);
+    m_queueFamilyIndices = indices;
 
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-    std::set<uint32_t> uniqueQueueFamilies = {indices.graphicsFamily, indices.presentFamily};
+    std::set<uint32_t> uniqueQueueFamilies = {indices.graphicsFamily, indices.presentFamily, indices.transferFamily};
 
     float queuePriority = 1.0f;
     for (uint32_t queueFamily : uniqueQueueFamilies)
@@ -329,15 +490,181 @@ void Renderer::createLogicalDevice()
         queueCreateInfos.push_back(queueCreateInfo);
     }
 
-    VkPhysicalDeviceFeatures deviceFeatures{};
+    // Timeline semaphores drive frame pacing (checked in isDeviceSuitable)
+    VkPhysicalDeviceVulkan12Features features12{};
+    features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    features12.timelineSemaphore = VK_TRUE;
+
+    VkPhysicalDeviceFeatures2 deviceFeatures{};
+    deviceFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    deviceFeatures.pNext = &features12;
+
+    // Optional extensions, enabled when the device has them
+    std::vector<const char*> extensions = getRequiredDeviceExtensions();
+    m_pipelineCreationFeedbackSupported =
+        isDeviceExtensionSupported(m_physicalDevice, VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+    if (m_pipelineCreationFeedbackSupported)
+    {
+        extensions.push_back(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+    }
+
+    // Extended dynamic state is core in Vulkan 1.3, older devices may have the extension
+    // Blend enable is only dynamic with VK_EXT_extended_dynamic_state3
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+    bool coreDynamicState = properties.apiVersion >= VK_API_VERSION_1_3;
+    bool extDynamicState = !coreDynamicState &&
+        isDeviceExtensionSupported(m_physicalDevice, VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME);
+    bool extDynamicState3 =
+        isDeviceExtensionSupported(m_physicalDevice, VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME);
+
+    // Dynamic rendering is core in Vulkan 1.3 as well
+    bool coreDynamicRendering = properties.apiVersion >= VK_API_VERSION_1_3;
+    bool extDynamicRendering = !coreDynamicRendering &&
+        isDeviceExtensionSupported(m_physicalDevice, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+
+    // Only structures of supported extensions may be chained into the query
+    VkPhysicalDeviceVulkan12Features supported12{};
+    supported12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    VkPhysicalDeviceExtendedDynamicStateFeaturesEXT supportedDynamicState{};
+    supportedDynamicState.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT;
+    VkPhysicalDeviceExtendedDynamicState3FeaturesEXT supportedDynamicState3{};
+    supportedDynamicState3.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT;
+    VkPhysicalDeviceVulkan13Features supported13{};
+    supported13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR supportedDynamicRendering{};
+    supportedDynamicRendering.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+
+    VkPhysicalDeviceFeatures2 supportedFeatures{};
+    supportedFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    supportedFeatures.pNext = &supported12;
+    if (extDynamicState)
+    {
+        supportedDynamicState.pNext = supportedFeatures.pNext;
+        supportedFeatures.pNext = &supportedDynamicState;
+    }
+    if (extDynamicState3)
+    {
+        supportedDynamicState3.pNext = supportedFeatures.pNext;
+        supportedFeatures.pNext = &supportedDynamicState3;
+    }
+    if (coreDynamicRendering)
+    {
+        supported13.pNext = supportedFeatures.pNext;
+        supportedFeatures.pNext = &supported13;
+    }
+    if (extDynamicRendering)
+    {
+        supportedDynamicRendering.pNext = supportedFeatures.pNext;
+        supportedFeatures.pNext = &supportedDynamicRendering;
+    }
+    vkGetPhysicalDeviceFeatures2(m_physicalDevice, &supportedFeatures);
+    extDynamicState = extDynamicState && supportedDynamicState.extendedDynamicState == VK_TRUE;
+    extDynamicState3 = extDynamicState3 && supportedDynamicState3.extendedDynamicState3ColorBlendEnable == VK_TRUE;
+    coreDynamicRendering = coreDynamicRendering && supported13.dynamicRendering == VK_TRUE;
+    extDynamicRendering = extDynamicRendering && supportedDynamicRendering.dynamicRendering == VK_TRUE;
+
+    // Pipeline statistics queries for setPipelineStatisticsEnabled()
+    m_pipelineStatisticsSupported = supportedFeatures.features.pipelineStatisticsQuery == VK_TRUE;
+    m_inheritedQueriesSupported = supportedFeatures.features.inheritedQueries == VK_TRUE;
+    deviceFeatures.features.pipelineStatisticsQuery = supportedFeatures.features.pipelineStatisticsQuery;
+    deviceFeatures.features.inheritedQueries = supportedFeatures.features.inheritedQueries;
+
+    // GPU-driven drawing: a count read from a buffer, many draws per call, and the object
+    // index passed as firstInstance
+    m_gpuDrivenSupported = supported12.drawIndirectCount == VK_TRUE &&
+                           supportedFeatures.features.multiDrawIndirect == VK_TRUE &&
+                           supportedFeatures.features.drawIndirectFirstInstance == VK_TRUE;
+    if (m_gpuDrivenSupported)
+    {
+        features12.drawIndirectCount = VK_TRUE;
+        deviceFeatures.features.multiDrawIndirect = VK_TRUE;
+        deviceFeatures.features.drawIndirectFirstInstance = VK_TRUE;
+    }
+
+    // Bindless textures use descriptor indexing (VK_EXT_descriptor_indexing, core in 1.2)
+    // The texture index follows the 192 bytes of matrices in the push constants
+    VkPhysicalDeviceVulkan12Properties properties12{};
+    properties12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+    VkPhysicalDeviceProperties2 properties2{};
+    properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties2.pNext = &properties12;
+    vkGetPhysicalDeviceProperties2(m_physicalDevice, &properties2);
+
+    m_bindlessSupported =
+        supported12.runtimeDescriptorArray == VK_TRUE &&
+        supported12.descriptorBindingPartiallyBound == VK_TRUE &&
+        supported12.descriptorBindingSampledImageUpdateAfterBind == VK_TRUE &&
+        supported12.descriptorBindingUpdateUnusedWhilePending == VK_TRUE &&
+        supported12.shaderSampledImageArrayNonUniformIndexing == VK_TRUE &&
+        properties.limits.maxPushConstantsSize >= BINDLESS_TEXTURE_INDEX_OFFSET + sizeof(uint32_t);
+    if (m_bindlessSupported)
+    {
+        features12.runtimeDescriptorArray = VK_TRUE;
+        features12.descriptorBindingPartiallyBound = VK_TRUE;
+        features12.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        features12.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+        features12.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+
+        // The limits count every set of the pipeline layout, and the fragment stage
+        // also samples the TEXTURE_SET combined image sampler
+        constexpr uint32_t otherSamplers = 1;
+        auto available = [otherSamplers](uint32_t limit) { return limit > otherSamplers ? limit - otherSamplers : 0u; };
+        m_bindlessCapacity = std::min({MAX_BINDLESS_TEXTURES,
+                                       available(properties12.maxDescriptorSetUpdateAfterBindSampledImages),
+                                       available(properties12.maxDescriptorSetUpdateAfterBindSamplers),
+                                       available(properties12.maxPerStageDescriptorUpdateAfterBindSampledImages),
+                                       available(properties12.maxPerStageDescriptorUpdateAfterBindSamplers)});
+        m_bindlessSupported = m_bindlessCapacity > 0;
+    }
+
+    VkPhysicalDeviceExtendedDynamicStateFeaturesEXT dynamicStateFeatures{};
+    dynamicStateFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT;
+    dynamicStateFeatures.extendedDynamicState = VK_TRUE;
+    VkPhysicalDeviceExtendedDynamicState3FeaturesEXT dynamicState3Features{};
+    dynamicState3Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT;
+    dynamicState3Features.extendedDynamicState3ColorBlendEnable = VK_TRUE;
+
+    if (extDynamicState)
+    {
+        extensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME);
+        dynamicStateFeatures.pNext = features12.pNext;
+        features12.pNext = &dynamicStateFeatures;
+    }
+    if (extDynamicState3)
+    {
+        extensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME);
+        dynamicState3Features.pNext = features12.pNext;
+        features12.pNext = &dynamicState3Features;
+    }
+
+    VkPhysicalDeviceVulkan13Features features13{};
+    features13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+    features13.dynamicRendering = VK_TRUE;
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures{};
+    dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+    dynamicRenderingFeatures.dynamicRendering = VK_TRUE;
+
+    if (coreDynamicRendering)
+    {
+        features13.pNext = features12.pNext;
+        features12.pNext = &features13;
+    }
+    if (extDynamicRendering)
+    {
+        extensions.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+        dynamicRenderingFeatures.pNext = features12.pNext;
+        features12.pNext = &dynamicRenderingFeatures;
+    }
 
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    createInfo.pNext = &deviceFeatures;
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
-    createInfo.pEnabledFeatures = &deviceFeatures;
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(m_deviceExtensions.size());
-    createInfo.ppEnabledExtensionNames = m_deviceExtensions.data();
+    createInfo.pEnabledFeatures = nullptr;
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+    createInfo.ppEnabledExtensionNames = extensions.data();
     createInfo.enabledLayerCount = 0;
 
     if (vkCreateDevice(m_physicalDevice, &createInfo, nullptr, &m_device) != VK_SUCCESS)
@@ -345,12 +672,42 @@ void Renderer::createLogicalDevice()
         throw std::runtime_error("Failed to create logical device");
     }
 
+    loadDynamicStateFunctions(coreDynamicState || extDynamicState, extDynamicState3);
+
+    if (coreDynamicRendering || extDynamicRendering)
+    {
+        m_cmdBeginRendering = reinterpret_cast<PFN_vkCmdBeginRenderingKHR>(
+            vkGetDeviceProcAddr(m_device, coreDynamicRendering ? "vkCmdBeginRendering" : "vkCmdBeginRenderingKHR"));
+        m_cmdEndRendering = reinterpret_cast<PFN_vkCmdEndRenderingKHR>(
+            vkGetDeviceProcAddr(m_device, coreDynamicRendering ? "vkCmdEndRendering" : "vkCmdEndRenderingKHR"));
+    }
+    m_dynamicRendering = m_cmdBeginRendering != nullptr && m_cmdEndRendering != nullptr;
+    LOG_INFO("[Vulkan] Dynamic rendering: {}", m_dynamicRendering ? "yes" : "no (render pass and framebuffers)");
+
     vkGetDeviceQueue(m_device, indices.graphicsFamily, 0, &m_graphicsQueue);
     vkGetDeviceQueue(m_device, indices.presentFamily, 0, &m_presentQueue);
+    vkGetDeviceQueue(m_device, indices.transferFamily, 0, &m_transferQueue);
+
+    if (indices.hasDedicatedTransfer())
+    {
+        LOG_INFO("[Vulkan] Using dedicated transfer queue family {}", indices.transferFamily);
+    }
+    else
+    {
+        LOG_INFO("[Vulkan] No dedicated transfer queue, uploads use the graphics queue");
+    }
 
     // Initialize memory allocator
     m_memoryAllocator = std::make_unique<MemoryAllocator>(m_device, m_physicalDevice);
 
+    // Pipelines compiled in previous runs are loaded from disk
+    m_pipelineCache = std::make_unique<PipelineCache>(m_device, m_physicalDevice, m_pipelineCreationFeedbackSupported);
+
+    // New pipelines are compiled in the background so shader loads don't hitch frames
+    uint32_t compilerThreads = std::max(1u, std::min(4u, std::thread::hardware_concurrency() / 2));
+    m_pipelineCompiler = std::make_unique<PipelineCompiler>(compilerThreads,
+        [this](const PipelineKey& key) { return createPipeline(key); });
+
     LOG_INFO("[Vulkan] Logical device created");
 }
 
@@ -362,11 +719,7 @@ void Renderer::createSwapChain()
     VkPresentModeKHR presentMode = chooseSwapPresentMode(swapChainSupport.presentModes);
     VkExtent2D extent = chooseSwapExtent(swapChainSupport.capabilities);
 
-    uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
-    if (swapChainSupport.capabilities.maxImageCount > 0 && imageCount > swapChainSupport.capabilities.maxImageCount)
-    {
-        imageCount = swapChainSupport.capabilities.maxImageCount;
-    }
+    uint32_t imageCount = chooseSwapImageCount(swapChainSupport.capabilities);
 
     VkSwapchainCreateInfoKHR createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
@@ -396,13 +749,21 @@ void Renderer::createSwapChain()
     createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
     createInfo.presentMode = presentMode;
     createInfo.clipped = VK_TRUE;
-    createInfo.oldSwapchain = VK_NULL_HANDLE;
+    createInfo.oldSwapchain = m_swapChain;
 
-    if (vkCreateSwapchainKHR(m_device, &createInfo, nullptr, &m_swapChain) != VK_SUCCESS)
+    VkSwapchainKHR swapChain = VK_NULL_HANDLE;
+    if (vkCreateSwapchainKHR(m_device, &createInfo, nullptr, &swapChain) != VK_SUCCESS)
     {
         throw std::runtime_error("Failed to create swap chain");
     }
 
+    // The old swapchain is retired by the new one, but its presents may still be pending
+    if (m_swapChain != VK_NULL_HANDLE)
+    {
+        m_retiredSwapChains.push_back(m_swapChain);
+    }
+    m_swapChain = swapChain;
+
     vkGetSwapchainImagesKHR(m_device, m_swapChain, &imageCount, nullptr);
     m_swapChainImages.resize(imageCount);
     vkGetSwapchainImagesKHR(m_device, m_swapChain, &imageCount, m_swapChainImages.data());
@@ -410,7 +771,46 @@ void Renderer::createSwapChain()
     m_swapChainImageFormat = surfaceFormat.format;
     m_swapChainExtent = extent;
 
-    LOG_INFO("[Vulkan] Swap chain created");
+    LOG_INFO("[Vulkan] Swap chain created ({} images, {} present)", imageCount, presentModeName(presentMode));
+}
+
+void Renderer::createOffscreenTargets()
+{
+    // One color target per frame slot so frames in flight don't render into the same image
+    m_swapChainImageFormat = VK_FORMAT_R8G8B8A8_UNORM;
+    m_swapChainImages.resize(MAX_FRAMES_IN_FLIGHT);
+    m_offscreenAllocations.resize(MAX_FRAMES_IN_FLIGHT);
+
+    for (size_t i = 0; i < m_swapChainImages.size(); i++)
+    {
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.extent.width = m_swapChainExtent.width;
+        imageInfo.extent.height = m_swapChainExtent.height;
+        imageInfo.extent.depth = 1;
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.format = m_swapChainImageFormat;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        if (vkCreateImage(m_device, &imageInfo, nullptr, &m_swapChainImages[i]) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create offscreen color image");
+        }
+
+        m_offscreenAllocations[i] = m_memoryAllocator->allocateImageMemory(m_swapChainImages[i],
+                                                                           VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        vkBindImageMemory(m_device, m_swapChainImages[i], m_offscreenAllocations[i].memory,
+                          m_offscreenAllocations[i].offset);
+    }
+
+    LOG_INFO("[Vulkan] Offscreen color targets created ({}x{}, {} images)",
+             m_swapChainExtent.width, m_swapChainExtent.height, m_swapChainImages.size());
 }
 
 void Renderer::createImageViews()
@@ -445,67 +845,80 @@ void Renderer::createImageViews()
 
 void Renderer::createRenderPass()
 {
-    // Color attachment
-    VkAttachmentDescription colorAttachment{};
-    colorAttachment.format = m_swapChainImageFormat;
-    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-    colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-    colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-    VkAttachmentReference colorAttachmentRef{};
-    colorAttachmentRef.attachment = 0;
-    colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-    // Depth attachment
-    VkAttachmentDescription depthAttachment{};
-    depthAttachment.format = findDepthFormat();
-    depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-    depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-    VkAttachmentReference depthAttachmentRef{};
-    depthAttachmentRef.attachment = 1;
-    depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-    VkSubpassDescription subpass{};
-    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-    subpass.colorAttachmentCount = 1;
-    subpass.pColorAttachments = &colorAttachmentRef;
-    subpass.pDepthStencilAttachment = &depthAttachmentRef;
-
-    // Subpass dependencies for layout transitions
-    VkSubpassDependency dependency{};
-    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-    dependency.dstSubpass = 0;
-    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-    dependency.srcAccessMask = 0;
-    dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-
-    std::array<VkAttachmentDescription, 2> attachments = {colorAttachment, depthAttachment};
-    VkRenderPassCreateInfo renderPassInfo{};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-    renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
-    renderPassInfo.pAttachments = attachments.data();
-    renderPassInfo.subpassCount = 1;
-    renderPassInfo.pSubpasses = &subpass;
-    renderPassInfo.dependencyCount = 1;
-    renderPassInfo.pDependencies = &dependency;
-
-    if (vkCreateRenderPass(m_device, &renderPassInfo, nullptr, &m_renderPass) != VK_SUCCESS)
-    {
-        throw std::runtime_error("Failed to create render pass");
-    }
-
-    LOG_INFO("[Vulkan] Render pass created with depth attachment");
+    // The first pass of a frame clears, later ones load what the previous passes drew.
+    // The color target stays an attachment between passes, endFrame() transitions it.
+    for (bool clear : {true, false})
+    {
+        VkAttachmentLoadOp loadOp = clear ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+
+        // Color attachment
+        VkAttachmentDescription colorAttachment{};
+        colorAttachment.format = m_swapChainImageFormat;
+        colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        colorAttachment.loadOp = loadOp;
+        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        colorAttachment.initialLayout = clear ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        VkAttachmentReference colorAttachmentRef{};
+        colorAttachmentRef.attachment = 0;
+        colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        // Depth attachment, stored for the passes after this one
+        VkAttachmentDescription depthAttachment{};
+        depthAttachment.format = findDepthFormat();
+        depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        depthAttachment.loadOp = loadOp;
+        depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        depthAttachment.initialLayout = clear ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        VkAttachmentReference depthAttachmentRef{};
+        depthAttachmentRef.attachment = 1;
+        depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        VkSubpassDescription subpass{};
+        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.colorAttachmentCount = 1;
+        subpass.pColorAttachments = &colorAttachmentRef;
+        subpass.pDepthStencilAttachment = &depthAttachmentRef;
+
+        // The previous pass's attachment writes (or the previous frame's for the shared
+        // depth image) must be done before this pass loads or clears
+        VkSubpassDependency dependency{};
+        dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+        dependency.dstSubpass = 0;
+        dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                                  VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                                  VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        dependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        dependency.dstStageMask = dependency.srcStageMask;
+        dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                   VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                                   VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+        std::array<VkAttachmentDescription, 2> attachments = {colorAttachment, depthAttachment};
+        VkRenderPassCreateInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+        renderPassInfo.pAttachments = attachments.data();
+        renderPassInfo.subpassCount = 1;
+        renderPassInfo.pSubpasses = &subpass;
+        renderPassInfo.dependencyCount = 1;
+        renderPassInfo.pDependencies = &dependency;
+
+        if (vkCreateRenderPass(m_device, &renderPassInfo, nullptr,
+                               clear ? &m_renderPass : &m_loadRenderPass) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create render pass");
+        }
+    }
+
+    LOG_INFO("[Vulkan] Render passes created with depth attachment");
 }
 
 void Renderer::createDescriptorSetLayout()
@@ -528,51 +941,318 @@ void Renderer::createDescriptorSetLayout()
         throw std::runtime_error("Failed to create descriptor set layout");
     }
 
+    // Bindless texture array, left empty without support so set numbers stay the same
+    VkDescriptorSetLayoutBinding bindlessBinding{};
+    bindlessBinding.binding = 0;
+    bindlessBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindlessBinding.descriptorCount = m_bindlessCapacity;
+    bindlessBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    // Slots are written while frames using other slots are in flight
+    VkDescriptorBindingFlags bindlessFlags = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                                             VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT |
+                                             VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+    VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+    bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    bindingFlagsInfo.bindingCount = 1;
+    bindingFlagsInfo.pBindingFlags = &bindlessFlags;
+
+    VkDescriptorSetLayoutCreateInfo bindlessLayoutInfo{};
+    bindlessLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    if (m_bindlessSupported)
+    {
+        bindlessLayoutInfo.pNext = &bindingFlagsInfo;
+        bindlessLayoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+        bindlessLayoutInfo.bindingCount = 1;
+        bindlessLayoutInfo.pBindings = &bindlessBinding;
+    }
+
+    if (vkCreateDescriptorSetLayout(m_device, &bindlessLayoutInfo, nullptr, &m_bindlessSetLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create bindless descriptor set layout");
+    }
+
+    // Shader uniform block, the offset into the uniform ring is given at bind time
+    VkDescriptorSetLayoutBinding uniformBinding{};
+    uniformBinding.binding = 0;
+    uniformBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    uniformBinding.descriptorCount = 1;
+    uniformBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutCreateInfo uniformLayoutInfo{};
+    uniformLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    uniformLayoutInfo.bindingCount = 1;
+    uniformLayoutInfo.pBindings = &uniformBinding;
+
+    if (vkCreateDescriptorSetLayout(m_device, &uniformLayoutInfo, nullptr, &m_uniformSetLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create uniform descriptor set layout");
+    }
+
+    // Object buffer of the GPU-driven path, read by the vertex shader by instance index
+    VkDescriptorSetLayoutBinding objectBinding{};
+    objectBinding.binding = 0;
+    objectBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    objectBinding.descriptorCount = 1;
+    objectBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+    VkDescriptorSetLayoutCreateInfo objectLayoutInfo{};
+    objectLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    objectLayoutInfo.bindingCount = 1;
+    objectLayoutInfo.pBindings = &objectBinding;
+
+    if (vkCreateDescriptorSetLayout(m_device, &objectLayoutInfo, nullptr, &m_objectSetLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create object descriptor set layout");
+    }
+
     LOG_INFO("[Vulkan] Descriptor set layout created");
 }
 
 void Renderer::createPipelineLayout()
 {
-    // Define push constant range for transformation matrices
+    // Used by shaders without push constants in their reflection: the transformation
+    // matrices, followed by the bindless texture index read by the fragment shader
     VkPushConstantRange pushConstantRange{};
     pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
     pushConstantRange.offset = 0;
     pushConstantRange.size = sizeof(glm::mat4) * 3; // model, view, projection matrices
+    if (m_bindlessSupported)
+    {
+        pushConstantRange.stageFlags |= VK_SHADER_STAGE_FRAGMENT_BIT;
+        pushConstantRange.size = BINDLESS_TEXTURE_INDEX_OFFSET + sizeof(uint32_t);
+    }
+
+    m_defaultShaderLayout.pushConstantRange = pushConstantRange;
+    m_defaultShaderLayout.pipelineLayout = acquirePipelineLayout(pushConstantRange);
+
+    LOG_INFO("[Vulkan] Pipeline layout created");
+}
+
+VkPipelineLayout Renderer::acquirePipelineLayout(const VkPushConstantRange& pushConstantRange)
+{
+    // Descriptor set layouts are shared, so layouts only differ by their push constants
+    for (const auto& [range, layout] : m_pipelineLayouts)
+    {
+        if (range.stageFlags == pushConstantRange.stageFlags &&
+            range.offset == pushConstantRange.offset && range.size == pushConstantRange.size)
+        {
+            return layout;
+        }
+    }
+
+    std::array<VkDescriptorSetLayout, 4> setLayouts{};
+    setLayouts[TEXTURE_SET] = m_descriptorSetLayout;
+    setLayouts[BINDLESS_SET] = m_bindlessSetLayout;
+    setLayouts[UNIFORM_SET] = m_uniformSetLayout;
+    setLayouts[OBJECT_SET] = m_objectSetLayout;
 
     VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
     pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 1;
-    pipelineLayoutInfo.pSetLayouts = &m_descriptorSetLayout;
-    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+    pipelineLayoutInfo.pSetLayouts = setLayouts.data();
+    pipelineLayoutInfo.pushConstantRangeCount = pushConstantRange.size > 0 ? 1 : 0;
     pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
 
-    if (vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS)
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    if (vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, nullptr, &layout) != VK_SUCCESS)
     {
         throw std::runtime_error("Failed to create pipeline layout");
     }
 
-    LOG_INFO("[Vulkan] Pipeline layout created");
+    m_pipelineLayouts.emplace_back(pushConstantRange, layout);
+    return layout;
+}
+
+ShaderLayout Renderer::getShaderLayout(const std::string& shaderName, const ShaderReflection& reflection)
+{
+    // Sets are filled by textures, the bindless array and the uniform ring, so shaders
+    // are checked against the shared set layouts instead of getting their own
+    for (const ReflectedBinding& binding : reflection.bindings)
+    {
+        VkDescriptorType providedType = VK_DESCRIPTOR_TYPE_MAX_ENUM;
+        VkShaderStageFlags providedStages = 0;
+        if (binding.binding == 0)
+        {
+            switch (binding.set)
+            {
+                case TEXTURE_SET:
+                    providedType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                    providedStages = VK_SHADER_STAGE_FRAGMENT_BIT;
+                    break;
+                case BINDLESS_SET:
+                    providedType = m_bindlessSupported ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER
+                                                       : VK_DESCRIPTOR_TYPE_MAX_ENUM;
+                    providedStages = VK_SHADER_STAGE_FRAGMENT_BIT;
+                    break;
+                case UNIFORM_SET:
+                    providedType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                    providedStages = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+                    break;
+                case OBJECT_SET:
+                    providedType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                    providedStages = VK_SHADER_STAGE_VERTEX_BIT;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        if (binding.type != providedType || (binding.stages & ~providedStages) != 0)
+        {
+            LOG_WARNING("[Vulkan] Shader '{}' uses set {} binding {} which the renderer doesn't provide",
+                        shaderName, binding.set, binding.binding);
+        }
+    }
+
+    const VkPushConstantRange& range = reflection.pushConstantRange;
+    if (range.size == 0)
+    {
+        return m_defaultShaderLayout;
+    }
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+    if (range.offset + range.size > properties.limits.maxPushConstantsSize)
+    {
+        LOG_WARNING("[Vulkan] Push constants of shader '{}' exceed the device limit of {} bytes",
+                    shaderName, properties.limits.maxPushConstantsSize);
+        return m_defaultShaderLayout;
+    }
+
+    ShaderLayout layout;
+    layout.pushConstantRange = range;
+    layout.pipelineLayout = acquirePipelineLayout(range);
+    return layout;
+}
+
+void Renderer::createDescriptorAllocator()
+{
+    // Pools are created on demand, one transient chain per frame slot
+    m_descriptorAllocator = std::make_unique<DescriptorAllocator>(m_device, MAX_FRAMES_IN_FLIGHT);
+
+    LOG_INFO("[Vulkan] Descriptor allocator created");
 }
 
-void Renderer::createDescriptorPool()
+void Renderer::createBindlessResources()
 {
-    // Create a descriptor pool large enough for texture samplers
+    if (!m_bindlessSupported)
+    {
+        LOG_INFO("[Vulkan] Bindless textures not supported by this device");
+        return;
+    }
+
     VkDescriptorPoolSize poolSize{};
     poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSize.descriptorCount = 100; // Allow up to 100 texture samplers
+    poolSize.descriptorCount = m_bindlessCapacity;
 
     VkDescriptorPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
     poolInfo.poolSizeCount = 1;
     poolInfo.pPoolSizes = &poolSize;
-    poolInfo.maxSets = 100; // Allow up to 100 descriptor sets
+    poolInfo.maxSets = 1;
+
+    if (vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &m_bindlessPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create bindless descriptor pool");
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_bindlessPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &m_bindlessSetLayout;
+
+    if (vkAllocateDescriptorSets(m_device, &allocInfo, &m_bindlessSet) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to allocate bindless descriptor set");
+    }
+
+    LOG_INFO("[Vulkan] Bindless texture array created ({} slots)", m_bindlessCapacity);
+}
+
+void Renderer::createUniformRing()
+{
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+
+    m_uniformRing = std::make_unique<UniformRing>(m_device, m_memoryAllocator.get(), m_descriptorAllocator.get(),
+                                                  m_uniformSetLayout,
+                                                  properties.limits.minUniformBufferOffsetAlignment,
+                                                  MAX_FRAMES_IN_FLIGHT);
 
-    if (vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS)
+    LOG_INFO("[Vulkan] Uniform ring created");
+}
+
+void Renderer::setBindlessTextures(bool enable)
+{
+    if (enable && !m_bindlessSupported)
+    {
+        LOG_WARNING("[Vulkan] Bindless textures not supported, keeping per-texture descriptor sets");
+        return;
+    }
+
+    m_bindlessEnabled = enable;
+    LOG_INFO("[Vulkan] Bindless textures {}", enable ? "enabled" : "disabled");
+}
+
+uint32_t Renderer::registerBindlessTexture(VkImageView imageView, VkSampler sampler)
+{
+    if (!m_bindlessSupported)
+    {
+        return INVALID_BINDLESS_INDEX;
+    }
+
+    uint32_t index;
+    if (!m_freeBindlessIndices.empty())
+    {
+        index = m_freeBindlessIndices.back();
+        m_freeBindlessIndices.pop_back();
+    }
+    else if (m_nextBindlessIndex < m_bindlessCapacity)
+    {
+        index = m_nextBindlessIndex++;
+    }
+    else
+    {
+        LOG_WARNING("[Vulkan] Bindless texture array full ({} slots)", m_bindlessCapacity);
+        return INVALID_BINDLESS_INDEX;
+    }
+
+    updateBindlessTexture(index, imageView, sampler);
+    return index;
+}
+
+void Renderer::updateBindlessTexture(uint32_t index, VkImageView imageView, VkSampler sampler)
+{
+    if (index == INVALID_BINDLESS_INDEX)
     {
-        throw std::runtime_error("Failed to create descriptor pool");
+        return;
     }
 
-    LOG_INFO("[Vulkan] Descriptor pool created");
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageInfo.imageView = imageView;
+    imageInfo.sampler = sampler;
+
+    VkWriteDescriptorSet descriptorWrite{};
+    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrite.dstSet = m_bindlessSet;
+    descriptorWrite.dstBinding = 0;
+    descriptorWrite.dstArrayElement = index;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pImageInfo = &imageInfo;
+
+    vkUpdateDescriptorSets(m_device, 1, &descriptorWrite, 0, nullptr);
+}
+
+void Renderer::releaseBindlessTexture(uint32_t index)
+{
+    if (index == INVALID_BINDLESS_INDEX) return;
+
+    queueDeferredDeletion(DeferredDeletion::Type::BindlessIndex, index);
 }
 
 void Renderer::createDepthResources()
@@ -599,21 +1279,8 @@ void Renderer::createDepthResources()
         throw std::runtime_error("Failed to create depth image");
     }
 
-    VkMemoryRequirements memRequirements;
-    vkGetImageMemoryRequirements(m_device, m_depthImage, &memRequirements);
-
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits,
-                                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-    if (vkAllocateMemory(m_device, &allocInfo, nullptr, &m_depthImageMemory) != VK_SUCCESS)
-    {
-        throw std::runtime_error("Failed to allocate depth image memory");
-    }
-
-    vkBindImageMemory(m_device, m_depthImage, m_depthImageMemory, 0);
+    m_depthAllocation = m_memoryAllocator->allocateImageMemory(m_depthImage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    vkBindImageMemory(m_device, m_depthImage, m_depthAllocation.memory, m_depthAllocation.offset);
 
     // Create image view
     VkImageViewCreateInfo viewInfo{};
@@ -636,13 +1303,11 @@ void Renderer::createDepthResources()
              m_swapChainExtent.width, m_swapChainExtent.height, static_cast<int>(m_depthFormat));
 }
 
-VkPipeline Renderer::createPipelineForShader(VkShaderModule vertShaderModule,
-                                              VkShaderModule fragShaderModule,
-                                              VkRenderPass renderPass,
-                                              VkPipelineLayout pipelineLayout,
-                                              VkExtent2D extent)
+VkPipeline Renderer::createPipeline(const PipelineKey& key)
 {
-    if (vertShaderModule == VK_NULL_HANDLE || fragShaderModule == VK_NULL_HANDLE)
+    const RenderState& renderState = key.renderState;
+
+    if (key.vertexModule == VK_NULL_HANDLE || key.fragmentModule == VK_NULL_HANDLE)
     {
         LOG_ERROR("[Vulkan] Invalid shader modules for pipeline creation");
         return VK_NULL_HANDLE;
@@ -651,52 +1316,36 @@ VkPipeline Renderer::createPipelineForShader(VkShaderModule vertShaderModule,
     VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
     vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-    vertShaderStageInfo.module = vertShaderModule;
+    vertShaderStageInfo.module = key.vertexModule;
     vertShaderStageInfo.pName = "main";
 
     VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
     fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    fragShaderStageInfo.module = fragShaderModule;
+    fragShaderStageInfo.module = key.fragmentModule;
     fragShaderStageInfo.pName = "main";
 
     VkPipelineShaderStageCreateInfo shaderStages[] = {vertShaderStageInfo, fragShaderStageInfo};
 
     // Vertex input
-    VkVertexInputBindingDescription bindingDescription{};
-    bindingDescription.binding = 0;
-    bindingDescription.stride = sizeof(Vertex);
-    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-
-    std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions{};
-    // Position attribute
-    attributeDescriptions[0].binding = 0;
-    attributeDescriptions[0].location = 0;
-    attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
-    attributeDescriptions[0].offset = offsetof(Vertex, pos);
-
-    // Color attribute
-    attributeDescriptions[1].binding = 0;
-    attributeDescriptions[1].location = 1;
-    attributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
-    attributeDescriptions[1].offset = offsetof(Vertex, color);
-
-    // Texture coordinate attribute
-    attributeDescriptions[2].binding = 0;
-    attributeDescriptions[2].location = 2;
-    attributeDescriptions[2].format = VK_FORMAT_R32G32_SFLOAT;
-    attributeDescriptions[2].offset = offsetof(Vertex, texCoord);
+    VkVertexInputBindingDescription bindingDescriptions[2]{};
+    bindingDescriptions[0].binding = VertexInputLayout::VERTEX_BINDING;
+    bindingDescriptions[0].stride = key.vertexInput.stride;
+    bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+    bindingDescriptions[1].binding = VertexInputLayout::INSTANCE_BINDING;
+    bindingDescriptions[1].stride = key.vertexInput.instanceStride;
+    bindingDescriptions[1].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
 
     VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
     vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputInfo.vertexBindingDescriptionCount = 1;
-    vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
-    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-    vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+    vertexInputInfo.vertexBindingDescriptionCount = key.vertexInput.instanceStride > 0 ? 2 : 1;
+    vertexInputInfo.pVertexBindingDescriptions = bindingDescriptions;
+    vertexInputInfo.vertexAttributeDescriptionCount = key.vertexInput.attributeCount;
+    vertexInputInfo.pVertexAttributeDescriptions = key.vertexInput.attributes.data();
 
     VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
     inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    inputAssembly.topology = key.topology;
     inputAssembly.primitiveRestartEnable = VK_FALSE;
 
     // Use dynamic viewport and scissor to support window resizing
@@ -714,9 +1363,8 @@ VkPipeline Renderer::createPipelineForShader(VkShaderModule vertShaderModule,
     rasterizer.rasterizerDiscardEnable = VK_FALSE;
     rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
     rasterizer.lineWidth = 1.0f;
-    rasterizer.cullMode = m_cullingEnabled ? VK_CULL_MODE_BACK_BIT : VK_CULL_MODE_NONE;
-    // Use counter-clockwise to match OpenGL convention (after Y-axis flip)
-    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rasterizer.cullMode = renderState.cullMode;
+    rasterizer.frontFace = renderState.frontFace;
     rasterizer.depthBiasEnable = VK_FALSE;
 
     VkPipelineMultisampleStateCreateInfo multisampling{};
@@ -727,7 +1375,14 @@ VkPipeline Renderer::createPipelineForShader(VkShaderModule vertShaderModule,
     VkPipelineColorBlendAttachmentState colorBlendAttachment{};
     colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
                                           VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-    colorBlendAttachment.blendEnable = VK_FALSE;
+    colorBlendAttachment.blendEnable = renderState.blend ? VK_TRUE : VK_FALSE;
+    // Same equation as the OpenGL backend's enableBlending()
+    colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+    colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
 
     VkPipelineColorBlendStateCreateInfo colorBlending{};
     colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
@@ -738,8 +1393,8 @@ VkPipeline Renderer::createPipelineForShader(VkShaderModule vertShaderModule,
     // Depth and stencil state
     VkPipelineDepthStencilStateCreateInfo depthStencil{};
     depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-    depthStencil.depthTestEnable = m_depthTestEnabled ? VK_TRUE : VK_FALSE;
-    depthStencil.depthWriteEnable = m_depthTestEnabled ? VK_TRUE : VK_FALSE;
+    depthStencil.depthTestEnable = renderState.depthTest ? VK_TRUE : VK_FALSE;
+    depthStencil.depthWriteEnable = renderState.depthWrite ? VK_TRUE : VK_FALSE;
     depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
     depthStencil.depthBoundsTestEnable = VK_FALSE;
     depthStencil.minDepthBounds = 0.0f;
@@ -749,15 +1404,28 @@ VkPipeline Renderer::createPipelineForShader(VkShaderModule vertShaderModule,
     depthStencil.back = {};
 
     // Enable dynamic viewport and scissor to support window resizing
-    VkDynamicState dynamicStates[] = {
+    // Depth, cull and blend toggles are dynamic too where the device supports it,
+    // the values above are then ignored and set per draw instead
+    std::vector<VkDynamicState> dynamicStates = {
         VK_DYNAMIC_STATE_VIEWPORT,
         VK_DYNAMIC_STATE_SCISSOR
     };
+    if (m_dynamicState.hasDynamicRasterState())
+    {
+        dynamicStates.push_back(VK_DYNAMIC_STATE_CULL_MODE_EXT);
+        dynamicStates.push_back(VK_DYNAMIC_STATE_FRONT_FACE_EXT);
+        dynamicStates.push_back(VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT);
+        dynamicStates.push_back(VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT);
+    }
+    if (m_dynamicState.hasDynamicBlendEnable())
+    {
+        dynamicStates.push_back(VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT);
+    }
 
     VkPipelineDynamicStateCreateInfo dynamicState{};
     dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-    dynamicState.dynamicStateCount = 2;
-    dynamicState.pDynamicStates = dynamicStates;
+    dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+    dynamicState.pDynamicStates = dynamicStates.data();
 
     VkGraphicsPipelineCreateInfo pipelineInfo{};
     pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
@@ -771,12 +1439,25 @@ VkPipeline Renderer::createPipelineForShader(VkShaderModule vertShaderModule,
     pipelineInfo.pDepthStencilState = &depthStencil;
     pipelineInfo.pColorBlendState = &colorBlending;
     pipelineInfo.pDynamicState = &dynamicState;  // Add dynamic state
-    pipelineInfo.layout = pipelineLayout;
-    pipelineInfo.renderPass = renderPass;
+    pipelineInfo.layout = key.pipelineLayout;
+    pipelineInfo.renderPass = key.renderPass;
     pipelineInfo.subpass = 0;
 
-    VkPipeline pipeline;
-    if (vkCreateGraphicsPipelines(m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS)
+    // Without a render pass the attachment formats are given directly
+    VkPipelineRenderingCreateInfoKHR renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachmentFormats = &key.colorFormat;
+    renderingInfo.depthAttachmentFormat = key.depthFormat;
+    renderingInfo.stencilAttachmentFormat = VK_FORMAT_UNDEFINED;
+    if (key.renderPass == VK_NULL_HANDLE)
+    {
+        renderingInfo.pNext = pipelineInfo.pNext;
+        pipelineInfo.pNext = &renderingInfo;
+    }
+
+    VkPipeline pipeline = m_pipelineCache->createGraphicsPipeline(pipelineInfo);
+    if (pipeline == VK_NULL_HANDLE)
     {
         LOG_ERROR("[Vulkan] Failed to create graphics pipeline");
         return VK_NULL_HANDLE;
@@ -787,28 +1468,188 @@ VkPipeline Renderer::createPipelineForShader(VkShaderModule vertShaderModule,
     return pipeline;
 }
 
-void Renderer::createFramebuffers()
+PipelineKey Renderer::makePipelineKey(const ShaderProgram& shader, VkPrimitiveTopology topology) const
 {
-    m_swapChainFramebuffers.resize(m_swapChainImageViews.size());
-
-    for (size_t i = 0; i < m_swapChainImageViews.size(); i++)
+    PipelineKey key;
+    key.vertexModule = shader.getVertexModule();
+    key.fragmentModule = shader.getFragmentModule();
+    key.renderPass = m_renderPass;
+    key.colorFormat = m_swapChainImageFormat;
+    key.depthFormat = m_depthFormat;
+    key.pipelineLayout = shader.getPipelineLayout();
+    key.topology = topology;
+    // Vertex input comes from the bound vertex array, so compact formats fetch what they store
+    key.vertexInput = (m_boundVertexArray && m_boundVertexArray->hasAttributes())
+        ? m_boundVertexArray->getVertexInputLayout()
+        : m_defaultVertexInput;
+
+    // Dynamic state keeps its default so toggling it never selects another pipeline
+    RenderState defaults;
+    key.renderState = m_renderState;
+    if (m_dynamicState.hasDynamicRasterState())
     {
-        std::array<VkImageView, 2> attachments = {
-            m_swapChainImageViews[i],
-            m_depthImageView
-        };
+        key.renderState.depthTest = defaults.depthTest;
+        key.renderState.depthWrite = defaults.depthWrite;
+        key.renderState.cullMode = defaults.cullMode;
+        key.renderState.frontFace = defaults.frontFace;
+    }
+    if (m_dynamicState.hasDynamicBlendEnable())
+    {
+        key.renderState.blend = defaults.blend;
+    }
 
-        VkFramebufferCreateInfo framebufferInfo{};
-        framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-        framebufferInfo.renderPass = m_renderPass;
-        framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
-        framebufferInfo.pAttachments = attachments.data();
-        framebufferInfo.width = m_swapChainExtent.width;
-        framebufferInfo.height = m_swapChainExtent.height;
-        framebufferInfo.layers = 1;
+    key.computeHash();
+    return key;
+}
 
-        if (vkCreateFramebuffer(m_device, &framebufferInfo, nullptr, &m_swapChainFramebuffers[i]) != VK_SUCCESS)
-        {
+CompiledPipeline& Renderer::findOrRequestPipeline(const PipelineKey& key)
+{
+    auto it = m_pipelines.find(key);
+    if (it != m_pipelines.end())
+    {
+        return *it->second;
+    }
+
+    auto compiled = std::make_unique<CompiledPipeline>();
+
+    // Until it's ready, draw with a pipeline that only differs in baked render state
+    for (const auto& entry : m_pipelines)
+    {
+        const PipelineKey& other = entry.first;
+        if (other.vertexModule == key.vertexModule && other.fragmentModule == key.fragmentModule &&
+            other.renderPass == key.renderPass && other.colorFormat == key.colorFormat &&
+            other.depthFormat == key.depthFormat && other.pipelineLayout == key.pipelineLayout &&
+            other.topology == key.topology && other.vertexInput == key.vertexInput &&
+            entry.second->status.load(std::memory_order_acquire) == CompiledPipeline::Status::Ready)
+        {
+            compiled->fallback = entry.second->pipeline;
+            break;
+        }
+    }
+
+    CompiledPipeline* result = compiled.get();
+    m_pipelines.emplace(key, std::move(compiled));
+    m_pipelineCompiler->enqueue(key, result);
+
+    LOG_DEBUG("[Vulkan] Pipeline {} queued for compilation ({} pipelines)",
+              key.hash, m_pipelines.size());
+    return *result;
+}
+
+void Renderer::requestPipeline(const PipelineKey& key)
+{
+    findOrRequestPipeline(key);
+}
+
+VkPipeline Renderer::getPipeline(const PipelineKey& key)
+{
+    CompiledPipeline& compiled = findOrRequestPipeline(key);
+
+    switch (compiled.status.load(std::memory_order_acquire))
+    {
+        case CompiledPipeline::Status::Ready:
+            return compiled.pipeline;
+        case CompiledPipeline::Status::Pending:
+            return compiled.fallback;
+        default:
+            return VK_NULL_HANDLE;
+    }
+}
+
+void Renderer::releasePipelines(VkShaderModule vertModule, VkShaderModule fragModule)
+{
+    // Workers may still be compiling from these modules
+    if (m_pipelineCompiler)
+    {
+        m_pipelineCompiler->waitIdle();
+    }
+
+    auto it = m_pipelines.begin();
+    while (it != m_pipelines.end())
+    {
+        if (it->first.vertexModule == vertModule && it->first.fragmentModule == fragModule)
+        {
+            // Frames in flight may still use it
+            deferDeletePipeline(it->second->pipeline);
+            it = m_pipelines.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void Renderer::destroyAllPipelines()
+{
+    if (m_pipelineCompiler)
+    {
+        m_pipelineCompiler->waitIdle();
+    }
+
+    // Only called with the device idle
+    for (auto& entry : m_pipelines)
+    {
+        if (entry.second->pipeline != VK_NULL_HANDLE)
+        {
+            vkDestroyPipeline(m_device, entry.second->pipeline, nullptr);
+        }
+    }
+
+    if (!m_pipelines.empty())
+    {
+        LOG_INFO("[Vulkan] Destroyed {} cached pipelines", m_pipelines.size());
+        m_pipelines.clear();
+    }
+}
+
+VkPrimitiveTopology Renderer::convertPrimitiveType(PrimitiveType mode) const
+{
+    switch (mode)
+    {
+        case PrimitiveType::Points:        return VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+        case PrimitiveType::Lines:         return VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+        case PrimitiveType::LineStrip:     return VK_PRIMITIVE_TOPOLOGY_LINE_STRIP;
+        case PrimitiveType::LineLoop:
+        {
+            // Vulkan has no line loops, the closing segment is missing
+            static bool warnedLineLoop = false;
+            if (!warnedLineLoop)
+            {
+                LOG_WARNING("[Vulkan] LineLoop is not supported, drawing a LineStrip instead");
+                warnedLineLoop = true;
+            }
+            return VK_PRIMITIVE_TOPOLOGY_LINE_STRIP;
+        }
+        case PrimitiveType::Triangles:     return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        case PrimitiveType::TriangleStrip: return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+        case PrimitiveType::TriangleFan:   return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_FAN;
+        default:                           return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    }
+}
+
+void Renderer::createFramebuffers()
+{
+    m_swapChainFramebuffers.resize(m_swapChainImageViews.size());
+
+    for (size_t i = 0; i < m_swapChainImageViews.size(); i++)
+    {
+        std::array<VkImageView, 2> attachments = {
+            m_swapChainImageViews[i],
+            m_depthImageView
+        };
+
+        VkFramebufferCreateInfo framebufferInfo{};
+        framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebufferInfo.renderPass = m_renderPass;
+        framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+        framebufferInfo.pAttachments = attachments.data();
+        framebufferInfo.width = m_swapChainExtent.width;
+        framebufferInfo.height = m_swapChainExtent.height;
+        framebufferInfo.layers = 1;
+
+        if (vkCreateFramebuffer(m_device, &framebufferInfo, nullptr, &m_swapChainFramebuffers[i]) != VK_SUCCESS)
+        {
             throw std::runtime_error("Failed to create framebuffer");
         }
     }
@@ -835,49 +1676,82 @@ void Renderer::createCommandPool()
 
 void Renderer::createTransferCommandPool()
 {
-    QueueFamilyIndices queueFamilyIndices = findQueueFamilies(m_physicalDevice);
-
-    // Create command pool for transfer operations
+    // Create command pool for transfer operations on the transfer queue family
     VkCommandPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
     poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-    poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily;
+    poolInfo.queueFamilyIndex = m_queueFamilyIndices.transferFamily;
 
     if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &m_transferCommandPool) != VK_SUCCESS)
     {
         throw std::runtime_error("Failed to create transfer command pool");
     }
 
-    // Pre-allocate command buffers
-    m_transferCommandBuffers.resize(TRANSFER_COMMAND_BUFFER_POOL_SIZE);
+    // Upload timeline: the transfer queue signals one value per submitted upload
+    VkSemaphoreTypeCreateInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    timelineInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    timelineInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &timelineInfo;
+
+    if (vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &m_uploadTimeline) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create upload timeline semaphore");
+    }
+
+    // Queue families a device-local buffer is shared between (see applyUploadSharingMode())
+    m_uploadQueueFamilies[0] = m_queueFamilyIndices.graphicsFamily;
+    m_uploadQueueFamilies[1] = m_queueFamilyIndices.transferFamily;
+
+    // Pre-allocate command buffers, more are added if all of them are in flight
+    for (uint32_t i = 0; i < TRANSFER_COMMAND_BUFFER_POOL_SIZE; ++i)
+    {
+        allocateTransferCommandBuffer();
+    }
 
+    // Graphics-side command buffers that acquire ownership of uploaded resources
     VkCommandBufferAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
     allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandPool = m_transferCommandPool;
-    allocInfo.commandBufferCount = 1;
+    allocInfo.commandPool = m_commandPool;
+    allocInfo.commandBufferCount = MAX_FRAMES_IN_FLIGHT;
 
-    // Create fences for synchronization
-    VkFenceCreateInfo fenceInfo{};
-    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT; // Start signaled so first use doesn't wait
+    if (vkAllocateCommandBuffers(m_device, &allocInfo, m_acquireCommandBuffers.data()) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to allocate ownership acquire command buffers");
+    }
 
-    for (uint32_t i = 0; i < TRANSFER_COMMAND_BUFFER_POOL_SIZE; ++i)
+    // Also read by the graphics queue for buffer updates recorded in a frame
+    std::vector<uint32_t> stagingQueueFamilies = {m_queueFamilyIndices.graphicsFamily};
+    if (m_queueFamilyIndices.hasDedicatedTransfer())
     {
-        if (vkAllocateCommandBuffers(m_device, &allocInfo, &m_transferCommandBuffers[i].commandBuffer) != VK_SUCCESS)
-        {
-            throw std::runtime_error("Failed to allocate transfer command buffer");
-        }
+        stagingQueueFamilies.push_back(m_queueFamilyIndices.transferFamily);
+    }
+    m_stagingRing = std::make_unique<StagingRing>(m_device, m_memoryAllocator.get(), stagingQueueFamilies);
 
-        if (vkCreateFence(m_device, &fenceInfo, nullptr, &m_transferCommandBuffers[i].fence) != VK_SUCCESS)
-        {
-            throw std::runtime_error("Failed to create transfer command buffer fence");
-        }
+    LOG_INFO("[Vulkan] Transfer command pool created with {} buffers", TRANSFER_COMMAND_BUFFER_POOL_SIZE);
+}
+
+void Renderer::allocateTransferCommandBuffer()
+{
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandPool = m_transferCommandPool;
+    allocInfo.commandBufferCount = 1;
 
-        m_transferCommandBuffers[i].inUse = false;
+    TransferCommandBuffer transferCmd{};
+    if (vkAllocateCommandBuffers(m_device, &allocInfo, &transferCmd.commandBuffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to allocate transfer command buffer");
     }
 
-    LOG_INFO("[Vulkan] Transfer command pool created with {} buffers", TRANSFER_COMMAND_BUFFER_POOL_SIZE);
+    transferCmd.uploadValue = 0;
+    transferCmd.inUse = false;
+    m_transferCommandBuffers.push_back(transferCmd);
 }
 
 void Renderer::cleanupTransferCommandPool()
@@ -886,15 +1760,10 @@ void Renderer::cleanupTransferCommandPool()
         return;
 
     // Wait for all transfers to complete
-    for (auto& cmdBuf : m_transferCommandBuffers)
-    {
-        if (cmdBuf.fence != VK_NULL_HANDLE)
-        {
-            vkWaitForFences(m_device, 1, &cmdBuf.fence, VK_TRUE, UINT64_MAX);
-            vkDestroyFence(m_device, cmdBuf.fence, nullptr);
-            cmdBuf.fence = VK_NULL_HANDLE;
-        }
-    }
+    waitForUpload(m_uploadValue);
+
+    m_stagingRing.reset();
+    m_pendingAcquires.clear();
 
     m_transferCommandBuffers.clear();
 
@@ -904,37 +1773,36 @@ void Renderer::cleanupTransferCommandPool()
         m_transferCommandPool = VK_NULL_HANDLE;
     }
 
+    if (m_uploadTimeline != VK_NULL_HANDLE)
+    {
+        vkDestroySemaphore(m_device, m_uploadTimeline, nullptr);
+        m_uploadTimeline = VK_NULL_HANDLE;
+    }
+
     LOG_DEBUG("[Vulkan] Transfer command pool cleaned up");
 }
 
 TransferCommandBuffer* Renderer::acquireTransferCommandBuffer()
 {
-    // Try to find a free command buffer
+    uint64_t completedUpload = getCompletedUploadValue();
+
+    // Try to find a command buffer whose last upload has completed
     for (auto& cmdBuf : m_transferCommandBuffers)
     {
-        if (!cmdBuf.inUse)
+        if (!cmdBuf.inUse && cmdBuf.uploadValue <= completedUpload)
         {
-            // Wait for fence if it's still in flight from previous use
-            vkWaitForFences(m_device, 1, &cmdBuf.fence, VK_TRUE, UINT64_MAX);
-            vkResetFences(m_device, 1, &cmdBuf.fence);
-
             cmdBuf.inUse = true;
             return &cmdBuf;
         }
     }
 
-    // No free buffer, wait for the oldest one
-    // In a real implementation, you'd track age more carefully
-    for (auto& cmdBuf : m_transferCommandBuffers)
-    {
-        vkWaitForFences(m_device, 1, &cmdBuf.fence, VK_TRUE, UINT64_MAX);
-        vkResetFences(m_device, 1, &cmdBuf.fence);
-        cmdBuf.inUse = true;
-        return &cmdBuf;
-    }
+    // All buffers are still in flight, grow the pool instead of waiting
+    allocateTransferCommandBuffer();
+    LOG_DEBUG("[Vulkan] Transfer command pool grown to {} buffers", m_transferCommandBuffers.size());
 
-    // Should never reach here
-    throw std::runtime_error("Failed to acquire transfer command buffer");
+    TransferCommandBuffer& cmdBuf = m_transferCommandBuffers.back();
+    cmdBuf.inUse = true;
+    return &cmdBuf;
 }
 
 void Renderer::releaseTransferCommandBuffer(TransferCommandBuffer* cmdBuf)
@@ -1008,45 +1876,108 @@ void Renderer::createCommandBuffers()
 
 void Renderer::createSyncObjects()
 {
-    // Create semaphores: one per swapchain image (not per frame in flight)
-    // This avoids reusing a semaphore that's still in use by the presentation engine
     size_t imageCount = m_swapChainImages.size();
-    m_imageAvailableSemaphores.resize(imageCount);
-    m_renderFinishedSemaphores.resize(imageCount);
 
-    // Create fences: one per frame in flight (to limit CPU-GPU parallelism)
-    m_inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
+    // Headless frames are neither acquired nor presented
+    if (!m_headless)
+    {
+        // Acquire semaphores: one per frame slot, reusable once that slot's frame has completed
+        m_imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
+
+        // Render finished semaphores: one per swapchain image
+        // This avoids reusing a semaphore that's still in use by the presentation engine
+        m_renderFinishedSemaphores.resize(imageCount);
+    }
 
-    // Initialize images in flight tracker (which fence is using which image)
-    m_imagesInFlight.resize(imageCount, VK_NULL_HANDLE);
+    // Frame number that last rendered each swapchain image
+    m_imageFrameNumbers.assign(imageCount, 0);
 
     VkSemaphoreCreateInfo semaphoreInfo{};
     semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-    VkFenceCreateInfo fenceInfo{};
-    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-    // Create semaphores for each swapchain image
-    for (size_t i = 0; i < imageCount; i++)
+    for (size_t i = 0; i < m_imageAvailableSemaphores.size(); i++)
     {
-        if (vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &m_imageAvailableSemaphores[i]) != VK_SUCCESS ||
-            vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &m_renderFinishedSemaphores[i]) != VK_SUCCESS)
+        if (vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &m_imageAvailableSemaphores[i]) != VK_SUCCESS)
         {
             throw std::runtime_error("Failed to create semaphores");
         }
     }
 
-    // Create fences for frame in flight limiting
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+    for (size_t i = 0; i < m_renderFinishedSemaphores.size(); i++)
     {
-        if (vkCreateFence(m_device, &fenceInfo, nullptr, &m_inFlightFences[i]) != VK_SUCCESS)
+        if (vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &m_renderFinishedSemaphores[i]) != VK_SUCCESS)
         {
-            throw std::runtime_error("Failed to create fences");
+            throw std::runtime_error("Failed to create semaphores");
         }
     }
 
-    LOG_INFO("[Vulkan] Sync objects created ({} semaphore pairs, {} fences)", imageCount, MAX_FRAMES_IN_FLIGHT);
+    // Timeline semaphore: the graphics queue signals the frame number at the end of each frame
+    VkSemaphoreTypeCreateInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    timelineInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    timelineInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo timelineSemaphoreInfo{};
+    timelineSemaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    timelineSemaphoreInfo.pNext = &timelineInfo;
+
+    if (vkCreateSemaphore(m_device, &timelineSemaphoreInfo, nullptr, &m_frameTimeline) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create frame timeline semaphore");
+    }
+
+    LOG_INFO("[Vulkan] Sync objects created ({} image semaphores, {} frames in flight)", imageCount, m_framesInFlight);
+}
+
+void Renderer::createGpuProfiler()
+{
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &queueFamilyCount, nullptr);
+
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    uint32_t timestampValidBits = queueFamilies[m_queueFamilyIndices.graphicsFamily].timestampValidBits;
+    if (timestampValidBits == 0)
+    {
+        LOG_INFO("[Vulkan] Graphics queue has no timestamp support, GPU zones are disabled");
+    }
+    if (!m_pipelineStatisticsSupported)
+    {
+        LOG_INFO("[Vulkan] Pipeline statistics queries not supported");
+    }
+    if (timestampValidBits == 0 && !m_pipelineStatisticsSupported)
+    {
+        return;
+    }
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+
+    m_gpuProfiler = std::make_unique<GpuProfiler>(m_device, properties.limits.timestampPeriod, timestampValidBits,
+                                                  m_pipelineStatisticsSupported, MAX_FRAMES_IN_FLIGHT);
+
+    LOG_INFO("[Vulkan] GPU profiler created ({} ns per tick)", properties.limits.timestampPeriod);
+}
+
+void Renderer::createGpuCulling()
+{
+    if (!m_gpuDrivenSupported)
+    {
+        LOG_INFO("[Vulkan] Indirect count draws not supported, GPU-driven rendering is disabled");
+        return;
+    }
+
+    const std::string cullShaderPath = "shaders/vulkan/cull.comp.spv";
+    if (!std::ifstream(cullShaderPath).good())
+    {
+        LOG_WARNING("[Vulkan] {} not found, GPU-driven rendering is disabled", cullShaderPath);
+        return;
+    }
+
+    m_gpuCulling = std::make_unique<GpuCulling>(this, m_objectSetLayout, readShaderFile(cullShaderPath));
+
+    LOG_INFO("[Vulkan] GPU culling created");
 }
 
 void Renderer::cleanupSwapChain()
@@ -1071,10 +2002,10 @@ void Renderer::cleanupSwapChain()
         vkDestroyImage(m_device, m_depthImage, nullptr);
         m_depthImage = VK_NULL_HANDLE;
     }
-    if (m_depthImageMemory != VK_NULL_HANDLE)
+    if (m_depthAllocation.memory != VK_NULL_HANDLE)
     {
-        vkFreeMemory(m_device, m_depthImageMemory, nullptr);
-        m_depthImageMemory = VK_NULL_HANDLE;
+        m_memoryAllocator->free(m_depthAllocation);
+        m_depthAllocation = {};
     }
 
     for (auto imageView : m_swapChainImageViews)
@@ -1086,6 +2017,18 @@ void Renderer::cleanupSwapChain()
     }
     m_swapChainImageViews.clear();
 
+    // Offscreen targets are owned by the renderer, swapchain images by the swapchain
+    if (m_headless)
+    {
+        for (size_t i = 0; i < m_offscreenAllocations.size(); i++)
+        {
+            vkDestroyImage(m_device, m_swapChainImages[i], nullptr);
+            m_memoryAllocator->free(m_offscreenAllocations[i]);
+        }
+        m_offscreenAllocations.clear();
+        m_swapChainImages.clear();
+    }
+
     if (m_swapChain != VK_NULL_HANDLE)
     {
         vkDestroySwapchainKHR(m_device, m_swapChain, nullptr);
@@ -1104,47 +2047,120 @@ void Renderer::cleanupSwapChain()
         vkDestroyRenderPass(m_device, m_renderPass, nullptr);
         m_renderPass = VK_NULL_HANDLE;
     }
+    if (m_loadRenderPass != VK_NULL_HANDLE)
+    {
+        vkDestroyRenderPass(m_device, m_loadRenderPass, nullptr);
+        m_loadRenderPass = VK_NULL_HANDLE;
+    }
 }
 
-void Renderer::recreateSwapChain()
+bool Renderer::recreateSwapChain()
 {
-    // Handle window minimization - wait until window is restored
+    // A minimized window has no extent to create a swapchain with, frames are
+    // skipped and the recreation retried until it is restored
     int width = 0, height = 0;
     glfwGetFramebufferSize(m_window, &width, &height);
-    while (width == 0 || height == 0)
+    if (width == 0 || height == 0)
     {
-        glfwGetFramebufferSize(m_window, &width, &height);
-        glfwWaitEvents();
+        m_swapChainRecreatePending = true;
+        return false;
     }
+    m_swapChainRecreatePending = false;
 
-    vkDeviceWaitIdle(m_device);
+    // Any resize or present setting change so far is covered by this recreation
+    m_framebufferResized = false;
+    m_presentSettingsChanged = false;
 
-    // Destroy all pipelines before recreating swap chain
-    if (m_shaderManager)
+    // Frames in flight keep using the old swapchain's resources, they are retired
+    // through deferred deletion instead of draining the device
+    VkFormat oldFormat = m_swapChainImageFormat;
+    retireSwapChainResources();
+
+    createSwapChain();
+    createImageViews();
+
+    // Viewport and scissor are dynamic, so pipelines only depend on the attachment formats.
+    // With dynamic rendering they're part of the pipeline key, the old format's pipelines
+    // stay valid for the frames in flight and the new ones are compiled in the background.
+    if (m_dynamicRendering)
     {
-        m_shaderManager->destroyAllPipelines();
+        if (m_swapChainImageFormat != oldFormat && m_shaderManager)
+        {
+            LOG_INFO("[Vulkan] Swap chain format changed, compiling pipelines for the new format");
+            m_shaderManager->createAllPipelines();
+        }
     }
+    else if (m_swapChainImageFormat != oldFormat)
+    {
+        LOG_INFO("[Vulkan] Swap chain format changed, recreating the render pass and pipelines");
+        vkDeviceWaitIdle(m_device);
+        destroyAllPipelines();
 
-    cleanupSwapChain();
+        vkDestroyRenderPass(m_device, m_renderPass, nullptr);
+        vkDestroyRenderPass(m_device, m_loadRenderPass, nullptr);
+        createRenderPass();
+
+        if (m_shaderManager)
+        {
+            m_shaderManager->createAllPipelines();
+
+            // Already stalled, finish the pipelines now instead of skipping draws
+            m_pipelineCompiler->waitIdle();
+        }
+    }
 
-    createSwapChain();
-    createImageViews();
-    createRenderPass();
     // Don't recreate descriptor set layout, pipeline layout, or descriptor pool
     // They are persistent and don't depend on swap chain
     createDepthResources();
-    createFramebuffers();
+    if (!m_dynamicRendering)
+    {
+        createFramebuffers();
+    }
+
+    // No frame has used the new images or their semaphores yet
+    m_imageFrameNumbers.assign(m_swapChainImages.size(), 0);
+    recreateRenderFinishedSemaphores();
+    return true;
+}
 
-    // Reset image-in-flight tracking for new swapchain
-    m_imagesInFlight.clear();
-    m_imagesInFlight.resize(m_swapChainImages.size(), VK_NULL_HANDLE);
+void Renderer::releaseRetiredSwapChains()
+{
+    // Also waits for the frame just submitted, which may still use the old semaphores
+    for (VkSemaphore semaphore : m_retiredPresentSemaphores)
+    {
+        queueDeferredDeletion(DeferredDeletion::Type::Semaphore, reinterpret_cast<uint64_t>(semaphore));
+    }
+    m_retiredPresentSemaphores.clear();
 
-    // Recreate pipelines for all loaded shaders
-    if (m_shaderManager)
+    for (VkSwapchainKHR swapChain : m_retiredSwapChains)
+    {
+        queueDeferredDeletion(DeferredDeletion::Type::Swapchain, reinterpret_cast<uint64_t>(swapChain));
+    }
+    m_retiredSwapChains.clear();
+}
+
+void Renderer::retireSwapChainResources()
+{
+    for (auto framebuffer : m_swapChainFramebuffers)
+    {
+        queueDeferredDeletion(DeferredDeletion::Type::Framebuffer, reinterpret_cast<uint64_t>(framebuffer));
+    }
+    m_swapChainFramebuffers.clear();
+
+    queueDeferredDeletion(DeferredDeletion::Type::ImageView, reinterpret_cast<uint64_t>(m_depthImageView));
+    queueDeferredDeletion(DeferredDeletion::Type::Image, reinterpret_cast<uint64_t>(m_depthImage));
+    queueDeferredDeletion(DeferredDeletion::Type::Allocation, 0, m_depthAllocation);
+    m_depthImageView = VK_NULL_HANDLE;
+    m_depthImage = VK_NULL_HANDLE;
+    m_depthAllocation = {};
+
+    for (auto imageView : m_swapChainImageViews)
     {
-        m_shaderManager->createAllPipelines(m_renderPass, m_pipelineLayout, m_swapChainExtent);
-        LOG_INFO("[Vulkan] Recreated all pipelines after swap chain recreation");
+        queueDeferredDeletion(DeferredDeletion::Type::ImageView, reinterpret_cast<uint64_t>(imageView));
     }
+    m_swapChainImageViews.clear();
+
+    // The swapchain itself is retired by createSwapChain() once its successor exists
 }
 
 bool Renderer::isDeviceSuitable(VkPhysicalDevice device)
@@ -1153,14 +2169,32 @@ bool Renderer::isDeviceSuitable(VkPhysicalDevice device)
 
     bool extensionsSupported = checkDeviceExtensionSupport(device);
 
-    bool swapChainAdequate = false;
-    if (extensionsSupported)
+    bool swapChainAdequate = m_headless;
+    if (extensionsSupported && !m_headless)
     {
         SwapChainSupportDetails swapChainSupport = querySwapChainSupport(device);
         swapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
     }
 
-    return indices.isComplete() && extensionsSupported && swapChainAdequate;
+    // Frame pacing requires Vulkan 1.2 timeline semaphores
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(device, &properties);
+
+    bool timelineSupported = false;
+    if (properties.apiVersion >= VK_API_VERSION_1_2)
+    {
+        VkPhysicalDeviceVulkan12Features features12{};
+        features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+        VkPhysicalDeviceFeatures2 features{};
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features.pNext = &features12;
+        vkGetPhysicalDeviceFeatures2(device, &features);
+
+        timelineSupported = features12.timelineSemaphore == VK_TRUE;
+    }
+
+    return indices.isComplete() && extensionsSupported && swapChainAdequate && timelineSupported;
 }
 
 QueueFamilyIndices Renderer::findQueueFamilies(VkPhysicalDevice device)
@@ -1181,12 +2215,20 @@ QueueFamilyIndices Renderer::findQueueFamilies(VkPhysicalDevice device)
             indices.graphicsFamily = i;
         }
 
-        VkBool32 presentSupport = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_surface, &presentSupport);
-
-        if (presentSupport)
+        if (m_headless)
+        {
+            // Nothing is presented, the graphics family stands in for the present family
+            indices.presentFamily = indices.graphicsFamily;
+        }
+        else
         {
-            indices.presentFamily = i;
+            VkBool32 presentSupport = false;
+            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_surface, &presentSupport);
+
+            if (presentSupport)
+            {
+                indices.presentFamily = i;
+            }
         }
 
         if (indices.isComplete())
@@ -1197,6 +2239,36 @@ QueueFamilyIndices Renderer::findQueueFamilies(VkPhysicalDevice device)
         i++;
     }
 
+    // Prefer a transfer-only family (DMA engine), then any non-graphics family with transfer
+    for (uint32_t family = 0; family < queueFamilyCount; family++)
+    {
+        VkQueueFlags flags = queueFamilies[family].queueFlags;
+        if ((flags & VK_QUEUE_TRANSFER_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT) && !(flags & VK_QUEUE_COMPUTE_BIT))
+        {
+            indices.transferFamily = family;
+            break;
+        }
+    }
+
+    if (indices.transferFamily == UINT32_MAX)
+    {
+        for (uint32_t family = 0; family < queueFamilyCount; family++)
+        {
+            VkQueueFlags flags = queueFamilies[family].queueFlags;
+            if ((flags & VK_QUEUE_TRANSFER_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT))
+            {
+                indices.transferFamily = family;
+                break;
+            }
+        }
+    }
+
+    // Fall back to the graphics queue, graphics queues always support transfers
+    if (indices.transferFamily == UINT32_MAX)
+    {
+        indices.transferFamily = indices.graphicsFamily;
+    }
+
     return indices;
 }
 
@@ -1208,7 +2280,8 @@ bool Renderer::checkDeviceExtensionSupport(VkPhysicalDevice device)
     std::vector<VkExtensionProperties> availableExtensions(extensionCount);
     vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
 
-    std::set<std::string> requiredExtensions(m_deviceExtensions.begin(), m_deviceExtensions.end());
+    std::vector<const char*> deviceExtensions = getRequiredDeviceExtensions();
+    std::set<std::string> requiredExtensions(deviceExtensions.begin(), deviceExtensions.end());
 
     for (const auto& extension : availableExtensions)
     {
@@ -1218,13 +2291,83 @@ bool Renderer::checkDeviceExtensionSupport(VkPhysicalDevice device)
     return requiredExtensions.empty();
 }
 
-SwapChainSupportDetails Renderer::querySwapChainSupport(VkPhysicalDevice device)
+std::vector<const char*> Renderer::getRequiredDeviceExtensions() const
 {
-    SwapChainSupportDetails details;
+    // Headless rendering never presents
+    if (m_headless)
+    {
+        return {};
+    }
+    return m_deviceExtensions;
+}
 
-    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, m_surface, &details.capabilities);
+void Renderer::loadDynamicStateFunctions(bool dynamicRasterState, bool dynamicBlendEnable)
+{
+    m_dynamicState = DynamicStateFunctions{};
 
-    uint32_t formatCount;
+    if (dynamicRasterState)
+    {
+        // Core 1.3 names, the EXT aliases are used where only the extension is enabled
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+        bool core = properties.apiVersion >= VK_API_VERSION_1_3;
+
+        m_dynamicState.setCullMode = reinterpret_cast<PFN_vkCmdSetCullModeEXT>(
+            vkGetDeviceProcAddr(m_device, core ? "vkCmdSetCullMode" : "vkCmdSetCullModeEXT"));
+        m_dynamicState.setFrontFace = reinterpret_cast<PFN_vkCmdSetFrontFaceEXT>(
+            vkGetDeviceProcAddr(m_device, core ? "vkCmdSetFrontFace" : "vkCmdSetFrontFaceEXT"));
+        m_dynamicState.setDepthTestEnable = reinterpret_cast<PFN_vkCmdSetDepthTestEnableEXT>(
+            vkGetDeviceProcAddr(m_device, core ? "vkCmdSetDepthTestEnable" : "vkCmdSetDepthTestEnableEXT"));
+        m_dynamicState.setDepthWriteEnable = reinterpret_cast<PFN_vkCmdSetDepthWriteEnableEXT>(
+            vkGetDeviceProcAddr(m_device, core ? "vkCmdSetDepthWriteEnable" : "vkCmdSetDepthWriteEnableEXT"));
+
+        // All or nothing, a partial set would leave pipelines with unset dynamic state
+        if (!m_dynamicState.setCullMode || !m_dynamicState.setFrontFace ||
+            !m_dynamicState.setDepthTestEnable || !m_dynamicState.setDepthWriteEnable)
+        {
+            m_dynamicState.setCullMode = nullptr;
+            m_dynamicState.setFrontFace = nullptr;
+            m_dynamicState.setDepthTestEnable = nullptr;
+            m_dynamicState.setDepthWriteEnable = nullptr;
+        }
+    }
+
+    if (dynamicBlendEnable)
+    {
+        m_dynamicState.setColorBlendEnable = reinterpret_cast<PFN_vkCmdSetColorBlendEnableEXT>(
+            vkGetDeviceProcAddr(m_device, "vkCmdSetColorBlendEnableEXT"));
+    }
+
+    LOG_INFO("[Vulkan] Dynamic depth/cull state: {}, dynamic blend enable: {}",
+             m_dynamicState.hasDynamicRasterState() ? "yes" : "no (pipeline variants)",
+             m_dynamicState.hasDynamicBlendEnable() ? "yes" : "no (pipeline variants)");
+}
+
+bool Renderer::isDeviceExtensionSupported(VkPhysicalDevice device, const char* extensionName)
+{
+    uint32_t extensionCount;
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+
+    for (const auto& extension : availableExtensions)
+    {
+        if (std::strcmp(extension.extensionName, extensionName) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+SwapChainSupportDetails Renderer::querySwapChainSupport(VkPhysicalDevice device)
+{
+    SwapChainSupportDetails details;
+
+    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, m_surface, &details.capabilities);
+
+    uint32_t formatCount;
     vkGetPhysicalDeviceSurfaceFormatsKHR(device, m_surface, &formatCount, nullptr);
 
     if (formatCount != 0)
@@ -1263,17 +2406,63 @@ VkSurfaceFormatKHR Renderer::chooseSwapSurfaceFormat(const std::vector<VkSurface
 
 VkPresentModeKHR Renderer::chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes)
 {
+    VkPresentModeKHR requested = VK_PRESENT_MODE_FIFO_KHR;
+    switch (m_presentMode)
+    {
+        case PresentMode::Fifo:        requested = VK_PRESENT_MODE_FIFO_KHR; break;
+        case PresentMode::FifoRelaxed: requested = VK_PRESENT_MODE_FIFO_RELAXED_KHR; break;
+        case PresentMode::Mailbox:     requested = VK_PRESENT_MODE_MAILBOX_KHR; break;
+        case PresentMode::Immediate:   requested = VK_PRESENT_MODE_IMMEDIATE_KHR; break;
+    }
+
     for (const auto& availablePresentMode : availablePresentModes)
     {
-        if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR)
+        if (availablePresentMode == requested)
         {
             return availablePresentMode;
         }
     }
 
+    // FIFO is the only mode every surface supports
+    LOG_INFO("[Vulkan] {} present mode not supported by the surface, using FIFO", presentModeName(requested));
     return VK_PRESENT_MODE_FIFO_KHR;
 }
 
+uint32_t Renderer::chooseSwapImageCount(const VkSurfaceCapabilitiesKHR& capabilities)
+{
+    uint32_t imageCount = m_swapchainImageCount != 0 ? m_swapchainImageCount : capabilities.minImageCount + 1;
+    uint32_t maxImageCount = capabilities.maxImageCount > 0 ? capabilities.maxImageCount : UINT32_MAX;
+    uint32_t clamped = std::clamp(imageCount, capabilities.minImageCount, maxImageCount);
+
+    if (m_swapchainImageCount != 0 && clamped != imageCount)
+    {
+        LOG_WARNING("[Vulkan] Surface supports {} to {} swapchain images, using {}",
+                    capabilities.minImageCount, capabilities.maxImageCount, clamped);
+    }
+    return clamped;
+}
+
+void Renderer::recreateRenderFinishedSemaphores()
+{
+    // Presents of the old swapchain may still wait on the old semaphores
+    m_retiredPresentSemaphores.insert(m_retiredPresentSemaphores.end(),
+                                      m_renderFinishedSemaphores.begin(), m_renderFinishedSemaphores.end());
+
+    // One per image of the new swapchain, whose count may differ from the old one
+    m_renderFinishedSemaphores.assign(m_swapChainImages.size(), VK_NULL_HANDLE);
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+    for (size_t i = 0; i < m_renderFinishedSemaphores.size(); i++)
+    {
+        if (vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &m_renderFinishedSemaphores[i]) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create semaphores");
+        }
+    }
+}
+
 VkExtent2D Renderer::chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities)
 {
     if (capabilities.currentExtent.width != UINT32_MAX)
@@ -1386,131 +2575,367 @@ bool Renderer::hasStencilComponent(VkFormat format)
 
 void Renderer::beginFrame()
 {
-    // Use the shader set by ShaderProgram::bind()
-    if (!m_currentShader || m_currentShader->getPipeline() == VK_NULL_HANDLE)
+    if (m_frameBegun)
     {
-        LOG_WARNING("[Vulkan] No valid shader/pipeline bound - skipping frame");
+        LOG_WARNING("[Vulkan] beginFrame() called twice without endFrame()");
         return;
     }
 
-    ShaderProgram* currentShader = m_currentShader;
+    waitForFrameLimit();
 
-    VkPipeline currentPipeline = currentShader->getPipeline();
+    uint64_t frameNumber = m_frameNumber + 1;
+
+    // Limit frames in flight: the frame m_framesInFlight before this one must have completed
+    if (frameNumber > m_framesInFlight)
+    {
+        waitForFrame(frameNumber - m_framesInFlight);
+    }
 
-    // Wait for the current frame's fence (limits frames in flight)
-    vkWaitForFences(m_device, 1, &m_inFlightFences[m_currentFrame], VK_TRUE, UINT64_MAX);
+    // The slot may have been used by a later frame if the depth was lowered at runtime
+    waitForFrame(m_frameSlotNumbers[m_currentFrame]);
 
-    // Acquire next image from swapchain
-    // We use currentFrame to index the acquire semaphore for now, but after we know
-    // which image we got, we'll use image-indexed semaphores for rendering
-    VkResult result = vkAcquireNextImageKHR(m_device, m_swapChain, UINT64_MAX,
-                                             m_imageAvailableSemaphores[m_currentFrame % m_imageAvailableSemaphores.size()],
-                                             VK_NULL_HANDLE, &m_imageIndex);
+    // The slot's previous frame has completed, its transient descriptor sets can be reset
+    m_descriptorAllocator->beginFrame(m_currentFrame, getCompletedFrameNumber());
+    m_uniformRing->beginFrame(m_currentFrame);
+    m_lastUniformShader = nullptr;
 
-    if (result == VK_ERROR_OUT_OF_DATE_KHR)
+    if (m_headless)
     {
-        recreateSwapChain();
-        return;
+        // Each frame slot renders into its own offscreen target
+        m_imageIndex = m_currentFrame;
     }
-    else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+    else
     {
-        throw std::runtime_error("Failed to acquire swap chain image");
-    }
+        if (m_swapChainRecreatePending && !recreateSwapChain())
+        {
+            // Still minimized, skip this frame
+            return;
+        }
 
-    // Check if this image is already in use by a previous frame
-    // If so, wait for that frame's fence to complete
-    if (m_imagesInFlight[m_imageIndex] != VK_NULL_HANDLE)
-    {
-        vkWaitForFences(m_device, 1, &m_imagesInFlight[m_imageIndex], VK_TRUE, UINT64_MAX);
+        // Acquire next image from swapchain
+        // The acquire semaphore is indexed by frame slot, after we know which image
+        // we got, we'll use image-indexed semaphores for rendering
+        auto acquireStart = std::chrono::steady_clock::now();
+        VkResult result = vkAcquireNextImageKHR(m_device, m_swapChain, UINT64_MAX,
+                                                 m_imageAvailableSemaphores[m_currentFrame],
+                                                 VK_NULL_HANDLE, &m_imageIndex);
+        m_imageAcquiredTime = std::chrono::steady_clock::now();
+        m_pendingPresentTiming.acquireMilliseconds =
+            std::chrono::duration<double, std::milli>(m_imageAcquiredTime - acquireStart).count();
+
+        if (result == VK_ERROR_OUT_OF_DATE_KHR)
+        {
+            // Skip this frame - passes and draws are ignored until the next beginFrame()
+            recreateSwapChain();
+            return;
+        }
+        else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+        {
+            throw std::runtime_error("Failed to acquire swap chain image");
+        }
     }
 
-    // Mark this image as now being used by the current frame
-    m_imagesInFlight[m_imageIndex] = m_inFlightFences[m_currentFrame];
+    // Check if this image is still being rendered by a previous frame
+    waitForFrame(m_imageFrameNumbers[m_imageIndex]);
 
-    // Only reset the fence right before using it
-    vkResetFences(m_device, 1, &m_inFlightFences[m_currentFrame]);
+    // Mark this image and slot as now being used by the current frame
+    m_imageFrameNumbers[m_imageIndex] = frameNumber;
+    m_frameSlotNumbers[m_currentFrame] = frameNumber;
 
     vkResetCommandBuffer(m_commandBuffers[m_currentFrame], 0);
+    if (m_parallelRecorder)
+    {
+        m_parallelRecorder->beginFrame(m_currentFrame);
+    }
 
     VkCommandBufferBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
     if (vkBeginCommandBuffer(m_commandBuffers[m_currentFrame], &beginInfo) != VK_SUCCESS)
     {
         throw std::runtime_error("Failed to begin recording command buffer");
     }
 
-    VkRenderPassBeginInfo renderPassInfo{};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassInfo.renderPass = m_renderPass;
-    renderPassInfo.framebuffer = m_swapChainFramebuffers[m_imageIndex];
-    renderPassInfo.renderArea.offset = {0, 0};
-    renderPassInfo.renderArea.extent = m_swapChainExtent;
+    // Updates made between frames
+    recordBufferUpdates(m_commandBuffers[m_currentFrame]);
 
-    std::array<VkClearValue, 2> clearValues{};
-    clearValues[0].color = {{m_clearColor.r, m_clearColor.g, m_clearColor.b, m_clearColor.a}};
-    clearValues[1].depthStencil = {1.0f, 0};
+    // Mark that the frame was successfully begun
+    m_frameBegun = true;
+    m_frameRendered = false;
+    m_clearPending = false;
+    m_framePassCount = 0;
+
+    if (m_gpuProfiler)
+    {
+        bool collectStatistics = m_pipelineStatisticsEnabled && (m_inheritedQueriesSupported || !m_parallelRecorder);
+        m_gpuProfiler->beginFrame(m_currentFrame, m_commandBuffers[m_currentFrame], collectStatistics);
+        m_gpuProfiler->beginZone(m_commandBuffers[m_currentFrame], "Frame");
+    }
+}
 
-    renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-    renderPassInfo.pClearValues = clearValues.data();
+void Renderer::beginPass()
+{
+    // Skip if frame wasn't successfully begun (e.g., swapchain out of date)
+    if (!m_frameBegun)
+    {
+        return;
+    }
 
-    vkCmdBeginRenderPass(m_commandBuffers[m_currentFrame], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    if (m_passBegun)
+    {
+        LOG_WARNING("[Vulkan] beginPass() called while a pass is already active");
+        return;
+    }
 
-    // Bind the pipeline (we already checked it's valid)
-    vkCmdBindPipeline(m_commandBuffers[m_currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, currentPipeline);
+    VkCommandBuffer commandBuffer = m_commandBuffers[m_currentFrame];
 
-    // Bind texture descriptor set if a texture is bound
-    if (m_currentTexture && m_currentTexture->getDescriptorSet() != VK_NULL_HANDLE)
+    // Timestamps can't be written into the primary inside a pass of secondary command buffers,
+    // so the pass zone brackets the render pass
+    if (m_gpuProfiler)
     {
-        VkDescriptorSet descriptorSet = m_currentTexture->getDescriptorSet();
-        vkCmdBindDescriptorSets(
-            m_commandBuffers[m_currentFrame],
-            VK_PIPELINE_BIND_POINT_GRAPHICS,
-            m_pipelineLayout,
-            0, // first set
-            1, // descriptor set count
-            &descriptorSet,
-            0, nullptr // dynamic offsets
-        );
-        //LOG_DEBUG("[Vulkan] Texture descriptor set bound");
+        m_passZoneDepth = m_gpuProfiler->getOpenZoneCount();
+        m_gpuProfiler->beginZone(commandBuffer, "Pass " + std::to_string(m_framePassCount));
     }
+    m_framePassCount++;
 
     // Set dynamic viewport with Y-axis flip to match OpenGL convention
-    VkViewport viewport{};
-    viewport.x = 0.0f;
-    viewport.y = (float)m_swapChainExtent.height;
-    viewport.width = (float)m_swapChainExtent.width;
-    viewport.height = -(float)m_swapChainExtent.height;
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-    vkCmdSetViewport(m_commandBuffers[m_currentFrame], 0, 1, &viewport);
+    m_passViewport = {};
+    m_passViewport.x = 0.0f;
+    m_passViewport.y = (float)m_swapChainExtent.height;
+    m_passViewport.width = (float)m_swapChainExtent.width;
+    m_passViewport.height = -(float)m_swapChainExtent.height;
+    m_passViewport.minDepth = 0.0f;
+    m_passViewport.maxDepth = 1.0f;
 
     // Set dynamic scissor
-    VkRect2D scissor{};
-    scissor.offset = {0, 0};
-    scissor.extent = m_swapChainExtent;
-    vkCmdSetScissor(m_commandBuffers[m_currentFrame], 0, 1, &scissor);
+    m_passScissor = {};
+    m_passScissor.offset = {0, 0};
+    m_passScissor.extent = m_swapChainExtent;
+
+    // With worker threads the pass only executes secondary command buffers
+    m_passRecordsSecondaries = m_parallelRecorder != nullptr;
+    m_passDraws.clear();
 
-    // Push constants for transformation matrices
-    if (currentShader && currentShader->hasPendingUpdates())
+    // Later passes draw over the earlier ones unless clear() was called in between
+    beginPassAttachments(commandBuffer, !m_frameRendered || m_clearPending);
+    m_clearPending = false;
+
+    m_passBegun = true;
+    m_frameRendered = true;
+}
+
+void Renderer::endPass()
+{
+    if (!m_passBegun)
     {
-        const PushConstantData& pushConstants = currentShader->getPushConstants();
-        vkCmdPushConstants(
-            m_commandBuffers[m_currentFrame],
-            m_pipelineLayout,
-            VK_SHADER_STAGE_VERTEX_BIT,
-            0,
-            sizeof(PushConstantData),
-            &pushConstants
-        );
-        currentShader->clearPendingUpdates();
+        return;
     }
 
-    // Note: Vertex buffer binding is now handled in drawArrays/drawElements via the VAO system
-    // The old m_vertexBuffer from initializeVertexBuffer() is no longer used
+    VkCommandBuffer commandBuffer = m_commandBuffers[m_currentFrame];
 
-    // Mark that the frame was successfully begun
-    m_frameBegun = true;
+    endPassAttachments(commandBuffer);
+    m_passBegun = false;
+
+    // Updates made after the pass's last draw
+    recordBufferUpdates(commandBuffer);
+
+    // Zones left open in the pass end with it
+    if (m_gpuProfiler)
+    {
+        while (m_gpuProfiler->getOpenZoneCount() > m_passZoneDepth)
+        {
+            m_gpuProfiler->endZone(commandBuffer);
+        }
+    }
+    m_ignoredGpuZones = 0;
+}
+
+void Renderer::beginPassAttachments(VkCommandBuffer commandBuffer, bool clear)
+{
+    std::array<VkClearValue, 2> clearValues{};
+    clearValues[0].color = {{m_clearColor.r, m_clearColor.g, m_clearColor.b, m_clearColor.a}};
+    clearValues[1].depthStencil = {1.0f, 0};
+
+    if (m_dynamicRendering)
+    {
+        beginRendering(commandBuffer, clearValues, clear);
+    }
+    else
+    {
+        // Both render passes are compatible, pipelines and framebuffers use m_renderPass
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = clear ? m_renderPass : m_loadRenderPass;
+        renderPassInfo.framebuffer = m_swapChainFramebuffers[m_imageIndex];
+        renderPassInfo.renderArea.offset = {0, 0};
+        renderPassInfo.renderArea.extent = m_swapChainExtent;
+        renderPassInfo.clearValueCount = clear ? static_cast<uint32_t>(clearValues.size()) : 0;
+        renderPassInfo.pClearValues = clear ? clearValues.data() : nullptr;
+
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo,
+                             m_passRecordsSecondaries ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS
+                                                      : VK_SUBPASS_CONTENTS_INLINE);
+    }
+
+    if (!m_passRecordsSecondaries)
+    {
+        vkCmdSetViewport(commandBuffer, 0, 1, &m_passViewport);
+        vkCmdSetScissor(commandBuffer, 0, 1, &m_passScissor);
+    }
+
+    // Nothing is bound in a freshly begun render pass
+    m_bindState = CommandBindState();
+    m_passCleared = clear;
+}
+
+void Renderer::endPassAttachments(VkCommandBuffer commandBuffer)
+{
+    if (m_passRecordsSecondaries && !m_passDraws.empty())
+    {
+        VkCommandBufferInheritanceInfo inheritanceInfo{};
+        inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritanceInfo.subpass = 0;
+
+        // Secondaries continuing dynamic rendering inherit the attachment formats instead
+        VkCommandBufferInheritanceRenderingInfoKHR renderingInheritance{};
+        renderingInheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO_KHR;
+        renderingInheritance.colorAttachmentCount = 1;
+        renderingInheritance.pColorAttachmentFormats = &m_swapChainImageFormat;
+        renderingInheritance.depthAttachmentFormat = m_depthFormat;
+        renderingInheritance.stencilAttachmentFormat = VK_FORMAT_UNDEFINED;
+        renderingInheritance.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+        if (m_dynamicRendering)
+        {
+            inheritanceInfo.pNext = &renderingInheritance;
+        }
+        else
+        {
+            inheritanceInfo.renderPass = m_renderPass;
+            inheritanceInfo.framebuffer = m_swapChainFramebuffers[m_imageIndex];
+        }
+        inheritanceInfo.pipelineStatistics = m_gpuProfiler ? m_gpuProfiler->getActiveStatisticsFlags() : 0;
+
+        m_parallelRecorder->record(m_currentFrame, m_passDraws, inheritanceInfo,
+                                   m_passViewport, m_passScissor, m_secondaryCommandBuffers);
+
+        if (!m_secondaryCommandBuffers.empty())
+        {
+            vkCmdExecuteCommands(commandBuffer,
+                                 static_cast<uint32_t>(m_secondaryCommandBuffers.size()),
+                                 m_secondaryCommandBuffers.data());
+        }
+    }
+    m_passDraws.clear();
+
+    if (m_dynamicRendering)
+    {
+        m_cmdEndRendering(commandBuffer);
+    }
+    else
+    {
+        vkCmdEndRenderPass(commandBuffer);
+    }
+}
+
+void Renderer::beginRendering(VkCommandBuffer commandBuffer, const std::array<VkClearValue, 2>& clearValues, bool clear)
+{
+    // A clearing pass discards the previous contents like the render pass's UNDEFINED
+    // initial layouts. A loading pass finds both attachments where the previous pass left them.
+    std::array<VkImageMemoryBarrier, 2> barriers{};
+    barriers[0].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barriers[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    barriers[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    barriers[0].oldLayout = clear ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    barriers[0].newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    barriers[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barriers[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barriers[0].image = m_swapChainImages[m_imageIndex];
+    barriers[0].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barriers[0].subresourceRange.levelCount = 1;
+    barriers[0].subresourceRange.layerCount = 1;
+
+    // The depth image is shared by every frame, the previous pass's writes must be done
+    barriers[1].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barriers[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    barriers[1].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    barriers[1].oldLayout = clear ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    barriers[1].newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    barriers[1].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barriers[1].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barriers[1].image = m_depthImage;
+    barriers[1].subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+    if (hasStencilComponent(m_depthFormat))
+    {
+        barriers[1].subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+    barriers[1].subresourceRange.levelCount = 1;
+    barriers[1].subresourceRange.layerCount = 1;
+
+    // Color waits on the image acquire, which the submit signals at color attachment output
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                         VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &barriers[0]);
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                         VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &barriers[1]);
+
+    VkAttachmentLoadOp loadOp = clear ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+
+    VkRenderingAttachmentInfoKHR colorAttachment{};
+    colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+    colorAttachment.imageView = m_swapChainImageViews[m_imageIndex];
+    colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.loadOp = loadOp;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.clearValue = clearValues[0];
+
+    // Depth is stored for the passes after this one
+    VkRenderingAttachmentInfoKHR depthAttachment{};
+    depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+    depthAttachment.imageView = m_depthImageView;
+    depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depthAttachment.loadOp = loadOp;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    depthAttachment.clearValue = clearValues[1];
+
+    VkRenderingInfoKHR renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+    renderingInfo.flags = m_passRecordsSecondaries ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT_KHR : 0;
+    renderingInfo.renderArea.offset = {0, 0};
+    renderingInfo.renderArea.extent = m_swapChainExtent;
+    renderingInfo.layerCount = 1;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachments = &colorAttachment;
+    renderingInfo.pDepthAttachment = &depthAttachment;
+
+    m_cmdBeginRendering(commandBuffer, &renderingInfo);
+}
+
+void Renderer::transitionColorTargetForFrameEnd(VkCommandBuffer commandBuffer)
+{
+    // Passes leave the color target an attachment for the next one, once the frame is
+    // done it goes to presentation or, headless, to the readback copy
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    barrier.dstAccessMask = m_headless ? VK_ACCESS_TRANSFER_READ_BIT : 0;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    barrier.newLayout = m_headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = m_swapChainImages[m_imageIndex];
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                         m_headless ? VK_PIPELINE_STAGE_TRANSFER_BIT : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &barrier);
 }
 
 void Renderer::endFrame()
@@ -1521,7 +2946,30 @@ void Renderer::endFrame()
         return;
     }
 
-    vkCmdEndRenderPass(m_commandBuffers[m_currentFrame]);
+    // Close a pass the application forgot to end so the command buffer stays valid
+    if (m_passBegun)
+    {
+        LOG_WARNING("[Vulkan] endFrame() called inside an active pass - ending it");
+        endPass();
+    }
+
+    uint64_t frameNumber = m_frameNumber + 1;
+
+    if (m_frameRendered)
+    {
+        transitionColorTargetForFrameEnd(m_commandBuffers[m_currentFrame]);
+    }
+
+    // A frame without a pass leaves the target undefined, there is nothing to read back
+    if (m_headless && m_readbackEnabled && m_frameRendered)
+    {
+        recordReadback(m_commandBuffers[m_currentFrame], frameNumber);
+    }
+
+    if (m_gpuProfiler)
+    {
+        m_gpuProfiler->endFrame(m_commandBuffers[m_currentFrame]);
+    }
 
     if (vkEndCommandBuffer(m_commandBuffers[m_currentFrame]) != VK_SUCCESS)
     {
@@ -1531,212 +2979,1079 @@ void Renderer::endFrame()
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
+    VkSemaphore waitSemaphores[2];
+    VkPipelineStageFlags waitStages[2];
+    uint64_t waitValues[2];
+    uint32_t waitCount = 0;
+
     // Wait on the imageAvailable semaphore for the acquired image
     // Use currentFrame modulo to cycle through available semaphores
-    VkSemaphore waitSemaphores[] = {m_imageAvailableSemaphores[m_currentFrame % m_imageAvailableSemaphores.size()]};
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    submitInfo.waitSemaphoreCount = 1;
+    if (!m_headless)
+    {
+        waitSemaphores[waitCount] = m_imageAvailableSemaphores[m_currentFrame];
+        waitStages[waitCount] = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        waitValues[waitCount++] = 0;
+    }
+
+    // Wait for uploads submitted since the previous frame so their data is visible
+    if (m_uploadValue > m_uploadWaitValue)
+    {
+        waitSemaphores[waitCount] = m_uploadTimeline;
+        waitStages[waitCount] = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        waitValues[waitCount++] = m_uploadValue;
+        m_uploadWaitValue = m_uploadValue;
+    }
+
+    submitInfo.waitSemaphoreCount = waitCount;
     submitInfo.pWaitSemaphores = waitSemaphores;
     submitInfo.pWaitDstStageMask = waitStages;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &m_commandBuffers[m_currentFrame];
+
+    // Ownership acquires for uploaded resources run ahead of the frame's commands
+    VkCommandBuffer commandBuffers[2];
+    uint32_t commandBufferCount = 0;
+    VkCommandBuffer acquireCommandBuffer = recordOwnershipAcquires();
+    if (acquireCommandBuffer != VK_NULL_HANDLE)
+    {
+        commandBuffers[commandBufferCount++] = acquireCommandBuffer;
+    }
+    commandBuffers[commandBufferCount++] = m_commandBuffers[m_currentFrame];
+    submitInfo.commandBufferCount = commandBufferCount;
+    submitInfo.pCommandBuffers = commandBuffers;
+
+    // The timeline semaphore is signaled with the frame number for frame pacing
+    VkSemaphore signalSemaphores[2];
+    uint64_t signalValues[2];
+    uint32_t signalCount = 0;
+    signalSemaphores[signalCount] = m_frameTimeline;
+    signalValues[signalCount++] = frameNumber;
 
     // Signal the renderFinished semaphore indexed by the swapchain image
     // This ensures each image has its own semaphore and avoids reuse while in presentation
-    VkSemaphore signalSemaphores[] = {m_renderFinishedSemaphores[m_imageIndex]};
-    submitInfo.signalSemaphoreCount = 1;
+    if (!m_headless)
+    {
+        signalSemaphores[signalCount] = m_renderFinishedSemaphores[m_imageIndex];
+        signalValues[signalCount++] = 0;
+    }
+    submitInfo.signalSemaphoreCount = signalCount;
     submitInfo.pSignalSemaphores = signalSemaphores;
 
-    if (vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, m_inFlightFences[m_currentFrame]) != VK_SUCCESS)
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount = submitInfo.waitSemaphoreCount;
+    timelineInfo.pWaitSemaphoreValues = waitValues;
+    timelineInfo.signalSemaphoreValueCount = signalCount;
+    timelineInfo.pSignalSemaphoreValues = signalValues;
+    submitInfo.pNext = &timelineInfo;
+
+    if (vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
     {
         throw std::runtime_error("Failed to submit draw command buffer");
     }
 
-    VkPresentInfoKHR presentInfo{};
-    presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-    presentInfo.waitSemaphoreCount = 1;
-    presentInfo.pWaitSemaphores = signalSemaphores;
+    m_frameNumber = frameNumber;
 
-    VkSwapchainKHR swapChains[] = {m_swapChain};
-    presentInfo.swapchainCount = 1;
-    presentInfo.pSwapchains = swapChains;
-    presentInfo.pImageIndices = &m_imageIndex;
-
-    VkResult result = vkQueuePresentKHR(m_presentQueue, &presentInfo);
+    // Reset frame begun flag before a possible swapchain recreation
+    m_frameBegun = false;
 
-    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || m_framebufferResized)
+    if (!m_headless)
     {
-        m_framebufferResized = false;
-        recreateSwapChain();
-    }
-    else if (result != VK_SUCCESS)
-    {
-        throw std::runtime_error("Failed to present swap chain image");
+        VkPresentInfoKHR presentInfo{};
+        presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+        presentInfo.waitSemaphoreCount = 1;
+        presentInfo.pWaitSemaphores = &m_renderFinishedSemaphores[m_imageIndex];
+
+        VkSwapchainKHR swapChains[] = {m_swapChain};
+        presentInfo.swapchainCount = 1;
+        presentInfo.pSwapchains = swapChains;
+        presentInfo.pImageIndices = &m_imageIndex;
+
+        VkResult result = vkQueuePresentKHR(m_presentQueue, &presentInfo);
+
+        m_pendingPresentTiming.acquireToPresentMilliseconds =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_imageAcquiredTime).count();
+        m_presentTiming = m_pendingPresentTiming;
+        m_presentTimingValid = true;
+
+        // Resize events of the whole frame are coalesced into this one check, and only
+        // recreate the swapchain if the framebuffer size really differs from it
+        bool resized = false;
+        if (m_framebufferResized)
+        {
+            int width = 0, height = 0;
+            glfwGetFramebufferSize(m_window, &width, &height);
+            resized = static_cast<uint32_t>(width) != m_swapChainExtent.width ||
+                      static_cast<uint32_t>(height) != m_swapChainExtent.height;
+            m_framebufferResized = false;
+        }
+
+        // An image of the current swapchain was queued for presentation, so the
+        // present engine has moved on from the swapchains it replaced
+        if (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR)
+        {
+            releaseRetiredSwapChains();
+        }
+
+        if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR ||
+            resized || m_presentSettingsChanged)
+        {
+            recreateSwapChain();
+        }
+        else if (result != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to present swap chain image");
+        }
     }
 
-    m_currentFrame = (m_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+    m_currentFrame = static_cast<uint32_t>(m_frameNumber % m_framesInFlight);
 
     // Process deferred deletions for resources that are no longer in use
-    processDeferredDeletions();
-
-    // Reset frame begun flag
-    m_frameBegun = false;
+    processDeferredDeletions(getCompletedFrameNumber());
+    m_stagingRing->reclaim(getCompletedUploadValue(), getCompletedFrameNumber());
 }
 
-void Renderer::setClearColor(float r, float g, float b, float a)
+void Renderer::beginGpuZone(const char* name)
 {
-    m_clearColor = glm::vec4(r, g, b, a);
-}
+    if (!m_gpuProfiler || !m_frameBegun)
+    {
+        return;
+    }
 
-void Renderer::setClearColor(const glm::vec4& color)
-{
-    m_clearColor = color;
-}
+    // The pass's draws are recorded by the workers in endPass(), only the pass zone is timed
+    if (m_passBegun && m_passRecordsSecondaries)
+    {
+        m_ignoredGpuZones++;
+        return;
+    }
 
-void Renderer::clear()
-{
-    // Don't begin frame here - let drawArrays/drawElements call it
-    // This allows shaders to be bound before beginFrame() is called
+    m_gpuProfiler->beginZone(m_commandBuffers[m_currentFrame], name);
 }
 
-void Renderer::setViewport(int x, int y, int width, int height)
+void Renderer::endGpuZone()
 {
-    m_framebufferResized = true;
-}
+    if (!m_gpuProfiler || !m_frameBegun)
+    {
+        return;
+    }
 
-void Renderer::getRenderDimensions(int& width, int& height) const
-{
-    width = static_cast<int>(m_swapChainExtent.width);
-    height = static_cast<int>(m_swapChainExtent.height);
-}
+    if (m_ignoredGpuZones > 0)
+    {
+        m_ignoredGpuZones--;
+        return;
+    }
 
-void Renderer::enableDepthTest(bool enable)
-{
-    if (m_depthTestEnabled == enable)
+    // The frame zone and the pass zone are closed by the renderer
+    uint32_t rendererZones = m_passBegun ? m_passZoneDepth + 1 : 1;
+    if (m_gpuProfiler->getOpenZoneCount() <= rendererZones || (m_passBegun && m_passRecordsSecondaries))
     {
-        return; // No change
+        LOG_WARNING("[Vulkan] endGpuZone() without a matching beginGpuZone() in the same pass");
+        return;
     }
 
-    m_depthTestEnabled = enable;
-    LOG_INFO("[Vulkan] Depth testing {}", enable ? "enabled" : "disabled");
+    m_gpuProfiler->endZone(m_commandBuffers[m_currentFrame]);
+}
 
-    // Pipelines are immutable in Vulkan, so we need to recreate them
-    // with the new depth test state
-    if (m_device != VK_NULL_HANDLE && m_shaderManager)
+void Renderer::getGpuZoneTimes(std::vector<GpuZoneTime>& zones) const
+{
+    if (!m_gpuProfiler)
     {
-        vkDeviceWaitIdle(m_device);
+        zones.clear();
+        return;
+    }
 
-        // Destroy existing pipelines
-        m_shaderManager->destroyAllPipelines();
+    zones = m_gpuProfiler->getResults();
+}
 
-        // Recreate pipelines with new depth test state
-        m_shaderManager->createAllPipelines(m_renderPass, m_pipelineLayout, m_swapChainExtent);
+void Renderer::setPipelineStatisticsEnabled(bool enable)
+{
+    m_pipelineStatisticsEnabled = enable;
 
-        LOG_INFO("[Vulkan] Pipelines recreated with depth test state");
+    if (enable && m_device != VK_NULL_HANDLE && !m_pipelineStatisticsSupported)
+    {
+        LOG_WARNING("[Vulkan] Pipeline statistics queries are not supported by this device");
+    }
+    else if (enable && m_parallelRecorder && !m_inheritedQueriesSupported)
+    {
+        LOG_WARNING("[Vulkan] Device can't inherit queries, frames recorded by worker threads have no statistics");
     }
 }
 
-void Renderer::enableBlending(bool enable)
+bool Renderer::getPipelineStatistics(GpuPipelineStatistics& statistics) const
 {
+    return m_gpuProfiler && m_gpuProfiler->getPipelineStatistics(statistics);
 }
 
-void Renderer::enableCulling(bool enable)
+void Renderer::setGpuDrivenObjects(const std::vector<GpuDrivenObject>& objects)
 {
-    if (m_cullingEnabled == enable)
+    if (!m_gpuCulling)
     {
-        return; // No change
+        return;
     }
 
-    m_cullingEnabled = enable;
-    LOG_INFO("[Vulkan] Culling {}", enable ? "enabled" : "disabled");
-
-    // Pipelines are immutable in Vulkan, so we need to recreate them
-    // with the new culling state
-    if (m_device != VK_NULL_HANDLE && m_shaderManager)
+    std::vector<GpuObjectData> data(objects.size());
+    for (size_t i = 0; i < objects.size(); i++)
     {
-        vkDeviceWaitIdle(m_device);
-
-        // Destroy existing pipelines
-        m_shaderManager->destroyAllPipelines();
+        const GpuDrivenObject& object = objects[i];
+        data[i].model = object.model;
+        data[i].boundingSphere = glm::vec4(object.boundsCenter, object.boundsRadius);
+        data[i].indexCount = object.indexCount;
+        data[i].firstIndex = object.firstIndex;
+        data[i].vertexOffset = object.vertexOffset;
+        data[i].padding = 0;
+    }
+    m_gpuCulling->setObjects(data);
 
-        // Recreate pipelines with new culling state
-        m_shaderManager->createAllPipelines(m_renderPass, m_pipelineLayout, m_swapChainExtent);
+    // The new draw buffer holds no commands until the next cull
+    m_gpuCulledFrame = 0;
+}
 
-        LOG_INFO("[Vulkan] Pipelines recreated with culling state");
+void Renderer::updateGpuDrivenObject(unsigned int index, const glm::mat4& model)
+{
+    if (m_gpuCulling)
+    {
+        m_gpuCulling->updateObjectTransform(index, model);
     }
 }
 
-void Renderer::drawArrays(PrimitiveType mode, int first, int count)
+void Renderer::cullGpuDrivenObjects(const glm::mat4& viewProjection)
 {
-    // Begin frame if not already begun
-    if (!m_frameBegun)
+    if (!m_gpuCulling || !m_frameBegun)
     {
-        beginFrame();
+        return;
     }
 
-    // Skip if frame wasn't successfully begun (e.g., no pipeline available)
-    if (!m_frameBegun)
+    // Compute dispatches aren't allowed inside a render pass
+    if (m_passBegun)
     {
+        LOG_WARNING("[Vulkan] cullGpuDrivenObjects() called inside a pass - skipping");
         return;
     }
 
-    // Vulkan doesn't need the primitive type in draw call - it's specified in pipeline
+    VkCommandBuffer commandBuffer = m_commandBuffers[m_currentFrame];
+    if (m_gpuProfiler)
+    {
+        m_gpuProfiler->beginZone(commandBuffer, "GPU culling");
+    }
 
-    // Use the bound vertex array's vertex buffer if available
-    if (m_boundVertexArray && m_boundVertexArray->getVertexBuffer())
+    m_gpuCulling->cull(commandBuffer, viewProjection);
+
+    if (m_gpuProfiler)
     {
-        VkBuffer vertexBuffer = m_boundVertexArray->getVertexBuffer()->getBuffer();
-        VkDeviceSize offsets[] = {0};
-        vkCmdBindVertexBuffers(m_commandBuffers[m_currentFrame], 0, 1, &vertexBuffer, offsets);
+        m_gpuProfiler->endZone(commandBuffer);
     }
 
-    vkCmdDraw(m_commandBuffers[m_currentFrame], count, 1, first, 0);
-    endFrame();
+    m_gpuCulledFrame = m_frameNumber + 1;
 }
 
-void Renderer::drawElements(PrimitiveType mode, int count, unsigned int indexType, const void* indices)
+void Renderer::drawGpuDrivenObjects(PrimitiveType mode)
 {
-    // Begin frame if not already begun
-    if (!m_frameBegun)
+    if (!m_gpuCulling || m_gpuCulling->getObjectCount() == 0)
     {
-        beginFrame();
+        return;
     }
 
-    // Skip if frame wasn't successfully begun (e.g., no pipeline available)
-    if (!m_frameBegun)
+    // Draw commands of an earlier frame may reference objects that were replaced since
+    if (m_frameBegun && m_gpuCulledFrame != m_frameNumber + 1)
     {
-        return;
+        static bool warnedNotCulled = false;
+        if (!warnedNotCulled)
+        {
+            LOG_WARNING("[Vulkan] drawGpuDrivenObjects() without cullGpuDrivenObjects() in the frame - skipping");
+            warnedNotCulled = true;
+        }
+        return;
+    }
+
+    DrawCommand draw;
+    if (!buildDrawCommand(mode, draw))
+    {
+        return;
+    }
+
+    if (draw.indexBuffer == VK_NULL_HANDLE)
+    {
+        LOG_WARNING("[Vulkan] GPU-driven draws need an index buffer in the bound vertex array - skipping");
+        return;
+    }
+
+    // One indirect draw per object at most, the culling pass wrote how many are visible
+    draw.count = m_gpuCulling->getObjectCount();
+    draw.indexed = true;
+    draw.objectSet = m_gpuCulling->getObjectSet();
+    draw.indirectBuffer = m_gpuCulling->getDrawBuffer();
+    draw.indirectCountBuffer = m_gpuCulling->getDrawCountBuffer();
+    submitDraw(draw);
+}
+
+bool Renderer::bindComputeProgram(ComputeProgram* program, const char* caller)
+{
+    if (!program || !program->isValid() || !m_frameBegun)
+    {
+        return false;
+    }
+
+    // Compute dispatches aren't allowed inside a render pass
+    if (m_passBegun)
+    {
+        LOG_WARNING("[Vulkan] {}() called inside a pass - skipping", caller);
+        return false;
+    }
+
+    VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+    if (program->getDescriptorSetLayout() != VK_NULL_HANDLE)
+    {
+        const std::vector<uint32_t>& bindings = program->getStorageBindings();
+        std::vector<VkDescriptorBufferInfo> bufferInfos(bindings.size());
+        for (size_t i = 0; i < bindings.size(); i++)
+        {
+            StorageBuffer* buffer = program->getStorageBuffer(bindings[i]);
+            if (!buffer || buffer->getBuffer() == VK_NULL_HANDLE)
+            {
+                LOG_WARNING("[Vulkan] Compute program '{}' has no storage buffer at binding {} - skipping",
+                            program->getName(), bindings[i]);
+                return false;
+            }
+            bufferInfos[i] = {buffer->getBuffer(), 0, VK_WHOLE_SIZE};
+        }
+
+        // Attached buffers may change between dispatches, so each one gets its own set
+        descriptorSet = m_descriptorAllocator->allocateTransient(program->getDescriptorSetLayout());
+
+        std::vector<VkWriteDescriptorSet> writes(bindings.size());
+        for (size_t i = 0; i < bindings.size(); i++)
+        {
+            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet = descriptorSet;
+            writes[i].dstBinding = bindings[i];
+            writes[i].descriptorCount = 1;
+            writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[i].pBufferInfo = &bufferInfos[i];
+        }
+        vkUpdateDescriptorSets(m_device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+
+    VkCommandBuffer commandBuffer = m_commandBuffers[m_currentFrame];
+
+    // Frames submitted before this one may still access the same storage buffers,
+    // from dispatches or as indirect arguments
+    if (m_computeFrame != m_frameNumber + 1)
+    {
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                             0, 1, &barrier, 0, nullptr, 0, nullptr);
+        m_computeFrame = m_frameNumber + 1;
+    }
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, program->getPipeline());
+    if (descriptorSet != VK_NULL_HANDLE)
+    {
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, program->getPipelineLayout(),
+                                0, 1, &descriptorSet, 0, nullptr);
+    }
+
+    const VkPushConstantRange& pushConstantRange = program->getPushConstantRange();
+    if (pushConstantRange.size > 0)
+    {
+        vkCmdPushConstants(commandBuffer, program->getPipelineLayout(), VK_SHADER_STAGE_COMPUTE_BIT,
+                           pushConstantRange.offset, pushConstantRange.size, program->getPushConstantData());
+    }
+    return true;
+}
+
+void Renderer::dispatch(IComputeProgram* program, unsigned int groupsX, unsigned int groupsY, unsigned int groupsZ)
+{
+    if (groupsX == 0 || groupsY == 0 || groupsZ == 0)
+    {
+        return;
+    }
+
+    if (!bindComputeProgram(static_cast<ComputeProgram*>(program), "dispatch"))
+    {
+        return;
+    }
+
+    vkCmdDispatch(m_commandBuffers[m_currentFrame], groupsX, groupsY, groupsZ);
+}
+
+void Renderer::dispatchIndirect(IComputeProgram* program, IStorageBuffer* arguments, size_t offset)
+{
+    VkBuffer argumentBuffer = arguments ? static_cast<StorageBuffer*>(arguments)->getBuffer() : VK_NULL_HANDLE;
+    if (argumentBuffer == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    if (offset % 4 != 0 || offset + sizeof(VkDispatchIndirectCommand) > arguments->getSize())
+    {
+        LOG_ERROR("[Vulkan] Indirect dispatch arguments at offset {} are misaligned or past the buffer's end", offset);
+        return;
+    }
+
+    if (!bindComputeProgram(static_cast<ComputeProgram*>(program), "dispatchIndirect"))
+    {
+        return;
+    }
+
+    vkCmdDispatchIndirect(m_commandBuffers[m_currentFrame], argumentBuffer, offset);
+}
+
+void Renderer::memoryBarrier(BarrierFlags flags)
+{
+    if (!m_frameBegun)
+    {
+        return;
+    }
+
+    if (m_passBegun)
+    {
+        LOG_WARNING("[Vulkan] memoryBarrier() called inside a pass - skipping");
+        return;
+    }
+
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    VkPipelineStageFlags srcStages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    VkPipelineStageFlags dstStages = 0;
+
+    if (flags == BarrierFlags::All)
+    {
+        barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+        srcStages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        dstStages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    }
+    else
+    {
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        if (hasBarrierFlag(flags, BarrierFlags::StorageBuffer))
+        {
+            barrier.dstAccessMask |= VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+            dstStages |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        }
+        if (hasBarrierFlag(flags, BarrierFlags::IndirectCommand))
+        {
+            barrier.dstAccessMask |= VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+            dstStages |= VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+        }
+    }
+
+    if (dstStages == 0)
+    {
+        return;
+    }
+
+    vkCmdPipelineBarrier(m_commandBuffers[m_currentFrame], srcStages, dstStages,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+void Renderer::setReadbackEnabled(bool enable)
+{
+    m_readbackEnabled = enable;
+
+    if (!enable)
+    {
+        // Don't hand out frames copied before readback was turned off
+        for (ReadbackBuffer& readback : m_readbackBuffers)
+        {
+            readback.frameNumber = 0;
+        }
+        return;
+    }
+
+    // Before initialization the buffers are created with the offscreen targets
+    if (m_device == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    if (!m_headless)
+    {
+        LOG_WARNING("[Vulkan] Frame readback is only available in headless mode");
+        return;
+    }
+
+    createReadbackBuffers();
+}
+
+bool Renderer::readPixels(std::vector<uint8_t>& pixels)
+{
+    if (!m_headless || !m_readbackEnabled)
+    {
+        LOG_WARNING("[Vulkan] readPixels() requires headless mode with readback enabled");
+        return false;
+    }
+
+    const ReadbackBuffer* latest = nullptr;
+    for (const ReadbackBuffer& readback : m_readbackBuffers)
+    {
+        if (readback.frameNumber != 0 && (!latest || readback.frameNumber > latest->frameNumber))
+        {
+            latest = &readback;
+        }
+    }
+
+    if (!latest)
+    {
+        return false;
+    }
+
+    waitForFrame(latest->frameNumber);
+
+    // The readback memory is host-coherent, no invalidation needed
+    size_t size = static_cast<size_t>(m_swapChainExtent.width) * m_swapChainExtent.height * 4;
+    pixels.resize(size);
+    std::memcpy(pixels.data(), latest->mapped, size);
+    return true;
+}
+
+void Renderer::createReadbackBuffers()
+{
+    VkDeviceSize size = static_cast<VkDeviceSize>(m_swapChainExtent.width) * m_swapChainExtent.height * 4;
+
+    for (ReadbackBuffer& readback : m_readbackBuffers)
+    {
+        if (readback.buffer != VK_NULL_HANDLE)
+        {
+            continue;
+        }
+
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        if (vkCreateBuffer(m_device, &bufferInfo, nullptr, &readback.buffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create readback buffer");
+        }
+
+        // Dedicated so the memory can be mapped for the lifetime of the buffer
+        readback.allocation = m_memoryAllocator->allocateBufferMemory(readback.buffer,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, true);
+        vkBindBufferMemory(m_device, readback.buffer, readback.allocation.memory, readback.allocation.offset);
+
+        if (vkMapMemory(m_device, readback.allocation.memory, readback.allocation.offset, size, 0,
+                        &readback.mapped) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to map readback buffer");
+        }
+        readback.frameNumber = 0;
+    }
+
+    LOG_INFO("[Vulkan] Readback buffers created ({} KB each)", size / 1024);
+}
+
+void Renderer::destroyReadbackBuffers()
+{
+    for (ReadbackBuffer& readback : m_readbackBuffers)
+    {
+        if (readback.buffer == VK_NULL_HANDLE)
+        {
+            continue;
+        }
+
+        vkUnmapMemory(m_device, readback.allocation.memory);
+        vkDestroyBuffer(m_device, readback.buffer, nullptr);
+        m_memoryAllocator->free(readback.allocation);
+        readback = ReadbackBuffer{};
+    }
+}
+
+void Renderer::recordReadback(VkCommandBuffer commandBuffer, uint64_t frameNumber)
+{
+    ReadbackBuffer& readback = m_readbackBuffers[m_currentFrame];
+    if (readback.buffer == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    // The render pass leaves the target in TRANSFER_SRC_OPTIMAL, its writes must be
+    // visible to the copy
+    VkImageMemoryBarrier imageBarrier{};
+    imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    imageBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    imageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    imageBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    imageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    imageBarrier.image = m_swapChainImages[m_imageIndex];
+    imageBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    imageBarrier.subresourceRange.baseMipLevel = 0;
+    imageBarrier.subresourceRange.levelCount = 1;
+    imageBarrier.subresourceRange.baseArrayLayer = 0;
+    imageBarrier.subresourceRange.layerCount = 1;
+
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &imageBarrier);
+
+    VkBufferImageCopy region{};
+    region.bufferOffset = 0;
+    region.bufferRowLength = 0;
+    region.bufferImageHeight = 0;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = 1;
+    region.imageOffset = {0, 0, 0};
+    region.imageExtent = {m_swapChainExtent.width, m_swapChainExtent.height, 1};
+
+    vkCmdCopyImageToBuffer(commandBuffer, m_swapChainImages[m_imageIndex], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           readback.buffer, 1, &region);
+
+    // Host reads happen after the frame timeline has signaled
+    VkBufferMemoryBarrier bufferBarrier{};
+    bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    bufferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    bufferBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    bufferBarrier.buffer = readback.buffer;
+    bufferBarrier.offset = 0;
+    bufferBarrier.size = VK_WHOLE_SIZE;
+
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+                         0, 0, nullptr, 1, &bufferBarrier, 0, nullptr);
+
+    readback.frameNumber = frameNumber;
+}
+
+void Renderer::setFramesInFlight(unsigned int count)
+{
+    uint32_t clamped = std::clamp<uint32_t>(count, 1, MAX_FRAMES_IN_FLIGHT);
+    if (clamped != count)
+    {
+        LOG_WARNING("[Vulkan] Frames in flight must be between 1 and {}, using {}", MAX_FRAMES_IN_FLIGHT, clamped);
+    }
+
+    m_framesInFlight = clamped;
+
+    // Inside a frame the slot is re-derived in endFrame()
+    if (!m_frameBegun)
+    {
+        m_currentFrame = static_cast<uint32_t>(m_frameNumber % m_framesInFlight);
+    }
+
+    LOG_INFO("[Vulkan] Frames in flight set to {}", m_framesInFlight);
+}
+
+void Renderer::setPresentMode(PresentMode mode)
+{
+    if (mode == m_presentMode)
+    {
+        return;
+    }
+
+    m_presentMode = mode;
+    m_presentSettingsChanged = m_swapChain != VK_NULL_HANDLE;
+}
+
+void Renderer::setSwapchainImageCount(unsigned int count)
+{
+    if (count == m_swapchainImageCount)
+    {
+        return;
+    }
+
+    m_swapchainImageCount = count;
+    m_presentSettingsChanged = m_swapChain != VK_NULL_HANDLE;
+}
+
+void Renderer::setFrameRateLimit(double framesPerSecond)
+{
+    if (framesPerSecond <= 0.0)
+    {
+        m_frameInterval = std::chrono::steady_clock::duration::zero();
+        LOG_INFO("[Vulkan] Frame limiter disabled");
+        return;
+    }
+
+    m_frameInterval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / framesPerSecond));
+    m_nextFrameStart = std::chrono::steady_clock::now();
+    LOG_INFO("[Vulkan] Frame limiter set to {} fps", framesPerSecond);
+}
+
+bool Renderer::getFramePresentTiming(FramePresentTiming& timing) const
+{
+    if (!m_presentTimingValid)
+    {
+        return false;
+    }
+
+    timing = m_presentTiming;
+    return true;
+}
+
+void Renderer::waitForFrameLimit()
+{
+    m_pendingPresentTiming = FramePresentTiming();
+
+    if (m_frameInterval == std::chrono::steady_clock::duration::zero())
+    {
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Sleep is coarse on some platforms, sleep short of the deadline and spin the rest
+    constexpr auto SPIN_MARGIN = std::chrono::milliseconds(2);
+    if (m_nextFrameStart - start > SPIN_MARGIN)
+    {
+        std::this_thread::sleep_until(m_nextFrameStart - SPIN_MARGIN);
+    }
+    while (std::chrono::steady_clock::now() < m_nextFrameStart)
+    {
+        std::this_thread::yield();
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    m_pendingPresentTiming.limiterMilliseconds = std::chrono::duration<double, std::milli>(now - start).count();
+
+    // A late frame starts the schedule over instead of trying to catch up
+    m_nextFrameStart += m_frameInterval;
+    if (m_nextFrameStart < now)
+    {
+        m_nextFrameStart = now + m_frameInterval;
+    }
+}
+
+uint64_t Renderer::getCompletedFrameNumber() const
+{
+    if (m_frameTimeline == VK_NULL_HANDLE)
+    {
+        return m_frameNumber;
+    }
+
+    uint64_t value = 0;
+    vkGetSemaphoreCounterValue(m_device, m_frameTimeline, &value);
+    return value;
+}
+
+void Renderer::waitForFrame(uint64_t frameNumber)
+{
+    // Frame 0 is never submitted, it marks unused slots and images
+    if (frameNumber == 0 || m_frameTimeline == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    VkSemaphoreWaitInfo waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &m_frameTimeline;
+    waitInfo.pValues = &frameNumber;
+
+    vkWaitSemaphores(m_device, &waitInfo, UINT64_MAX);
+}
+
+bool Renderer::buildDrawCommand(PrimitiveType mode, DrawCommand& draw)
+{
+    // Draws are only recorded inside an active pass
+    if (!m_passBegun)
+    {
+        static bool warnedOutsidePass = false;
+        if (!warnedOutsidePass)
+        {
+            LOG_WARNING("[Vulkan] Draw issued outside beginPass()/endPass() - skipping");
+            warnedOutsidePass = true;
+        }
+        return false;
+    }
+
+    // Use the shader set by ShaderProgram::bind()
+    if (!m_currentShader)
+    {
+        LOG_WARNING("[Vulkan] No valid shader/pipeline bound - skipping draw");
+        return false;
+    }
+
+    // Skipped while the pipeline is still compiling without a fallback, or failed to compile
+    draw.pipeline = getPipeline(makePipelineKey(*m_currentShader, convertPrimitiveType(mode)));
+    if (draw.pipeline == VK_NULL_HANDLE)
+    {
+        return false;
+    }
+
+    draw.renderState = m_renderState;
+    if (m_bindlessEnabled)
+    {
+        // No per-draw descriptor binds, the shader indexes the bindless array instead
+        uint32_t textureIndex = m_currentTexture ? m_currentTexture->getBindlessIndex() : INVALID_BINDLESS_INDEX;
+        draw.descriptorSet = VK_NULL_HANDLE;
+        draw.bindlessSet = m_bindlessSet;
+        draw.textureIndex = textureIndex != INVALID_BINDLESS_INDEX ? textureIndex : 0;
+    }
+    else
+    {
+        draw.descriptorSet = m_currentTexture ? m_currentTexture->getDescriptorSet() : VK_NULL_HANDLE;
+        draw.bindlessSet = VK_NULL_HANDLE;
+        draw.textureIndex = 0;
+    }
+    draw.uniformSet = VK_NULL_HANDLE;
+    draw.uniformOffset = 0;
+    if (m_currentShader->hasUniforms())
+    {
+        // Written once per change, draws in between reuse the same block
+        if (m_currentShader != m_lastUniformShader ||
+            m_currentShader->getUniformVersion() != m_lastUniformVersion)
+        {
+            const std::vector<uint8_t>& data = m_currentShader->getUniformData();
+            m_lastUniformBlock = m_uniformRing->allocate(static_cast<uint32_t>(data.size()));
+            std::memcpy(m_lastUniformBlock.mapped, data.data(), data.size());
+            m_lastUniformShader = m_currentShader;
+            m_lastUniformVersion = m_currentShader->getUniformVersion();
+        }
+        draw.uniformSet = m_lastUniformBlock.set;
+        draw.uniformOffset = m_lastUniformBlock.offset;
+    }
+    draw.pipelineLayout = m_currentShader->getPipelineLayout();
+    draw.pushConstantRange = m_currentShader->getPushConstantRange();
+    draw.pushConstants = m_currentShader->getPushConstants();
+    draw.vertexBuffer = VK_NULL_HANDLE;
+    draw.instanceBuffer = VK_NULL_HANDLE;
+    draw.indexBuffer = VK_NULL_HANDLE;
+    draw.indexType = VK_INDEX_TYPE_UINT32;
+    draw.count = 0;
+    draw.first = 0;
+    draw.instanceCount = 1;
+    draw.indexed = false;
+    draw.objectSet = VK_NULL_HANDLE;
+    draw.indirectBuffer = VK_NULL_HANDLE;
+    draw.indirectCountBuffer = VK_NULL_HANDLE;
+
+    // Vertex buffer and index buffer come from the bound vertex array
+    if (m_boundVertexArray)
+    {
+        if (m_boundVertexArray->getVertexBuffer())
+        {
+            draw.vertexBuffer = m_boundVertexArray->getVertexBuffer()->getBuffer();
+        }
+
+        // The pipeline reads the instance binding, it can't be left unbound
+        if (m_boundVertexArray->hasInstanceAttributes())
+        {
+            if (!m_boundVertexArray->getInstanceBuffer())
+            {
+                LOG_WARNING("[Vulkan] Vertex array has per-instance attributes but no instance buffer - skipping draw");
+                return false;
+            }
+            draw.instanceBuffer = m_boundVertexArray->getInstanceBuffer()->getBuffer();
+        }
+
+        if (m_boundVertexArray->getIndexBuffer())
+        {
+            draw.indexBuffer = m_boundVertexArray->getIndexBuffer()->getBuffer();
+            draw.indexType = m_boundVertexArray->getIndexBuffer()->getVkIndexType();
+        }
+    }
+
+    return true;
+}
+
+void Renderer::submitDraw(const DrawCommand& draw)
+{
+    // Transfers can't be recorded in a render pass, updates made since the previous
+    // draw go between two halves of it so the draw sees them like in OpenGL
+    if (!m_bufferUpdates.empty())
+    {
+        VkCommandBuffer commandBuffer = m_commandBuffers[m_currentFrame];
+        endPassAttachments(commandBuffer);
+        recordBufferUpdates(commandBuffer);
+        beginPassAttachments(commandBuffer, false);
+    }
+    m_passCleared = false;
+
+    if (m_passRecordsSecondaries)
+    {
+        // Recorded by the worker threads in endPass()
+        m_passDraws.push_back(draw);
+    }
+    else
+    {
+        recordDrawCommand(m_commandBuffers[m_currentFrame], m_dynamicState, draw, m_bindState);
+    }
+}
+
+void Renderer::setRecordingThreadCount(unsigned int threadCount)
+{
+    // The frame's primary command buffer may already execute the workers' secondaries
+    if (m_frameBegun)
+    {
+        LOG_WARNING("[Vulkan] Cannot change recording threads inside a frame");
+        return;
+    }
+
+    m_recordingThreadCount = threadCount;
+
+    // Applied in initialize() if the device does not exist yet
+    if (m_device == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    // Worker pools may still be referenced by frames in flight
+    vkDeviceWaitIdle(m_device);
+    m_parallelRecorder.reset();
+
+    if (threadCount > 1)
+    {
+        m_parallelRecorder = std::make_unique<ParallelRecorder>(
+            m_device, m_queueFamilyIndices.graphicsFamily, threadCount, MAX_FRAMES_IN_FLIGHT, m_dynamicState);
+    }
+    else
+    {
+        LOG_INFO("[Vulkan] Single-threaded command recording");
+    }
+}
+
+void Renderer::setClearColor(float r, float g, float b, float a)
+{
+    m_clearColor = glm::vec4(r, g, b, a);
+}
+
+void Renderer::setClearColor(const glm::vec4& color)
+{
+    m_clearColor = color;
+}
+
+void Renderer::clear()
+{
+    if (!m_frameBegun)
+    {
+        return;
+    }
+
+    // Outside a pass the next one clears with its load ops
+    if (!m_passBegun)
+    {
+        m_clearPending = true;
+        return;
+    }
+
+    // The pass cleared already and nothing was drawn since, the usual beginPass(); clear();
+    if (m_passCleared)
+    {
+        return;
+    }
+
+    // Restart the render pass with clearing load ops, the draws so far are kept before it
+    VkCommandBuffer commandBuffer = m_commandBuffers[m_currentFrame];
+    endPassAttachments(commandBuffer);
+    recordBufferUpdates(commandBuffer);
+    beginPassAttachments(commandBuffer, true);
+}
+
+void Renderer::setViewport(int x, int y, int width, int height)
+{
+    // Called on every framebuffer resize event, endFrame() checks the size once per frame
+    m_framebufferResized = true;
+}
+
+void Renderer::getRenderDimensions(int& width, int& height) const
+{
+    width = static_cast<int>(m_swapChainExtent.width);
+    height = static_cast<int>(m_swapChainExtent.height);
+}
+
+void Renderer::enableDepthTest(bool enable)
+{
+    if (m_renderState.depthTest == enable)
+    {
+        return; // No change
+    }
+
+    // Applied to the following draws, either dynamically or by selecting a pipeline variant
+    m_renderState.depthTest = enable;
+    m_renderState.depthWrite = enable;
+    LOG_DEBUG("[Vulkan] Depth testing {}", enable ? "enabled" : "disabled");
+}
+
+void Renderer::enableBlending(bool enable)
+{
+    if (m_renderState.blend == enable)
+    {
+        return;
     }
 
-    // Bind vertex buffer and index buffer from the bound vertex array
-    if (m_boundVertexArray)
+    m_renderState.blend = enable;
+    LOG_DEBUG("[Vulkan] Blending {}", enable ? "enabled" : "disabled");
+}
+
+void Renderer::enableCulling(bool enable)
+{
+    VkCullModeFlags cullMode = enable ? VK_CULL_MODE_BACK_BIT : VK_CULL_MODE_NONE;
+    if (m_renderState.cullMode == cullMode)
     {
-        // Bind vertex buffer
-        if (m_boundVertexArray->getVertexBuffer())
-        {
-            VkBuffer vertexBuffer = m_boundVertexArray->getVertexBuffer()->getBuffer();
-            if (vertexBuffer != VK_NULL_HANDLE)
-            {
-                VkDeviceSize offsets[] = {0};
-                vkCmdBindVertexBuffers(m_commandBuffers[m_currentFrame], 0, 1, &vertexBuffer, offsets);
-            }
-        }
+        return;
+    }
 
-        // Bind index buffer
-        if (m_boundVertexArray->getIndexBuffer())
-        {
-            VkBuffer indexBuffer = m_boundVertexArray->getIndexBuffer()->getBuffer();
-            VkIndexType vkIndexType = m_boundVertexArray->getIndexBuffer()->getVkIndexType();
-            if (indexBuffer != VK_NULL_HANDLE)
-            {
-                vkCmdBindIndexBuffer(m_commandBuffers[m_currentFrame], indexBuffer, 0, vkIndexType);
-            }
-        }
+    m_renderState.cullMode = cullMode;
+    LOG_DEBUG("[Vulkan] Culling {}", enable ? "enabled" : "disabled");
+}
+
+void Renderer::drawArrays(PrimitiveType mode, int first, int count)
+{
+    // The primitive type selects the pipeline, Vulkan draws don't take it
+    DrawCommand draw;
+    if (!buildDrawCommand(mode, draw))
+    {
+        return;
+    }
+
+    draw.count = static_cast<uint32_t>(count);
+    draw.first = static_cast<uint32_t>(first);
+    submitDraw(draw);
+}
+
+void Renderer::drawElements(PrimitiveType mode, int count, unsigned int indexType, const void* indices)
+{
+    DrawCommand draw;
+    if (!buildDrawCommand(mode, draw))
+    {
+        return;
     }
 
     // Use indexed draw call
-    vkCmdDrawIndexed(m_commandBuffers[m_currentFrame], count, 1, 0, 0, 0);
-    endFrame();
+    draw.count = static_cast<uint32_t>(count);
+    draw.indexed = true;
+    submitDraw(draw);
+}
+
+void Renderer::drawArraysInstanced(PrimitiveType mode, int first, int count, int instanceCount)
+{
+    DrawCommand draw;
+    if (instanceCount <= 0 || !buildDrawCommand(mode, draw))
+    {
+        return;
+    }
+
+    draw.count = static_cast<uint32_t>(count);
+    draw.first = static_cast<uint32_t>(first);
+    draw.instanceCount = static_cast<uint32_t>(instanceCount);
+    submitDraw(draw);
+}
+
+void Renderer::drawElementsInstanced(PrimitiveType mode, int count, unsigned int indexType, const void* indices,
+                                     int instanceCount)
+{
+    DrawCommand draw;
+    if (instanceCount <= 0 || !buildDrawCommand(mode, draw))
+    {
+        return;
+    }
+
+    draw.count = static_cast<uint32_t>(count);
+    draw.instanceCount = static_cast<uint32_t>(instanceCount);
+    draw.indexed = true;
+    submitDraw(draw);
 }
 
 std::unique_ptr<IVertexBuffer> Renderer::createVertexBuffer()
@@ -1759,6 +4074,11 @@ std::unique_ptr<ITexture> Renderer::createTexture()
     return std::make_unique<VK::Texture>(m_device, m_physicalDevice, this);
 }
 
+std::unique_ptr<IStorageBuffer> Renderer::createStorageBuffer()
+{
+    return std::make_unique<VK::StorageBuffer>(this);
+}
+
 void Renderer::setActiveVertexArray(VertexArray* vao)
 {
     m_boundVertexArray = vao;
@@ -1783,20 +4103,62 @@ void Renderer::onShaderLoaded(const std::string& shaderName)
     // Cast to VK::ShaderProgram to access Vulkan-specific methods
     ShaderProgram* program = static_cast<ShaderProgram*>(iShader);
 
-    // Create pipeline for this shader
-    program->createPipeline(m_renderPass, m_pipelineLayout, m_swapChainExtent);
-    if (program->getPipeline() != VK_NULL_HANDLE)
+    // Warm the pipeline cache for the common case, other keys follow on first use
+    program->createPipeline();
+}
+
+void Renderer::beginUploadBatch()
+{
+    m_uploadBatchDepth++;
+}
+
+void Renderer::submitUploadBatch()
+{
+    if (m_uploadBatchDepth == 0)
     {
-        LOG_INFO("[Vulkan] Pipeline created for shader: {}", shaderName);
+        LOG_WARNING("[Vulkan] submitUploadBatch() called without beginUploadBatch()");
+        return;
     }
-    else
+
+    if (--m_uploadBatchDepth == 0)
+    {
+        flushUploads();
+    }
+}
+
+uint64_t Renderer::uploadToImage(VkImage image, uint32_t width, uint32_t height,
+                                 const void* data, VkDeviceSize size, VkDeviceSize alignment)
+{
+    StagingAllocation staging = m_stagingRing->allocate(size, alignment);
+    memcpy(staging.mapped, data, static_cast<size_t>(size));
+
+    ImageUpload upload{};
+    upload.image = image;
+    upload.srcBuffer = staging.buffer;
+    upload.region.bufferOffset = staging.offset;
+    upload.region.bufferRowLength = 0;
+    upload.region.bufferImageHeight = 0;
+    upload.region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    upload.region.imageSubresource.mipLevel = 0;
+    upload.region.imageSubresource.baseArrayLayer = 0;
+    upload.region.imageSubresource.layerCount = 1;
+    upload.region.imageOffset = {0, 0, 0};
+    upload.region.imageExtent = {width, height, 1};
+    m_imageUploads.push_back(upload);
+
+    if (m_uploadBatchDepth > 0)
     {
-        LOG_ERROR("[Vulkan] Failed to create pipeline for shader: {}", shaderName);
+        // Signaled by the batch's submission
+        return m_uploadValue + 1;
     }
+    return flushUploads();
 }
 
-VkCommandBuffer Renderer::beginSingleTimeCommands()
+VkCommandBuffer Renderer::beginUpload()
 {
+    // Reclaim staging memory of finished uploads, even if no frame is being rendered
+    m_stagingRing->reclaim(getCompletedUploadValue(), getCompletedFrameNumber());
+
     // Acquire a command buffer from the pool
     TransferCommandBuffer* transferCmd = acquireTransferCommandBuffer();
 
@@ -1812,11 +4174,11 @@ VkCommandBuffer Renderer::beginSingleTimeCommands()
     return transferCmd->commandBuffer;
 }
 
-void Renderer::endSingleTimeCommands(VkCommandBuffer commandBuffer)
+uint64_t Renderer::submitUpload(VkCommandBuffer commandBuffer)
 {
     vkEndCommandBuffer(commandBuffer);
 
-    // Find the corresponding transfer command buffer to get its fence
+    // Find the corresponding transfer command buffer to track its completion
     TransferCommandBuffer* transferCmd = nullptr;
     for (auto& cmd : m_transferCommandBuffers)
     {
@@ -1830,34 +4192,406 @@ void Renderer::endSingleTimeCommands(VkCommandBuffer commandBuffer)
     if (!transferCmd)
     {
         LOG_ERROR("[Vulkan] Failed to find transfer command buffer for submission");
-        return;
+        return m_uploadValue;
     }
 
+    uint64_t uploadValue = m_uploadValue + 1;
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &uploadValue;
+
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineInfo;
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &commandBuffer;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &m_uploadTimeline;
+
+    // Completion is signaled on the upload timeline, the graphics queue waits on it in endFrame()
+    if (vkQueueSubmit(m_transferQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to submit upload command buffer");
+    }
 
-    // Submit with fence for tracking completion
-    vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, transferCmd->fence);
+    m_uploadValue = uploadValue;
+    transferCmd->uploadValue = uploadValue;
 
-    // Wait for completion (still synchronous, but uses per-buffer fence)
-    vkWaitForFences(m_device, 1, &transferCmd->fence, VK_TRUE, UINT64_MAX);
+    // Staging space written for this upload is retired once it completes
+    m_stagingRing->markSubmitted(uploadValue);
 
-    // Release back to pool
+    // Release back to pool, it is reused once the upload value has been reached
     releaseTransferCommandBuffer(transferCmd);
+
+    return uploadValue;
+}
+
+void Renderer::releaseImagesToGraphics(VkCommandBuffer commandBuffer, const std::vector<VkImage>& images,
+                                       VkImageLayout oldLayout, VkImageLayout newLayout,
+                                       VkAccessFlags dstAccess, VkPipelineStageFlags dstStage)
+{
+    std::vector<VkImageMemoryBarrier> barriers;
+    barriers.reserve(images.size());
+
+    for (VkImage image : images)
+    {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.image = image;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barriers.push_back(barrier);
+    }
+
+    if (!m_queueFamilyIndices.hasDedicatedTransfer())
+    {
+        // Uploads run on a graphics-capable queue, a plain barrier is enough
+        for (VkImageMemoryBarrier& barrier : barriers)
+        {
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstAccessMask = dstAccess;
+        }
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, dstStage,
+                             0, 0, nullptr, 0, nullptr,
+                             static_cast<uint32_t>(barriers.size()), barriers.data());
+        return;
+    }
+
+    // Release half of the queue family ownership transfer
+    for (VkImageMemoryBarrier& barrier : barriers)
+    {
+        barrier.srcQueueFamilyIndex = m_queueFamilyIndices.transferFamily;
+        barrier.dstQueueFamilyIndex = m_queueFamilyIndices.graphicsFamily;
+        barrier.dstAccessMask = 0;
+    }
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                         0, 0, nullptr, 0, nullptr,
+                         static_cast<uint32_t>(barriers.size()), barriers.data());
+
+    // Acquire half, recorded on the graphics queue by the next endFrame()
+    for (const VkImageMemoryBarrier& barrier : barriers)
+    {
+        OwnershipAcquire acquire{};
+        acquire.imageBarrier = barrier;
+        acquire.imageBarrier.srcAccessMask = 0;
+        acquire.imageBarrier.dstAccessMask = dstAccess;
+        acquire.dstStage = dstStage;
+        acquire.uploadValue = m_uploadValue + 1;
+        m_pendingAcquires.push_back(acquire);
+    }
+}
+
+uint64_t Renderer::uploadToBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* data, VkDeviceSize size)
+{
+    StagingAllocation staging = m_stagingRing->allocate(size, 4);
+    memcpy(staging.mapped, data, static_cast<size_t>(size));
+
+    BufferUpload upload{};
+    upload.srcBuffer = staging.buffer;
+    upload.dstBuffer = dstBuffer;
+    upload.region.srcOffset = staging.offset;
+    upload.region.dstOffset = dstOffset;
+    upload.region.size = size;
+    m_bufferUploads.push_back(upload);
+
+    if (m_uploadBatchDepth > 0)
+    {
+        return m_uploadValue + 1;
+    }
+    return flushUploads();
+}
+
+uint64_t Renderer::flushUploads()
+{
+    if (m_imageUploads.empty() && m_bufferUploads.empty())
+    {
+        return m_uploadValue;
+    }
+
+    VkCommandBuffer commandBuffer = beginUpload();
+
+    // One barrier moves every image into a copy destination layout
+    std::vector<VkImage> images;
+    std::vector<VkImageMemoryBarrier> barriers;
+    images.reserve(m_imageUploads.size());
+    barriers.reserve(m_imageUploads.size());
+    for (const ImageUpload& upload : m_imageUploads)
+    {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = upload.image;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = 1;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barriers.push_back(barrier);
+        images.push_back(upload.image);
+    }
+
+    if (!barriers.empty())
+    {
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             0, 0, nullptr, 0, nullptr,
+                             static_cast<uint32_t>(barriers.size()), barriers.data());
+    }
+
+    for (const ImageUpload& upload : m_imageUploads)
+    {
+        vkCmdCopyBufferToImage(commandBuffer, upload.srcBuffer, upload.image,
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &upload.region);
+    }
+
+    // Buffers are shared with the transfer family (see applyUploadSharingMode()),
+    // the upload timeline wait in endFrame() makes these writes visible
+    for (const BufferUpload& upload : m_bufferUploads)
+    {
+        vkCmdCopyBuffer(commandBuffer, upload.srcBuffer, upload.dstBuffer, 1, &upload.region);
+    }
+
+    if (!images.empty())
+    {
+        releaseImagesToGraphics(commandBuffer, images,
+                                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                VK_ACCESS_SHADER_READ_BIT,
+                                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+    }
+
+    LOG_DEBUG("[Vulkan] Submitting {} image and {} buffer uploads", m_imageUploads.size(), m_bufferUploads.size());
+    m_imageUploads.clear();
+    m_bufferUploads.clear();
+
+    return submitUpload(commandBuffer);
+}
+
+void Renderer::applyUploadSharingMode(VkBufferCreateInfo& bufferInfo) const
+{
+    if (m_queueFamilyIndices.hasDedicatedTransfer())
+    {
+        bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufferInfo.queueFamilyIndexCount = static_cast<uint32_t>(m_uploadQueueFamilies.size());
+        bufferInfo.pQueueFamilyIndices = m_uploadQueueFamilies.data();
+    }
+    else
+    {
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    }
+}
+
+void Renderer::cancelPendingUploads(VkImage image)
+{
+    m_pendingAcquires.erase(
+        std::remove_if(m_pendingAcquires.begin(), m_pendingAcquires.end(),
+                       [image](const OwnershipAcquire& acquire) {
+                           return acquire.imageBarrier.image == image;
+                       }),
+        m_pendingAcquires.end());
+
+    // Copies still queued in an open upload batch
+    m_imageUploads.erase(
+        std::remove_if(m_imageUploads.begin(), m_imageUploads.end(),
+                       [image](const ImageUpload& upload) { return upload.image == image; }),
+        m_imageUploads.end());
+}
+
+void Renderer::cancelPendingUploads(VkBuffer buffer)
+{
+    m_bufferUploads.erase(
+        std::remove_if(m_bufferUploads.begin(), m_bufferUploads.end(),
+                       [buffer](const BufferUpload& upload) { return upload.dstBuffer == buffer; }),
+        m_bufferUploads.end());
+
+    m_bufferUpdates.erase(
+        std::remove_if(m_bufferUpdates.begin(), m_bufferUpdates.end(),
+                       [buffer](const BufferUpdate& update) { return update.dstBuffer == buffer; }),
+        m_bufferUpdates.end());
+}
+
+void Renderer::updateBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* data, VkDeviceSize size,
+                            VkPipelineStageFlags stages, VkAccessFlags access)
+{
+    if (size == 0)
+    {
+        return;
+    }
+
+    BufferUpdate update{};
+    update.dstBuffer = dstBuffer;
+    update.region.dstOffset = dstOffset;
+    update.region.size = size;
+    update.stages = stages;
+    update.access = access;
+
+    // Small aligned updates go inline in the command buffer, larger ones through
+    // staging space that is retired with the frame recording the copy
+    if (size <= MAX_INLINE_BUFFER_UPDATE && dstOffset % 4 == 0 && size % 4 == 0)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        update.data.assign(bytes, bytes + size);
+    }
+    else
+    {
+        // Not recorded yet, but never later than the frame being recorded
+        StagingAllocation staging = m_stagingRing->allocateForFrame(size, 4, m_frameNumber + 1);
+        memcpy(staging.mapped, data, static_cast<size_t>(size));
+        update.srcBuffer = staging.buffer;
+        update.region.srcOffset = staging.offset;
+    }
+
+    m_bufferUpdates.push_back(std::move(update));
+
+    // Outside a frame the next one records it first thing
+    if (m_frameBegun && !m_passBegun)
+    {
+        recordBufferUpdates(m_commandBuffers[m_currentFrame]);
+    }
+}
+
+void Renderer::recordBufferUpdates(VkCommandBuffer commandBuffer)
+{
+    if (m_bufferUpdates.empty())
+    {
+        return;
+    }
+
+    // Commands recorded before, and earlier frames, are done with the old contents
+    std::vector<VkBufferMemoryBarrier> barriers;
+    barriers.reserve(m_bufferUpdates.size());
+    VkPipelineStageFlags stages = 0;
+    for (const BufferUpdate& update : m_bufferUpdates)
+    {
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = update.access;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer = update.dstBuffer;
+        barrier.offset = update.region.dstOffset;
+        barrier.size = update.region.size;
+        barriers.push_back(barrier);
+        stages |= update.stages;
+    }
+    vkCmdPipelineBarrier(commandBuffer, stages, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data(), 0, nullptr);
+
+    for (const BufferUpdate& update : m_bufferUpdates)
+    {
+        if (update.srcBuffer != VK_NULL_HANDLE)
+        {
+            vkCmdCopyBuffer(commandBuffer, update.srcBuffer, update.dstBuffer, 1, &update.region);
+            continue;
+        }
+
+        // vkCmdUpdateBuffer takes at most MAX_INLINE_BUFFER_UPDATE bytes
+        vkCmdUpdateBuffer(commandBuffer, update.dstBuffer, update.region.dstOffset,
+                          update.region.size, update.data.data());
+    }
+
+    // Later commands see the new contents
+    for (size_t i = 0; i < barriers.size(); i++)
+    {
+        barriers[i].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barriers[i].dstAccessMask = m_bufferUpdates[i].access;
+    }
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, stages,
+                         0, 0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data(), 0, nullptr);
+
+    m_bufferUpdates.clear();
+}
+
+uint64_t Renderer::getCompletedUploadValue() const
+{
+    if (m_uploadTimeline == VK_NULL_HANDLE)
+    {
+        return m_uploadValue;
+    }
+
+    uint64_t value = 0;
+    vkGetSemaphoreCounterValue(m_device, m_uploadTimeline, &value);
+    return value;
+}
+
+void Renderer::waitForUpload(uint64_t uploadValue)
+{
+    if (uploadValue == 0 || m_uploadTimeline == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    VkSemaphoreWaitInfo waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &m_uploadTimeline;
+    waitInfo.pValues = &uploadValue;
+
+    vkWaitSemaphores(m_device, &waitInfo, UINT64_MAX);
+}
+
+VkCommandBuffer Renderer::recordOwnershipAcquires()
+{
+    // Only acquires whose release has already been submitted can be recorded
+    std::vector<VkImageMemoryBarrier> imageBarriers;
+    VkPipelineStageFlags dstStages = 0;
+
+    auto it = m_pendingAcquires.begin();
+    while (it != m_pendingAcquires.end())
+    {
+        if (it->uploadValue > m_uploadValue)
+        {
+            ++it;
+            continue;
+        }
+
+        imageBarriers.push_back(it->imageBarrier);
+        dstStages |= it->dstStage;
+        it = m_pendingAcquires.erase(it);
+    }
+
+    if (imageBarriers.empty())
+    {
+        return VK_NULL_HANDLE;
+    }
+
+    VkCommandBuffer commandBuffer = m_acquireCommandBuffers[m_currentFrame];
+    vkResetCommandBuffer(commandBuffer, 0);
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, dstStages, 0,
+                         0, nullptr, 0, nullptr,
+                         static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+
+    vkEndCommandBuffer(commandBuffer);
+
+    LOG_DEBUG("[Vulkan] Acquired ownership of {} images", imageBarriers.size());
+    return commandBuffer;
 }
 
 void Renderer::deferDeleteSampler(VkSampler sampler)
 {
     if (sampler == VK_NULL_HANDLE) return;
 
-    DeferredDeletion deletion;
-    deletion.type = DeferredDeletion::Type::Sampler;
-    deletion.handle = reinterpret_cast<uint64_t>(sampler);
-    deletion.frameIndex = m_currentFrame;
-    m_deferredDeletions.push_back(deletion);
-
+    queueDeferredDeletion(DeferredDeletion::Type::Sampler, reinterpret_cast<uint64_t>(sampler));
     LOG_DEBUG("[Vulkan] Sampler queued for deferred deletion");
 }
 
@@ -1865,12 +4599,7 @@ void Renderer::deferDeleteImageView(VkImageView imageView)
 {
     if (imageView == VK_NULL_HANDLE) return;
 
-    DeferredDeletion deletion;
-    deletion.type = DeferredDeletion::Type::ImageView;
-    deletion.handle = reinterpret_cast<uint64_t>(imageView);
-    deletion.frameIndex = m_currentFrame;
-    m_deferredDeletions.push_back(deletion);
-
+    queueDeferredDeletion(DeferredDeletion::Type::ImageView, reinterpret_cast<uint64_t>(imageView));
     LOG_DEBUG("[Vulkan] ImageView queued for deferred deletion");
 }
 
@@ -1878,12 +4607,7 @@ void Renderer::deferDeleteImage(VkImage image)
 {
     if (image == VK_NULL_HANDLE) return;
 
-    DeferredDeletion deletion;
-    deletion.type = DeferredDeletion::Type::Image;
-    deletion.handle = reinterpret_cast<uint64_t>(image);
-    deletion.frameIndex = m_currentFrame;
-    m_deferredDeletions.push_back(deletion);
-
+    queueDeferredDeletion(DeferredDeletion::Type::Image, reinterpret_cast<uint64_t>(image));
     LOG_DEBUG("[Vulkan] Image queued for deferred deletion");
 }
 
@@ -1891,12 +4615,7 @@ void Renderer::deferDeleteDeviceMemory(VkDeviceMemory memory)
 {
     if (memory == VK_NULL_HANDLE) return;
 
-    DeferredDeletion deletion;
-    deletion.type = DeferredDeletion::Type::DeviceMemory;
-    deletion.handle = reinterpret_cast<uint64_t>(memory);
-    deletion.frameIndex = m_currentFrame;
-    m_deferredDeletions.push_back(deletion);
-
+    queueDeferredDeletion(DeferredDeletion::Type::DeviceMemory, reinterpret_cast<uint64_t>(memory));
     LOG_DEBUG("[Vulkan] DeviceMemory queued for deferred deletion");
 }
 
@@ -1904,27 +4623,65 @@ void Renderer::deferDeleteBuffer(VkBuffer buffer)
 {
     if (buffer == VK_NULL_HANDLE) return;
 
-    DeferredDeletion deletion;
-    deletion.type = DeferredDeletion::Type::Buffer;
-    deletion.handle = reinterpret_cast<uint64_t>(buffer);
-    deletion.frameIndex = m_currentFrame;
-    m_deferredDeletions.push_back(deletion);
-
+    queueDeferredDeletion(DeferredDeletion::Type::Buffer, reinterpret_cast<uint64_t>(buffer));
     LOG_DEBUG("[Vulkan] Buffer queued for deferred deletion");
 }
 
-void Renderer::processDeferredDeletions()
+void Renderer::deferDeletePipeline(VkPipeline pipeline)
+{
+    if (pipeline == VK_NULL_HANDLE) return;
+
+    queueDeferredDeletion(DeferredDeletion::Type::Pipeline, reinterpret_cast<uint64_t>(pipeline));
+    LOG_DEBUG("[Vulkan] Pipeline queued for deferred deletion");
+}
+
+void Renderer::deferDeletePipelineLayout(VkPipelineLayout pipelineLayout)
+{
+    if (pipelineLayout == VK_NULL_HANDLE) return;
+
+    queueDeferredDeletion(DeferredDeletion::Type::PipelineLayout, reinterpret_cast<uint64_t>(pipelineLayout));
+}
+
+void Renderer::deferDeleteDescriptorSetLayout(VkDescriptorSetLayout setLayout)
+{
+    if (setLayout == VK_NULL_HANDLE) return;
+
+    queueDeferredDeletion(DeferredDeletion::Type::DescriptorSetLayout, reinterpret_cast<uint64_t>(setLayout));
+}
+
+void Renderer::deferFreeAllocation(const Allocation& allocation)
+{
+    if (allocation.memory == VK_NULL_HANDLE) return;
+
+    queueDeferredDeletion(DeferredDeletion::Type::Allocation, 0, allocation);
+}
+
+void Renderer::queueDeferredDeletion(DeferredDeletion::Type type, uint64_t handle, const Allocation& allocation)
 {
-    // Process deletions that are at least MAX_FRAMES_IN_FLIGHT frames old
-    // This ensures the resource is no longer in use by any in-flight frame
+    // Nothing left to defer to once the device is gone
+    if (m_device == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    // The frame being recorded may still use the resource, as may any frame
+    // submitted before it. Later frames can't, they are recorded after this call.
+    DeferredDeletion deletion;
+    deletion.type = type;
+    deletion.handle = handle;
+    deletion.allocation = allocation;
+    deletion.frameNumber = m_frameNumber + 1;
+    m_deferredDeletions.push_back(deletion);
+}
 
+void Renderer::processDeferredDeletions(uint64_t completedFrame)
+{
+    // Destroy resources whose last possible use is a frame the GPU has completed
+    // Entries are queued in frame order, so the scan stops at the first pending one
     auto it = m_deferredDeletions.begin();
     while (it != m_deferredDeletions.end())
     {
-        // Calculate frame distance (handle wraparound)
-        uint32_t frameDistance = (m_currentFrame + MAX_FRAMES_IN_FLIGHT - it->frameIndex) % (MAX_FRAMES_IN_FLIGHT * 10);
-
-        if (frameDistance >= MAX_FRAMES_IN_FLIGHT)
+        if (it->frameNumber <= completedFrame)
         {
             // Safe to delete this resource
             switch (it->type)
@@ -1949,15 +4706,42 @@ void Renderer::processDeferredDeletions()
                     vkDestroyBuffer(m_device, reinterpret_cast<VkBuffer>(it->handle), nullptr);
                     LOG_DEBUG("[Vulkan] Deferred buffer destroyed");
                     break;
+                case DeferredDeletion::Type::Pipeline:
+                    vkDestroyPipeline(m_device, reinterpret_cast<VkPipeline>(it->handle), nullptr);
+                    LOG_DEBUG("[Vulkan] Deferred pipeline destroyed");
+                    break;
+                case DeferredDeletion::Type::BindlessIndex:
+                    m_freeBindlessIndices.push_back(static_cast<uint32_t>(it->handle));
+                    break;
+                case DeferredDeletion::Type::Framebuffer:
+                    vkDestroyFramebuffer(m_device, reinterpret_cast<VkFramebuffer>(it->handle), nullptr);
+                    break;
+                case DeferredDeletion::Type::Semaphore:
+                    vkDestroySemaphore(m_device, reinterpret_cast<VkSemaphore>(it->handle), nullptr);
+                    break;
+                case DeferredDeletion::Type::Swapchain:
+                    vkDestroySwapchainKHR(m_device, reinterpret_cast<VkSwapchainKHR>(it->handle), nullptr);
+                    LOG_DEBUG("[Vulkan] Retired swap chain destroyed");
+                    break;
+                case DeferredDeletion::Type::Allocation:
+                    m_memoryAllocator->free(it->allocation);
+                    break;
+                case DeferredDeletion::Type::PipelineLayout:
+                    vkDestroyPipelineLayout(m_device, reinterpret_cast<VkPipelineLayout>(it->handle), nullptr);
+                    break;
+                case DeferredDeletion::Type::DescriptorSetLayout:
+                    vkDestroyDescriptorSetLayout(m_device, reinterpret_cast<VkDescriptorSetLayout>(it->handle), nullptr);
+                    break;
             }
 
-            it = m_deferredDeletions.erase(it);
+            ++it;
         }
         else
         {
-            ++it;
+            break;
         }
     }
+    m_deferredDeletions.erase(m_deferredDeletions.begin(), it);
 }
 
 } // namespace VK
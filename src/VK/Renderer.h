@@ -8,12 +8,26 @@
 #include "VertexArray.h"
 #include "ValidationLayers.h"
 #include "MemoryAllocator.h"
+#include "ParallelRecorder.h"
+#include "StagingRing.h"
+#include "PipelineCache.h"
+#include "PipelineState.h"
+#include "PipelineCompiler.h"
+#include "DescriptorAllocator.h"
+#include "UniformRing.h"
+#include "ShaderReflection.h"
+#include "GpuProfiler.h"
+#include "GpuCulling.h"
 #include <glm/glm.hpp>
 #include <vulkan/vulkan.h>
 #include <GLFW/glfw3.h>
 #include <vector>
 #include <string>
 #include <memory>
+#include <array>
+#include <chrono>
+#include <unordered_map>
+#include <deque>
 
 namespace VK
 {
@@ -21,11 +35,17 @@ namespace VK
     {
         uint32_t graphicsFamily = UINT32_MAX;
         uint32_t presentFamily = UINT32_MAX;
+        uint32_t transferFamily = UINT32_MAX;  // Falls back to graphicsFamily
 
         bool isComplete() const
         {
             return graphicsFamily != UINT32_MAX && presentFamily != UINT32_MAX;
         }
+
+        bool hasDedicatedTransfer() const
+        {
+            return transferFamily != graphicsFamily;
+        }
     };
 
     struct SwapChainSupportDetails
@@ -38,23 +58,79 @@ namespace VK
     // Deferred deletion for Vulkan resources
     struct DeferredDeletion
     {
-        enum class Type { Sampler, ImageView, Image, DeviceMemory, Buffer };
+        enum class Type { Sampler, ImageView, Image, DeviceMemory, Buffer, Pipeline, BindlessIndex,
+                          Framebuffer, Semaphore, Swapchain, Allocation, PipelineLayout, DescriptorSetLayout };
         Type type;
         uint64_t handle;
-        uint32_t frameIndex; // Frame when it was queued for deletion
+        Allocation allocation; // Type::Allocation only
+        uint64_t frameNumber; // Last frame that may still use the resource
     };
 
     // Command buffer pool for transfer operations
     struct TransferCommandBuffer
     {
         VkCommandBuffer commandBuffer;
-        VkFence fence;
+        uint64_t uploadValue; // Upload timeline value signaled by its last submission
         bool inUse;
     };
 
+    // Host copy of a headless frame's color target
+    struct ReadbackBuffer
+    {
+        VkBuffer buffer;
+        Allocation allocation;
+        void* mapped;
+        uint64_t frameNumber; // Frame that last copied into the buffer (0 = none)
+    };
+
+    // Graphics-queue half of a queue family ownership transfer
+    // Only images need one, buffers are shared with the transfer family
+    struct OwnershipAcquire
+    {
+        VkImageMemoryBarrier imageBarrier;
+        VkPipelineStageFlags dstStage;
+        uint64_t uploadValue; // Upload that recorded the matching release
+    };
+
+    // Copy from the staging ring waiting to be recorded
+    struct ImageUpload
+    {
+        VkImage image;
+        VkBuffer srcBuffer;
+        VkBufferImageCopy region;
+    };
+
+    struct BufferUpload
+    {
+        VkBuffer srcBuffer;
+        VkBuffer dstBuffer;
+        VkBufferCopy region;
+    };
+
+    // Write into a buffer the GPU may be using, recorded in the frame's command buffer
+    struct BufferUpdate
+    {
+        VkBuffer dstBuffer;
+        VkBufferCopy region;
+        VkBuffer srcBuffer;          // Null when the data is recorded with vkCmdUpdateBuffer
+        std::vector<uint8_t> data;   // Inline data, only without srcBuffer
+        VkPipelineStageFlags stages; // Where the buffer is used
+        VkAccessFlags access;
+    };
+
     class Renderer : public IRenderer
     {
     public:
+        // Upper bound for setFramesInFlight(), per-frame resources are sized for it
+        static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 4;
+
+        static constexpr uint32_t INVALID_BINDLESS_INDEX = UINT32_MAX;
+        static constexpr uint32_t MAX_BINDLESS_TEXTURES = 16384;
+
+        // Offscreen target size used by initialize() without a window
+        static constexpr uint32_t DEFAULT_HEADLESS_WIDTH = 1280;
+        static constexpr uint32_t DEFAULT_HEADLESS_HEIGHT = 720;
+
         Renderer();
         ~Renderer() override;
 
@@ -62,6 +138,18 @@ namespace VK
         void initialize(GLFWwindow* window) override;
         void shutdown() override;
 
+        // Headless mode renders into offscreen color and depth targets instead of a
+        // swapchain, so no window, surface or VK_KHR_swapchain is needed
+        void initializeHeadless(uint32_t width, uint32_t height);
+        bool isHeadless() const { return m_headless; }
+
+        // Headless only: copy each frame's color target to host memory
+        void setReadbackEnabled(bool enable);
+
+        // Tightly packed RGBA8 rows of the last frame copied, waits for that frame to complete
+        // Returns false if no frame has been read back yet
+        bool readPixels(std::vector<uint8_t>& pixels);
+
         void setClearColor(float r, float g, float b, float a = 1.0f) override;
         void setClearColor(const glm::vec4& color) override;
         void clear() override;
@@ -74,16 +162,53 @@ namespace VK
         void getRenderDimensions(int& width, int& height) const override;
         void onShaderLoaded(const std::string& shaderName) override;
 
+        void beginFrame() override;
+        void beginPass() override;
+        void endPass() override;
+        void endFrame() override;
+
         void drawArrays(PrimitiveType mode, int first, int count) override;
         void drawElements(PrimitiveType mode, int count, unsigned int indexType, const void* indices) override;
+        void drawArraysInstanced(PrimitiveType mode, int first, int count, int instanceCount) override;
+        void drawElementsInstanced(PrimitiveType mode, int count, unsigned int indexType, const void* indices,
+                                   int instanceCount) override;
+
+        void setRecordingThreadCount(unsigned int threadCount) override;
+        void setFramesInFlight(unsigned int count) override;
+
+        void setPresentMode(PresentMode mode) override;
+        void setSwapchainImageCount(unsigned int count) override;
+        void setFrameRateLimit(double framesPerSecond) override;
+        bool getFramePresentTiming(FramePresentTiming& timing) const override;
+
+        void beginUploadBatch() override;
+        void submitUploadBatch() override;
+
+        void setBindlessTextures(bool enable) override;
+
+        void beginGpuZone(const char* name) override;
+        void endGpuZone() override;
+        void getGpuZoneTimes(std::vector<GpuZoneTime>& zones) const override;
+        void setPipelineStatisticsEnabled(bool enable) override;
+        bool getPipelineStatistics(GpuPipelineStatistics& statistics) const override;
 
-        void beginFrame();
-        void endFrame();
+        bool isGpuDrivenRenderingSupported() const override { return m_gpuCulling != nullptr; }
+        void setGpuDrivenObjects(const std::vector<GpuDrivenObject>& objects) override;
+        void updateGpuDrivenObject(unsigned int index, const glm::mat4& model) override;
+        void cullGpuDrivenObjects(const glm::mat4& viewProjection) override;
+        void drawGpuDrivenObjects(PrimitiveType mode) override;
+
+        bool isComputeSupported() const override { return true; }
+        void dispatch(IComputeProgram* program, unsigned int groupsX, unsigned int groupsY = 1,
+                      unsigned int groupsZ = 1) override;
+        void dispatchIndirect(IComputeProgram* program, IStorageBuffer* arguments, size_t offset = 0) override;
+        void memoryBarrier(BarrierFlags flags) override;
 
         std::unique_ptr<IVertexBuffer> createVertexBuffer() override;
         std::unique_ptr<IVertexArray> createVertexArray() override;
         std::unique_ptr<IIndexBuffer> createIndexBuffer() override;
         std::unique_ptr<ITexture> createTexture() override;
+        std::unique_ptr<IStorageBuffer> createStorageBuffer() override;
 
         // Vulkan-specific methods
         void setActiveVertexArray(VertexArray* vao);
@@ -97,24 +222,73 @@ namespace VK
         void setCurrentTexture(class Texture* texture) { m_currentTexture = texture; }
 
         // Pipeline management
-        VkPipeline createPipelineForShader(VkShaderModule vertModule,
-                                           VkShaderModule fragModule,
-                                           VkRenderPass renderPass,
-                                           VkPipelineLayout pipelineLayout,
-                                           VkExtent2D extent);
-
-        // Command buffer helpers
-        VkCommandBuffer beginSingleTimeCommands();
-        void endSingleTimeCommands(VkCommandBuffer commandBuffer);
+        // Pipelines are owned by the renderer and compiled in the background on
+        // first use of a key. State the device sets dynamically is left at its
+        // defaults in the key.
+        PipelineKey makePipelineKey(const ShaderProgram& shader, VkPrimitiveTopology topology) const;
+        void requestPipeline(const PipelineKey& key);
+
+        // Returns a compatible fallback or VK_NULL_HANDLE while the pipeline is compiling
+        VkPipeline getPipeline(const PipelineKey& key);
+
+        // Drop every pipeline built from these modules (shader destroyed or reloaded)
+        void releasePipelines(VkShaderModule vertModule, VkShaderModule fragModule);
+
+        // Render state set through enable*(), applied per draw
+        const RenderState& getRenderState() const { return m_renderState; }
+
+        // Asynchronous uploads on the transfer queue
+        // Both return the upload timeline value signaled on completion, the graphics
+        // queue waits on it before the next frame's commands run. Inside an upload
+        // batch the copies are only recorded and submitted by submitUploadBatch().
+        uint64_t uploadToImage(VkImage image, uint32_t width, uint32_t height,
+                               const void* data, VkDeviceSize size, VkDeviceSize alignment);
+        uint64_t uploadToBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* data, VkDeviceSize size);
+        void cancelPendingUploads(VkImage image);   // Resource destroyed before its upload was used
+        void cancelPendingUploads(VkBuffer buffer);
+        uint64_t getCompletedUploadValue() const;
+
+        // Ordered update of a buffer that frames may already use, stages and access
+        // being how the GPU uses it. Recorded in the frame's command buffer, so draws
+        // and dispatches recorded before see the old contents and later ones the new.
+        // Inside a pass the render pass is split before the next draw to record it,
+        // consecutive updates share one split.
+        void updateBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* data, VkDeviceSize size,
+                          VkPipelineStageFlags stages, VkAccessFlags access);
+        void waitForUpload(uint64_t uploadValue);
+
+        // Device-local buffers are shared with the transfer family, so buffer
+        // uploads need no ownership transfer and can target any byte range
+        void applyUploadSharingMode(VkBufferCreateInfo& bufferInfo) const;
+
+        // Bindless textures
+        // Every texture gets a slot in one update-after-bind array at BINDLESS_SET.
+        // In bindless mode draws don't bind per-texture sets, the bound texture's slot
+        // is pushed as a uint at BINDLESS_TEXTURE_INDEX_OFFSET in the fragment stage.
+        bool isBindlessSupported() const { return m_bindlessSupported; }
+        bool isBindlessEnabled() const { return m_bindlessEnabled; }
+        uint32_t registerBindlessTexture(VkImageView imageView, VkSampler sampler);
+        void updateBindlessTexture(uint32_t index, VkImageView imageView, VkSampler sampler);
+        void releaseBindlessTexture(uint32_t index);  // Slot is reused once frames in flight are done
+
+        // Pipeline layout for a shader's reflected push constants, cached by range
+        // Warns about bindings the shared descriptor set layouts don't provide
+        ShaderLayout getShaderLayout(const std::string& shaderName, const ShaderReflection& reflection);
 
         // Descriptor management
-        VkDescriptorPool getDescriptorPool() const { return m_descriptorPool; }
+        DescriptorAllocator* getDescriptorAllocator() { return m_descriptorAllocator.get(); }
         VkDescriptorSetLayout getDescriptorSetLayout() const { return m_descriptorSetLayout; }
         VkDevice getDevice() const { return m_device; }
         VkPhysicalDevice getPhysicalDevice() const { return m_physicalDevice; }
         VkQueue getGraphicsQueue() const { return m_graphicsQueue; }
         VkCommandPool getCommandPool() const { return m_commandPool; }
+        VkPipelineCache getPipelineCache() const { return m_pipelineCache ? m_pipelineCache->getHandle() : VK_NULL_HANDLE; }
         uint32_t getCurrentFrameIndex() const { return m_currentFrame; }
+
+        // Frame timeline: the frame being recorded is getFrameNumber() + 1
+        uint64_t getFrameNumber() const { return m_frameNumber; }
+        uint64_t getCompletedFrameNumber() const;
+        void waitForFrame(uint64_t frameNumber);
         MemoryAllocator* getMemoryAllocator() { return m_memoryAllocator.get(); }
 
         // Deferred deletion system
@@ -123,44 +297,102 @@ namespace VK
         void deferDeleteImage(VkImage image);
         void deferDeleteDeviceMemory(VkDeviceMemory memory);
         void deferDeleteBuffer(VkBuffer buffer);
+        void deferDeletePipeline(VkPipeline pipeline);
+        void deferDeletePipelineLayout(VkPipelineLayout pipelineLayout);
+        void deferDeleteDescriptorSetLayout(VkDescriptorSetLayout setLayout);
+        void deferFreeAllocation(const Allocation& allocation);
 
     private:
+        void initializeRenderer();
         void createInstance();
         void createSurface();
         void pickPhysicalDevice();
         void createLogicalDevice();
         void createSwapChain();
+        void createOffscreenTargets();
+        void createReadbackBuffers();
+        void destroyReadbackBuffers();
+        void recordReadback(VkCommandBuffer commandBuffer, uint64_t frameNumber);
+        void recordBufferUpdates(VkCommandBuffer commandBuffer);
         void createImageViews();
         void createRenderPass();
         void createDescriptorSetLayout();
         void createPipelineLayout();
-        void createDescriptorPool();
+        VkPipelineLayout acquirePipelineLayout(const VkPushConstantRange& pushConstantRange);
+        void createDescriptorAllocator();
+        void createBindlessResources();
+        void createUniformRing();
         void createGraphicsPipeline();
         void createDepthResources();
         void createFramebuffers();
         void createCommandPool();
         void createCommandBuffers();
         void createSyncObjects();
+        void createGpuProfiler();
+        void createGpuCulling();
         //void initializeVertexBuffer();
 
-        void recreateSwapChain();
+        VkPipeline createPipeline(const PipelineKey& key);  // Called on compiler threads
+        CompiledPipeline& findOrRequestPipeline(const PipelineKey& key);
+        void destroyAllPipelines();
+        VkPrimitiveTopology convertPrimitiveType(PrimitiveType mode) const;
+
+        // Begin and end the render pass or dynamic rendering of the current pass,
+        // ending also executes the draws the workers recorded so far
+        void beginPassAttachments(VkCommandBuffer commandBuffer, bool clear);
+        void endPassAttachments(VkCommandBuffer commandBuffer);
+
+        // Attachment layout transitions done by the render pass in the other path
+        void beginRendering(VkCommandBuffer commandBuffer, const std::array<VkClearValue, 2>& clearValues, bool clear);
+        void transitionColorTargetForFrameEnd(VkCommandBuffer commandBuffer);
+
+        bool recreateSwapChain();  // False while the window is minimized, retried by beginFrame()
         void cleanupSwapChain();
+        void retireSwapChainResources();
+        void releaseRetiredSwapChains();
+
+        // Captures the currently bound state for a draw
+        // Returns false if the draw must be skipped
+        bool buildDrawCommand(PrimitiveType mode, DrawCommand& draw);
+        void submitDraw(const DrawCommand& draw);
+
+        // Binds the program with its storage buffers and push constants for a dispatch
+        // Returns false if the dispatch must be skipped
+        bool bindComputeProgram(class ComputeProgram* program, const char* caller);
 
         // Deferred deletion helpers
-        void processDeferredDeletions();
+        void queueDeferredDeletion(DeferredDeletion::Type type, uint64_t handle, const Allocation& allocation = {});
+        void processDeferredDeletions(uint64_t completedFrame);
 
         // Transfer command buffer pool
         void createTransferCommandPool();
         void cleanupTransferCommandPool();
+        void allocateTransferCommandBuffer();
         TransferCommandBuffer* acquireTransferCommandBuffer();
         void releaseTransferCommandBuffer(TransferCommandBuffer* cmdBuf);
+        VkCommandBuffer recordOwnershipAcquires();
+
+        // Upload recording, all uploads go through flushUploads() so staging
+        // ranges are always tagged with the submission that reads them
+        VkCommandBuffer beginUpload();
+        uint64_t submitUpload(VkCommandBuffer commandBuffer);
+        uint64_t flushUploads();
+        void releaseImagesToGraphics(VkCommandBuffer commandBuffer, const std::vector<VkImage>& images,
+                                     VkImageLayout oldLayout, VkImageLayout newLayout,
+                                     VkAccessFlags dstAccess, VkPipelineStageFlags dstStage);
 
         bool isDeviceSuitable(VkPhysicalDevice device);
         QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device);
         bool checkDeviceExtensionSupport(VkPhysicalDevice device);
+        std::vector<const char*> getRequiredDeviceExtensions() const;
+        bool isDeviceExtensionSupported(VkPhysicalDevice device, const char* extensionName);
+        void loadDynamicStateFunctions(bool dynamicRasterState, bool dynamicBlendEnable);
         SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device);
         VkSurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats);
         VkPresentModeKHR chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes);
+        uint32_t chooseSwapImageCount(const VkSurfaceCapabilitiesKHR& capabilities);
+        void recreateRenderFinishedSemaphores();
+        void waitForFrameLimit();
         VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities);
         VkShaderModule createShaderModule(const std::vector<char>& code);
         std::vector<char> readShaderFile(const std::string& filename);
@@ -181,8 +413,14 @@ namespace VK
         // Memory allocator for efficient memory management
         std::unique_ptr<MemoryAllocator> m_memoryAllocator;
 
+        // Persistent pipeline cache, saved on shutdown
+        std::unique_ptr<PipelineCache> m_pipelineCache;
+        bool m_pipelineCreationFeedbackSupported;
+
+        QueueFamilyIndices m_queueFamilyIndices;
         VkQueue m_graphicsQueue;
         VkQueue m_presentQueue;
+        VkQueue m_transferQueue;  // Same as m_graphicsQueue without a dedicated transfer family
 
         VkSwapchainKHR m_swapChain;
         std::vector<VkImage> m_swapChainImages;
@@ -191,16 +429,60 @@ namespace VK
         std::vector<VkImageView> m_swapChainImageViews;
         std::vector<VkFramebuffer> m_swapChainFramebuffers;
 
+        // Headless mode: m_swapChainImages are offscreen color targets, one per frame slot
+        bool m_headless;
+        std::vector<Allocation> m_offscreenAllocations;
+        bool m_readbackEnabled;
+        bool m_frameRendered;  // A pass has written the color target this frame
+        std::array<ReadbackBuffer, MAX_FRAMES_IN_FLIGHT> m_readbackBuffers{};
+
         // Depth buffer resources
         VkImage m_depthImage;
-        VkDeviceMemory m_depthImageMemory;
+        Allocation m_depthAllocation;
         VkImageView m_depthImageView;
         VkFormat m_depthFormat;
 
-        VkRenderPass m_renderPass;
+        // Passes render through vkCmdBeginRendering where the device has dynamic rendering
+        // (core 1.3 or VK_KHR_dynamic_rendering), pipelines then only depend on the
+        // attachment formats. Otherwise through m_renderPass and a framebuffer per image.
+        bool m_dynamicRendering;
+        PFN_vkCmdBeginRenderingKHR m_cmdBeginRendering;
+        PFN_vkCmdEndRenderingKHR m_cmdEndRendering;
+        VkRenderPass m_renderPass;  // Clears the attachments, null with dynamic rendering
+        VkRenderPass m_loadRenderPass;  // Compatible with m_renderPass, loads the attachments
         VkDescriptorSetLayout m_descriptorSetLayout;
-        VkPipelineLayout m_pipelineLayout;
-        VkDescriptorPool m_descriptorPool;
+        ShaderLayout m_defaultShaderLayout;  // For shaders without push constants
+        std::vector<std::pair<VkPushConstantRange, VkPipelineLayout>> m_pipelineLayouts;
+        std::unique_ptr<DescriptorAllocator> m_descriptorAllocator;
+
+        // Bindless texture array, the set is bound once per command buffer
+        bool m_bindlessSupported;
+        bool m_bindlessEnabled;
+        uint32_t m_bindlessCapacity;
+        VkDescriptorSetLayout m_bindlessSetLayout;
+        VkDescriptorPool m_bindlessPool;
+        VkDescriptorSet m_bindlessSet;
+        uint32_t m_nextBindlessIndex;
+        std::vector<uint32_t> m_freeBindlessIndices;
+
+        // Per-frame uniform blocks, consecutive draws with unchanged uniforms share one
+        VkDescriptorSetLayout m_uniformSetLayout;
+        std::unique_ptr<UniformRing> m_uniformRing;
+        const ShaderProgram* m_lastUniformShader;
+        uint64_t m_lastUniformVersion;
+        UniformAllocation m_lastUniformBlock;
+
+        // GPU-driven path, null without drawIndirectCount, multiDrawIndirect and
+        // drawIndirectFirstInstance or without shaders/vulkan/cull.comp.spv
+        // The object set layout is part of every pipeline layout so set numbers stay the same
+        VkDescriptorSetLayout m_objectSetLayout;
+        bool m_gpuDrivenSupported;
+        std::unique_ptr<GpuCulling> m_gpuCulling;
+        uint64_t m_gpuCulledFrame;  // Frame the last cull was recorded in
+
+        // Frame the last dispatch was recorded in, the first one of a frame waits for
+        // the storage buffer accesses of the frames before it
+        uint64_t m_computeFrame;
         // m_graphicsPipeline removed - pipelines are now managed by shader manager
 
         VkCommandPool m_commandPool;
@@ -211,16 +493,48 @@ namespace VK
         std::vector<TransferCommandBuffer> m_transferCommandBuffers;
         static constexpr uint32_t TRANSFER_COMMAND_BUFFER_POOL_SIZE = 4;
 
+        // Largest update vkCmdUpdateBuffer accepts
+        static constexpr VkDeviceSize MAX_INLINE_BUFFER_UPDATE = 65536;
+
+        // Upload timeline: signaled by the transfer queue, waited on by the graphics queue
+        VkSemaphore m_uploadTimeline;
+        uint64_t m_uploadValue;      // Last submitted upload
+        uint64_t m_uploadWaitValue;  // Last upload a graphics submission has waited on
+        std::vector<OwnershipAcquire> m_pendingAcquires;
+        std::array<VkCommandBuffer, MAX_FRAMES_IN_FLIGHT> m_acquireCommandBuffers{};
+        std::array<uint32_t, 2> m_uploadQueueFamilies{};  // Graphics and transfer families
+
+        // Persistently mapped staging memory shared by all uploads
+        std::unique_ptr<StagingRing> m_stagingRing;
+
+        // Copies waiting for flushUploads(), merged into one submission
+        std::vector<ImageUpload> m_imageUploads;
+        std::vector<BufferUpload> m_bufferUploads;
+        uint32_t m_uploadBatchDepth;  // Batches may nest, only the outermost one submits
+
+        // Updates made between frames or inside a pass, waiting for a point outside a render pass
+        std::vector<BufferUpdate> m_bufferUpdates;
+
         // Synchronization objects
-        // Semaphores: One per swapchain image (to avoid reuse while in flight)
+        // Acquire semaphores: One per frame slot
+        // Render finished semaphores: One per swapchain image (to avoid reuse while in presentation)
         std::vector<VkSemaphore> m_imageAvailableSemaphores;
         std::vector<VkSemaphore> m_renderFinishedSemaphores;
 
-        // Fences: One per frame in flight (to limit CPU-GPU parallelism)
-        std::vector<VkFence> m_inFlightFences;
+        // Old swapchains and their present semaphores. A completed frame doesn't mean the
+        // present engine is done with them, they are only deferred for deletion once an
+        // image of the current swapchain has been presented.
+        std::vector<VkSwapchainKHR> m_retiredSwapChains;
+        std::vector<VkSemaphore> m_retiredPresentSemaphores;
+
+        // Timeline semaphore signaled with m_frameNumber when a frame completes on the GPU
+        VkSemaphore m_frameTimeline;
+        uint64_t m_frameNumber;  // Number of frames submitted so far
+        uint32_t m_framesInFlight;
 
-        // Track which fence is waiting on which swapchain image
-        std::vector<VkFence> m_imagesInFlight;
+        // Frame number that last used each frame slot / swapchain image (0 = unused)
+        std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> m_frameSlotNumbers{};
+        std::vector<uint64_t> m_imageFrameNumbers;
 
         VkBuffer m_vertexBuffer;
         VkDeviceMemory m_vertexBufferMemory;
@@ -235,15 +549,66 @@ namespace VK
 
         uint32_t m_currentFrame;
         uint32_t m_imageIndex;
-        bool m_framebufferResized;
+        bool m_framebufferResized;  // Resize event since the last recreation, checked once per frame
+        bool m_swapChainRecreatePending;  // Recreation postponed while the window is minimized
         bool m_frameBegun;
-        bool m_cullingEnabled;
-        bool m_depthTestEnabled;
-
-        // Deferred deletion queue
-        std::vector<DeferredDeletion> m_deferredDeletions;
+        bool m_passBegun;
+        bool m_passCleared;  // Nothing was drawn since the pass cleared the attachments
+        bool m_clearPending;  // clear() outside a pass, the next pass clears
+
+        // Presentation policy, a change recreates the swapchain after the next present
+        PresentMode m_presentMode;
+        uint32_t m_swapchainImageCount;  // 0 uses one image more than the surface minimum
+        bool m_presentSettingsChanged;
+
+        // Frame limiter and present timing, zero interval disables the limiter
+        std::chrono::steady_clock::duration m_frameInterval;
+        std::chrono::steady_clock::time_point m_nextFrameStart;
+        std::chrono::steady_clock::time_point m_imageAcquiredTime;
+        FramePresentTiming m_pendingPresentTiming;  // Of the frame being recorded
+        FramePresentTiming m_presentTiming;
+        bool m_presentTimingValid;
+
+        // GPU timestamps and pipeline statistics, null if the device supports neither
+        // Zones opened in a pass recorded by the workers can't be written into the primary
+        // command buffer, they are counted in m_ignoredGpuZones so their ends are skipped too
+        std::unique_ptr<GpuProfiler> m_gpuProfiler;
+        uint32_t m_passZoneDepth;  // Open zones before the pass zone
+        uint32_t m_ignoredGpuZones;
+        uint32_t m_framePassCount;
+
+        // Without inheritedQueries no query may be active while secondary command buffers
+        // execute, so frames recorded by the workers then skip the statistics
+        bool m_pipelineStatisticsSupported;
+        bool m_inheritedQueriesSupported;
+        bool m_pipelineStatisticsEnabled;
+
+        // State bound in the current pass when recording inline, used to skip redundant binds
+        CommandBindState m_bindState;
+
+        // Multi-threaded recording: draws are collected during the pass and
+        // recorded into secondary command buffers by the workers in endPass()
+        bool m_passRecordsSecondaries;
+        VkViewport m_passViewport;
+        VkRect2D m_passScissor;
+        uint32_t m_recordingThreadCount;
+        std::unique_ptr<ParallelRecorder> m_parallelRecorder;
+        std::vector<DrawCommand> m_passDraws;
+        std::vector<VkCommandBuffer> m_secondaryCommandBuffers;
+
+        // Fixed-function state, set with vkCmdSet*() where the device supports it
+        RenderState m_renderState;
+        DynamicStateFunctions m_dynamicState;
+
+        // Pipeline state object cache, only touched by the render thread
+        // Failed compilations stay in the map so a broken key is only attempted once.
+        std::unordered_map<PipelineKey, std::unique_ptr<CompiledPipeline>, PipelineKeyHash> m_pipelines;
+        std::unique_ptr<PipelineCompiler> m_pipelineCompiler;
+        VertexInputLayout m_defaultVertexInput;
+
+        // Deferred deletion queue, ordered by frame number
+        std::deque<DeferredDeletion> m_deferredDeletions;
 
-        const int MAX_FRAMES_IN_FLIGHT = 2;
         const std::vector<const char*> m_deviceExtensions = {
             VK_KHR_SWAPCHAIN_EXTENSION_NAME
         };
@@ -1,6 +1,8 @@
 #include "ShaderManager.h"
 #include "ShaderProgram.h"
+#include "ComputeProgram.h"
 #include "Renderer.h"
+#include "ShaderReflection.h"
 #include "../Logger.h"
 #include <fstream>
 
@@ -55,6 +57,16 @@ IShaderProgram* ShaderManager::createShaderProgram(
         return nullptr;
     }
 
+    // Bindings, push constants and uniform offsets of both stages
+    ShaderReflection reflection;
+    ShaderReflection fragmentReflection;
+    if (!reflectSpirv(vertShaderCode, reflection) || !reflectSpirv(fragShaderCode, fragmentReflection))
+    {
+        LOG_ERROR("[Vulkan] Shader '{}' is not valid SPIR-V", name);
+        return nullptr;
+    }
+    reflection.merge(fragmentReflection);
+
     // Create shader modules
     VkShaderModule vertShaderModule = createShaderModule(vertShaderCode);
     VkShaderModule fragShaderModule = createShaderModule(fragShaderCode);
@@ -71,7 +83,7 @@ IShaderProgram* ShaderManager::createShaderProgram(
 
     // Create shader program wrapper
     auto shaderProgram = std::make_unique<ShaderProgram>(
-        name, m_device, vertShaderModule, fragShaderModule, m_renderer);
+        name, m_device, vertShaderModule, fragShaderModule, reflection, m_renderer);
 
     if (m_shaders.find(name) != m_shaders.end())
     {
@@ -96,23 +108,78 @@ IShaderProgram* ShaderManager::getShader(const std::string& name)
     return nullptr;
 }
 
-void ShaderManager::createAllPipelines(VkRenderPass renderPass,
-                                       VkPipelineLayout pipelineLayout,
-                                       VkExtent2D extent)
+IComputeProgram* ShaderManager::createComputeProgram(
+    const std::string& name,
+    const std::string& computePath)
 {
-    LOG_INFO("[Vulkan] Creating pipelines for all shaders");
-    for (auto& [name, shader] : m_shaders)
+    LOG_INFO("[Vulkan] Loading compute program '{}'", name);
+    LOG_INFO("[Vulkan]   Compute: {}", computePath);
+
+    if (m_device == VK_NULL_HANDLE)
     {
-        shader->createPipeline(renderPass, pipelineLayout, extent);
+        LOG_ERROR("[Vulkan] ShaderManager not initialized with device");
+        return nullptr;
     }
+
+    std::vector<char> computeShaderCode = readFile(m_shaderBasePath + computePath + ".spv");
+    if (computeShaderCode.empty())
+    {
+        LOG_ERROR("[Vulkan] Failed to read compute shader file");
+        return nullptr;
+    }
+
+    ShaderReflection reflection;
+    if (!reflectSpirv(computeShaderCode, reflection))
+    {
+        LOG_ERROR("[Vulkan] Compute program '{}' is not valid SPIR-V", name);
+        return nullptr;
+    }
+
+    VkShaderModule computeShaderModule = createShaderModule(computeShaderCode);
+    if (computeShaderModule == VK_NULL_HANDLE)
+    {
+        LOG_ERROR("[Vulkan] Failed to create compute shader module");
+        return nullptr;
+    }
+
+    // The module is only needed to create the pipeline
+    auto computeProgram = std::make_unique<ComputeProgram>(
+        name, m_device, computeShaderModule, reflection, m_renderer);
+    vkDestroyShaderModule(m_device, computeShaderModule, nullptr);
+
+    if (!computeProgram->isValid())
+    {
+        return nullptr;
+    }
+
+    if (m_computePrograms.find(name) != m_computePrograms.end())
+    {
+        LOG_WARNING("[Vulkan] Replacing existing compute program: '{}'", name);
+    }
+
+    ComputeProgram* computePtr = computeProgram.get();
+    m_computePrograms[name] = std::move(computeProgram);
+
+    LOG_INFO("[Vulkan] Compute program '{}' loaded successfully", name);
+    return computePtr;
+}
+
+IComputeProgram* ShaderManager::getComputeProgram(const std::string& name)
+{
+    auto it = m_computePrograms.find(name);
+    if (it != m_computePrograms.end())
+    {
+        return it->second.get();
+    }
+    return nullptr;
 }
 
-void ShaderManager::destroyAllPipelines()
+void ShaderManager::createAllPipelines()
 {
-    LOG_INFO("[Vulkan] Destroying all pipelines");
+    LOG_INFO("[Vulkan] Creating pipelines for all shaders");
     for (auto& [name, shader] : m_shaders)
     {
-        shader->destroyPipeline();
+        shader->createPipeline();
     }
 }
 
@@ -123,6 +190,7 @@ void ShaderManager::cleanup()
     // Shader programs are automatically deleted by unique_ptr destructors
     // This will also destroy shader modules and pipelines
     m_shaders.clear();
+    m_computePrograms.clear();
     m_currentShader = nullptr;
 }
 
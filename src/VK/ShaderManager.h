@@ -12,6 +12,7 @@ namespace VK
 {
     class Renderer;  // Forward declaration
     class ShaderProgram;  // Forward declaration
+    class ComputeProgram;
 
     class ShaderManager : public IShaderManager
     {
@@ -30,13 +31,17 @@ namespace VK
 
         IShaderProgram* getShader(const std::string& name) override;
 
+        IComputeProgram* createComputeProgram(
+            const std::string& name,
+            const std::string& computePath) override;
+
+        IComputeProgram* getComputeProgram(const std::string& name) override;
+
         void cleanup() override;
 
-        // Vulkan-specific: Pipeline lifecycle management
-        void createAllPipelines(VkRenderPass renderPass,
-                               VkPipelineLayout pipelineLayout,
-                               VkExtent2D extent);
-        void destroyAllPipelines();
+        // Vulkan-specific: Pipeline warm-up
+        // Pipelines themselves are owned by the Renderer, this only warms its cache
+        void createAllPipelines();
 
         // Vulkan-specific: Get current shader for renderer
         ShaderProgram* getCurrentShader() const { return m_currentShader; }
@@ -53,6 +58,7 @@ namespace VK
 
         // Storage for shader programs (ShaderManager owns them)
         std::unordered_map<std::string, std::unique_ptr<ShaderProgram>> m_shaders;
+        std::unordered_map<std::string, std::unique_ptr<ComputeProgram>> m_computePrograms;
 
         // Track currently bound shader
         ShaderProgram* m_currentShader;
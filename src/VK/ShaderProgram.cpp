@@ -1,6 +1,10 @@
 #include "ShaderProgram.h"
 #include "Renderer.h"
+#include "UniformRing.h"
+#include "ShaderReflection.h"
 #include "../Logger.h"
+#include <algorithm>
+#include <cstring>
 
 namespace VK
 {
@@ -9,29 +13,36 @@ ShaderProgram::ShaderProgram(const std::string& name,
                              VkDevice device,
                              VkShaderModule vertModule,
                              VkShaderModule fragModule,
+                             const ShaderReflection& reflection,
                              Renderer* renderer)
     : m_name(name)
     , m_device(device)
     , m_vertexModule(vertModule)
     , m_fragmentModule(fragModule)
-    , m_pipeline(VK_NULL_HANDLE)
     , m_renderer(renderer)
     , m_hasPendingUpdates(false)
+    , m_uniformVersion(0)
     , m_isValid(true)
 {
     // Initialize matrices to identity
     m_pushConstants.model = glm::mat4(1.0f);
     m_pushConstants.view = glm::mat4(1.0f);
     m_pushConstants.projection = glm::mat4(1.0f);
+
+    if (m_renderer)
+    {
+        m_layout = m_renderer->getShaderLayout(m_name, reflection);
+    }
+    resolveUniforms(reflection);
 }
 
 ShaderProgram::~ShaderProgram()
 {
     if (m_device != VK_NULL_HANDLE)
     {
-        if (m_pipeline != VK_NULL_HANDLE)
+        if (m_renderer)
         {
-            vkDestroyPipeline(m_device, m_pipeline, nullptr);
+            m_renderer->releasePipelines(m_vertexModule, m_fragmentModule);
         }
         if (m_vertexModule != VK_NULL_HANDLE)
         {
@@ -49,16 +60,19 @@ ShaderProgram::ShaderProgram(ShaderProgram&& other) noexcept
     , m_device(other.m_device)
     , m_vertexModule(other.m_vertexModule)
     , m_fragmentModule(other.m_fragmentModule)
-    , m_pipeline(other.m_pipeline)
     , m_renderer(other.m_renderer)
+    , m_layout(other.m_layout)
     , m_pushConstants(other.m_pushConstants)
     , m_hasPendingUpdates(other.m_hasPendingUpdates)
+    , m_uniformLocations(std::move(other.m_uniformLocations))
+    , m_warnedUniforms(std::move(other.m_warnedUniforms))
+    , m_uniformData(std::move(other.m_uniformData))
+    , m_uniformVersion(other.m_uniformVersion)
     , m_isValid(other.m_isValid)
 {
     other.m_device = VK_NULL_HANDLE;
     other.m_vertexModule = VK_NULL_HANDLE;
     other.m_fragmentModule = VK_NULL_HANDLE;
-    other.m_pipeline = VK_NULL_HANDLE;
     other.m_renderer = nullptr;
 }
 
@@ -69,8 +83,8 @@ ShaderProgram& ShaderProgram::operator=(ShaderProgram&& other) noexcept
         // Clean up existing resources
         if (m_device != VK_NULL_HANDLE)
         {
-            if (m_pipeline != VK_NULL_HANDLE)
-                vkDestroyPipeline(m_device, m_pipeline, nullptr);
+            if (m_renderer)
+                m_renderer->releasePipelines(m_vertexModule, m_fragmentModule);
             if (m_vertexModule != VK_NULL_HANDLE)
                 vkDestroyShaderModule(m_device, m_vertexModule, nullptr);
             if (m_fragmentModule != VK_NULL_HANDLE)
@@ -82,17 +96,20 @@ ShaderProgram& ShaderProgram::operator=(ShaderProgram&& other) noexcept
         m_device = other.m_device;
         m_vertexModule = other.m_vertexModule;
         m_fragmentModule = other.m_fragmentModule;
-        m_pipeline = other.m_pipeline;
         m_renderer = other.m_renderer;
+        m_layout = other.m_layout;
         m_pushConstants = other.m_pushConstants;
         m_hasPendingUpdates = other.m_hasPendingUpdates;
+        m_uniformLocations = std::move(other.m_uniformLocations);
+        m_warnedUniforms = std::move(other.m_warnedUniforms);
+        m_uniformData = std::move(other.m_uniformData);
+        m_uniformVersion = other.m_uniformVersion + 1;
         m_isValid = other.m_isValid;
 
         // Nullify other
         other.m_device = VK_NULL_HANDLE;
         other.m_vertexModule = VK_NULL_HANDLE;
         other.m_fragmentModule = VK_NULL_HANDLE;
-        other.m_pipeline = VK_NULL_HANDLE;
         other.m_renderer = nullptr;
     }
     return *this;
@@ -120,9 +137,9 @@ void ShaderProgram::unbind()
 
 void ShaderProgram::setBool(const std::string& name, bool value)
 {
-    // Vulkan doesn't have traditional uniforms like OpenGL
-    // For now, we only support matrix uniforms via push constants
-    LOG_WARNING("[Vulkan] setBool not implemented for shader '{}'", m_name);
+    // std140 bools are 4 bytes
+    uint32_t data = value ? 1 : 0;
+    setUniform(name, &data, sizeof(data));
 }
 
 void ShaderProgram::setInt(const std::string& name, int value)
@@ -136,97 +153,114 @@ void ShaderProgram::setInt(const std::string& name, int value)
         return;
     }
 
-    // Other int uniforms would need push constants or descriptor sets
-    LOG_WARNING("[Vulkan] setInt('{}') not implemented for shader '{}' - use push constants", name, m_name);
+    setUniform(name, &value, sizeof(value));
 }
 
 void ShaderProgram::setFloat(const std::string& name, float value)
 {
-    // Vulkan doesn't have traditional uniforms like OpenGL
-    // For now, we only support matrix uniforms via push constants
-    LOG_WARNING("[Vulkan] setFloat not implemented for shader '{}'", m_name);
+    setUniform(name, &value, sizeof(value));
 }
 
 void ShaderProgram::setVec2(const std::string& name, const glm::vec2& value)
 {
-    // Vulkan doesn't have traditional uniforms like OpenGL
-    // For now, we only support matrix uniforms via push constants
-    LOG_WARNING("[Vulkan] setVec2 not implemented for shader '{}'", m_name);
+    setUniform(name, &value, sizeof(value));
 }
 
 void ShaderProgram::setVec3(const std::string& name, const glm::vec3& value)
 {
-    // Vulkan doesn't have traditional uniforms like OpenGL
-    // For now, we only support matrix uniforms via push constants
-    // Could extend PushConstantData to include vec3 fields
-    LOG_WARNING("[Vulkan] setVec3 not implemented for shader '{}'", m_name);
+    setUniform(name, &value, sizeof(value));
 }
 
 void ShaderProgram::setVec4(const std::string& name, const glm::vec4& value)
 {
-    // Vulkan doesn't have traditional uniforms like OpenGL
-    // For now, we only support matrix uniforms via push constants
-    LOG_WARNING("[Vulkan] setVec4 not implemented for shader '{}'", m_name);
+    setUniform(name, &value, sizeof(value));
 }
 
 void ShaderProgram::setMat3(const std::string& name, const glm::mat3& value)
 {
-    // Vulkan doesn't have traditional uniforms like OpenGL
-    // For now, we only support mat4 via push constants
-    LOG_WARNING("[Vulkan] setMat3 not implemented for shader '{}'", m_name);
+    // std140 pads every mat3 column to a vec4
+    glm::vec4 columns[3] = { glm::vec4(value[0], 0.0f), glm::vec4(value[1], 0.0f), glm::vec4(value[2], 0.0f) };
+    setUniform(name, columns, sizeof(columns));
 }
 
 void ShaderProgram::setMat4(const std::string& name, const glm::mat4& value)
 {
-    if (name == "model")
-    {
-        m_pushConstants.model = value;
-        m_hasPendingUpdates = true;
-    }
-    else if (name == "view")
-    {
-        m_pushConstants.view = value;
-        m_hasPendingUpdates = true;
-    }
-    else if (name == "projection")
+    setUniform(name, &value, sizeof(value));
+}
+
+void ShaderProgram::resolveUniforms(const ShaderReflection& reflection)
+{
+    // Push constant members that fit PushConstantData, the bindless texture index
+    // following it is written by the renderer
+    for (const auto& [name, member] : reflection.pushConstantMembers)
     {
-        m_pushConstants.projection = value;
-        m_hasPendingUpdates = true;
+        if (member.offset + member.size <= sizeof(PushConstantData))
+        {
+            m_uniformLocations[name] = UniformLocation{ true, member.offset, member.size };
+        }
     }
-    else
+
+    const ReflectedBinding* block = reflection.findBinding(UNIFORM_SET, 0);
+    if (block && block->type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
     {
-        LOG_WARNING("[Vulkan] Unknown mat4 uniform '{}' for shader '{}'", name, m_name);
+        if (block->blockSize > UniformRing::MAX_BLOCK_SIZE)
+        {
+            LOG_WARNING("[Vulkan] Uniform block of shader '{}' is {} bytes, only {} are written",
+                        m_name, block->blockSize, UniformRing::MAX_BLOCK_SIZE);
+        }
+        m_uniformData.assign(std::min(block->blockSize, UniformRing::MAX_BLOCK_SIZE), 0);
+
+        for (const auto& [name, member] : block->members)
+        {
+            if (member.offset + member.size <= m_uniformData.size())
+            {
+                m_uniformLocations.emplace(name, UniformLocation{ false, member.offset, member.size });
+            }
+        }
     }
+
+    LOG_DEBUG("[Vulkan] Shader '{}': {} uniforms, {} byte uniform block",
+              m_name, m_uniformLocations.size(), m_uniformData.size());
 }
 
-void ShaderProgram::createPipeline(VkRenderPass renderPass,
-                                   VkPipelineLayout pipelineLayout,
-                                   VkExtent2D extent)
+void ShaderProgram::setUniform(const std::string& name, const void* data, uint32_t size)
 {
-    if (m_renderer)
+    auto it = m_uniformLocations.find(name);
+    if (it == m_uniformLocations.end() || size > it->second.size)
     {
-        m_pipeline = m_renderer->createPipelineForShader(
-            m_vertexModule, m_fragmentModule, renderPass, pipelineLayout, extent);
-
-        if (m_pipeline == VK_NULL_HANDLE)
-        {
-            LOG_ERROR("[Vulkan] Failed to create pipeline for shader '{}'", m_name);
-            m_isValid = false;
-        }
-        else
+        if (m_warnedUniforms.insert(name).second)
         {
-            LOG_INFO("[Vulkan] Pipeline created for shader '{}'", m_name);
+            LOG_WARNING("[Vulkan] Shader '{}' has no uniform '{}' of this type", m_name, name);
         }
+        return;
+    }
+
+    const UniformLocation& location = it->second;
+    if (location.pushConstant)
+    {
+        std::memcpy(reinterpret_cast<uint8_t*>(&m_pushConstants) + location.offset, data, size);
+        m_hasPendingUpdates = true;
+        return;
+    }
+
+    // Unchanged values keep the previous upload
+    uint8_t* destination = m_uniformData.data() + location.offset;
+    if (std::memcmp(destination, data, size) != 0)
+    {
+        std::memcpy(destination, data, size);
+        m_uniformVersion++;
     }
 }
 
-void ShaderProgram::destroyPipeline()
+void ShaderProgram::createPipeline()
 {
-    if (m_device != VK_NULL_HANDLE && m_pipeline != VK_NULL_HANDLE)
+    if (m_renderer)
     {
-        vkDestroyPipeline(m_device, m_pipeline, nullptr);
-        m_pipeline = VK_NULL_HANDLE;
-        LOG_DEBUG("[Vulkan] Pipeline destroyed for shader '{}'", m_name);
+        // Warms the renderer's pipeline cache with the most common key,
+        // compiled in the background so loading a shader doesn't stall the frame
+        PipelineKey key = m_renderer->makePipelineKey(*this, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+        m_renderer->requestPipeline(key);
+        LOG_INFO("[Vulkan] Pipeline queued for shader '{}'", m_name);
     }
 }
 
@@ -1,13 +1,19 @@
 #pragma once
 
 #include "../RenderAPI/IShaderProgram.h"
+#include "PipelineState.h"
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
 #include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
 
 namespace VK
 {
     class Renderer;  // Forward declaration
+    struct ShaderReflection;
 
     struct PushConstantData
     {
@@ -18,7 +24,8 @@ namespace VK
 
     /**
      * Vulkan implementation of IShaderProgram
-     * RAII wrapper for Vulkan shader modules and pipeline
+     * RAII wrapper for Vulkan shader modules
+     * Pipelines built from the modules are cached by the Renderer
      */
     class ShaderProgram : public IShaderProgram
     {
@@ -29,12 +36,14 @@ namespace VK
          * @param device Vulkan device
          * @param vertModule Vertex shader module
          * @param fragModule Fragment shader module
+         * @param reflection Interface of both stages, uniform names are resolved from it
          * @param renderer Pointer to renderer (for pipeline creation)
          */
         ShaderProgram(const std::string& name,
                       VkDevice device,
                       VkShaderModule vertModule,
                       VkShaderModule fragModule,
+                      const ShaderReflection& reflection,
                       Renderer* renderer);
 
         ~ShaderProgram() override;
@@ -65,37 +74,53 @@ namespace VK
 
         // Vulkan-specific methods
         /**
-         * Create the Vulkan pipeline for this shader
-         * Called by Renderer after shader creation or during swap chain recreation
+         * Queue the pipeline for triangle lists with the current render state
+         * Called by Renderer after shader creation or during swap chain recreation,
+         * pipelines for other topologies and states are queued on first use
          */
-        void createPipeline(VkRenderPass renderPass,
-                           VkPipelineLayout pipelineLayout,
-                           VkExtent2D extent);
-
-        /**
-         * Destroy the pipeline (for swap chain recreation)
-         */
-        void destroyPipeline();
+        void createPipeline();
 
         // Vulkan-specific accessors
-        VkPipeline getPipeline() const { return m_pipeline; }
         VkShaderModule getVertexModule() const { return m_vertexModule; }
         VkShaderModule getFragmentModule() const { return m_fragmentModule; }
+        VkPipelineLayout getPipelineLayout() const { return m_layout.pipelineLayout; }
+        const VkPushConstantRange& getPushConstantRange() const { return m_layout.pushConstantRange; }
 
         const PushConstantData& getPushConstants() const { return m_pushConstants; }
         bool hasPendingUpdates() const { return m_hasPendingUpdates; }
         void clearPendingUpdates() { m_hasPendingUpdates = false; }
 
+        // Uniform block at UNIFORM_SET binding 0, copied into the renderer's uniform ring per draw
+        bool hasUniforms() const { return !m_uniformData.empty(); }
+        const std::vector<uint8_t>& getUniformData() const { return m_uniformData; }
+        uint64_t getUniformVersion() const { return m_uniformVersion; }  // Changes whenever a value changes
+
     private:
+        // Where a uniform name lives, resolved from the reflection when the shader is loaded
+        struct UniformLocation
+        {
+            bool pushConstant;  // Otherwise in the uniform block
+            uint32_t offset;
+            uint32_t size;
+        };
+
+        void resolveUniforms(const ShaderReflection& reflection);
+        void setUniform(const std::string& name, const void* data, uint32_t size);
+
         std::string m_name;
         VkDevice m_device;
         VkShaderModule m_vertexModule;
         VkShaderModule m_fragmentModule;
-        VkPipeline m_pipeline;
         Renderer* m_renderer;
+        ShaderLayout m_layout;
 
         PushConstantData m_pushConstants;
         bool m_hasPendingUpdates;
+
+        std::unordered_map<std::string, UniformLocation> m_uniformLocations;
+        std::unordered_set<std::string> m_warnedUniforms;  // Unknown names are reported once
+        std::vector<uint8_t> m_uniformData;
+        uint64_t m_uniformVersion;
         bool m_isValid;
     };
 
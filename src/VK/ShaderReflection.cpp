@@ -0,0 +1,560 @@
+#include "ShaderReflection.h"
+#include <algorithm>
+#include <cstring>
+
+namespace VK
+{
+
+namespace
+{
+    // Subset of the SPIR-V specification needed to find a module's resource interface
+    constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+    constexpr uint32_t SPIRV_HEADER_WORDS = 5;
+
+    constexpr uint32_t OP_NAME = 5;
+    constexpr uint32_t OP_MEMBER_NAME = 6;
+    constexpr uint32_t OP_ENTRY_POINT = 15;
+    constexpr uint32_t OP_TYPE_INT = 21;
+    constexpr uint32_t OP_TYPE_FLOAT = 22;
+    constexpr uint32_t OP_TYPE_VECTOR = 23;
+    constexpr uint32_t OP_TYPE_MATRIX = 24;
+    constexpr uint32_t OP_TYPE_IMAGE = 25;
+    constexpr uint32_t OP_TYPE_SAMPLER = 26;
+    constexpr uint32_t OP_TYPE_SAMPLED_IMAGE = 27;
+    constexpr uint32_t OP_TYPE_ARRAY = 28;
+    constexpr uint32_t OP_TYPE_RUNTIME_ARRAY = 29;
+    constexpr uint32_t OP_TYPE_STRUCT = 30;
+    constexpr uint32_t OP_TYPE_POINTER = 32;
+    constexpr uint32_t OP_CONSTANT = 43;
+    constexpr uint32_t OP_VARIABLE = 59;
+    constexpr uint32_t OP_DECORATE = 71;
+    constexpr uint32_t OP_MEMBER_DECORATE = 72;
+
+    constexpr uint32_t DECORATION_BUFFER_BLOCK = 3;
+    constexpr uint32_t DECORATION_ARRAY_STRIDE = 6;
+    constexpr uint32_t DECORATION_MATRIX_STRIDE = 7;
+    constexpr uint32_t DECORATION_BINDING = 33;
+    constexpr uint32_t DECORATION_DESCRIPTOR_SET = 34;
+    constexpr uint32_t DECORATION_OFFSET = 35;
+
+    constexpr uint32_t STORAGE_UNIFORM_CONSTANT = 0;
+    constexpr uint32_t STORAGE_UNIFORM = 2;
+    constexpr uint32_t STORAGE_PUSH_CONSTANT = 9;
+    constexpr uint32_t STORAGE_STORAGE_BUFFER = 12;
+
+    constexpr uint32_t DIM_BUFFER = 5;
+    constexpr uint32_t DIM_SUBPASS_DATA = 6;
+
+    struct SpirvId
+    {
+        uint32_t opcode = 0;
+        std::vector<uint32_t> operands;  // Words following the result id
+        std::string name;
+        std::vector<std::string> memberNames;
+        std::vector<uint32_t> memberOffsets;
+        std::vector<uint32_t> memberMatrixStrides;
+        uint32_t set = 0;
+        uint32_t binding = UINT32_MAX;
+        uint32_t arrayStride = 0;
+        bool bufferBlock = false;
+    };
+
+    struct SpirvVariable
+    {
+        uint32_t id;
+        uint32_t pointerType;
+        uint32_t storageClass;
+    };
+
+    std::string readString(const uint32_t* words, uint32_t wordCount)
+    {
+        // Null terminated and padded to a whole word
+        const char* chars = reinterpret_cast<const char*>(words);
+        const char* end = chars + static_cast<size_t>(wordCount) * sizeof(uint32_t);
+        return std::string(chars, std::find(chars, end, '\0'));
+    }
+
+    VkShaderStageFlags convertExecutionModel(uint32_t executionModel)
+    {
+        switch (executionModel)
+        {
+            case 0:  return VK_SHADER_STAGE_VERTEX_BIT;
+            case 1:  return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+            case 2:  return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+            case 3:  return VK_SHADER_STAGE_GEOMETRY_BIT;
+            case 4:  return VK_SHADER_STAGE_FRAGMENT_BIT;
+            case 5:  return VK_SHADER_STAGE_COMPUTE_BIT;
+            default: return 0;
+        }
+    }
+
+    void growMembers(SpirvId& id, uint32_t member)
+    {
+        if (id.memberNames.size() <= member)
+        {
+            id.memberNames.resize(member + 1);
+            id.memberOffsets.resize(member + 1, 0);
+            id.memberMatrixStrides.resize(member + 1, 0);
+        }
+    }
+
+    class SpirvModule
+    {
+    public:
+        explicit SpirvModule(uint32_t bound) : m_ids(bound) {}
+
+        SpirvId* get(uint32_t id) { return id < m_ids.size() ? &m_ids[id] : nullptr; }
+
+        uint32_t constantValue(uint32_t id)
+        {
+            SpirvId* constant = get(id);
+            return (constant && constant->opcode == OP_CONSTANT && !constant->operands.empty())
+                ? constant->operands[0] : 0;
+        }
+
+        // Size as laid out in a block, matrixStride comes from the enclosing struct member
+        uint32_t typeSize(uint32_t typeId, uint32_t matrixStride = 0, uint32_t depth = 0)
+        {
+            SpirvId* type = get(typeId);
+            if (!type || depth > MAX_TYPE_DEPTH)
+            {
+                return 0;
+            }
+
+            switch (type->opcode)
+            {
+                case OP_TYPE_INT:
+                case OP_TYPE_FLOAT:
+                    return type->operands.empty() ? 0 : type->operands[0] / 8;
+                case OP_TYPE_VECTOR:
+                    return type->operands.size() < 2 ? 0
+                        : typeSize(type->operands[0], 0, depth + 1) * type->operands[1];
+                case OP_TYPE_MATRIX:
+                {
+                    if (type->operands.size() < 2)
+                    {
+                        return 0;
+                    }
+                    // Without a stride columns are padded to a vec4 like std140
+                    uint32_t columnSize = typeSize(type->operands[0], 0, depth + 1);
+                    uint32_t stride = matrixStride ? matrixStride : (columnSize + 15) / 16 * 16;
+                    return stride * type->operands[1];
+                }
+                case OP_TYPE_ARRAY:
+                {
+                    if (type->operands.size() < 2)
+                    {
+                        return 0;
+                    }
+                    uint32_t stride = type->arrayStride
+                        ? type->arrayStride
+                        : typeSize(type->operands[0], matrixStride, depth + 1);
+                    return stride * constantValue(type->operands[1]);
+                }
+                case OP_TYPE_STRUCT:
+                {
+                    uint32_t size = 0;
+                    for (uint32_t i = 0; i < type->operands.size(); i++)
+                    {
+                        uint32_t offset = i < type->memberOffsets.size() ? type->memberOffsets[i] : 0;
+                        uint32_t stride = i < type->memberMatrixStrides.size() ? type->memberMatrixStrides[i] : 0;
+                        size = std::max(size, offset + typeSize(type->operands[i], stride, depth + 1));
+                    }
+                    return size;
+                }
+                default:
+                    return 0;  // Runtime arrays and opaque types take no block space
+            }
+        }
+
+        void collectMembers(uint32_t structId, const std::string& prefix, uint32_t baseOffset,
+                            std::unordered_map<std::string, ReflectedMember>& members, uint32_t depth = 0)
+        {
+            SpirvId* type = get(structId);
+            if (!type || type->opcode != OP_TYPE_STRUCT || depth > MAX_TYPE_DEPTH)
+            {
+                return;
+            }
+
+            for (uint32_t i = 0; i < type->operands.size(); i++)
+            {
+                growMembers(*type, i);
+                std::string name = type->memberNames[i].empty()
+                    ? "_m" + std::to_string(i)
+                    : type->memberNames[i];
+                name = prefix + name;
+
+                ReflectedMember member;
+                member.offset = baseOffset + type->memberOffsets[i];
+                member.size = typeSize(type->operands[i], type->memberMatrixStrides[i]);
+                members[name] = member;
+
+                collectMembers(type->operands[i], name + ".", member.offset, members, depth + 1);
+            }
+        }
+
+    private:
+        std::vector<SpirvId> m_ids;
+
+        static constexpr uint32_t MAX_TYPE_DEPTH = 32;
+    };
+
+} // namespace
+
+const ReflectedBinding* ShaderReflection::findBinding(uint32_t set, uint32_t binding) const
+{
+    for (const ReflectedBinding& reflected : bindings)
+    {
+        if (reflected.set == set && reflected.binding == binding)
+        {
+            return &reflected;
+        }
+    }
+    return nullptr;
+}
+
+void ShaderReflection::merge(const ShaderReflection& other)
+{
+    stages |= other.stages;
+
+    for (const ReflectedBinding& binding : other.bindings)
+    {
+        auto it = std::find_if(bindings.begin(), bindings.end(), [&](const ReflectedBinding& existing)
+        {
+            return existing.set == binding.set && existing.binding == binding.binding;
+        });
+
+        if (it != bindings.end())
+        {
+            it->stages |= binding.stages;
+            it->count = std::max(it->count, binding.count);
+            it->blockSize = std::max(it->blockSize, binding.blockSize);
+            it->members.insert(binding.members.begin(), binding.members.end());
+        }
+        else
+        {
+            bindings.push_back(binding);
+        }
+    }
+
+    pushConstantMembers.insert(other.pushConstantMembers.begin(), other.pushConstantMembers.end());
+
+    if (other.pushConstantRange.size > 0)
+    {
+        if (pushConstantRange.size == 0)
+        {
+            pushConstantRange = other.pushConstantRange;
+        }
+        else
+        {
+            uint32_t begin = std::min(pushConstantRange.offset, other.pushConstantRange.offset);
+            uint32_t end = std::max(pushConstantRange.offset + pushConstantRange.size,
+                                    other.pushConstantRange.offset + other.pushConstantRange.size);
+            pushConstantRange.stageFlags |= other.pushConstantRange.stageFlags;
+            pushConstantRange.offset = begin;
+            pushConstantRange.size = end - begin;
+        }
+    }
+}
+
+bool reflectSpirv(const std::vector<char>& code, ShaderReflection& reflection)
+{
+    if (code.size() < SPIRV_HEADER_WORDS * sizeof(uint32_t) || code.size() % sizeof(uint32_t) != 0)
+    {
+        return false;
+    }
+
+    std::vector<uint32_t> words(code.size() / sizeof(uint32_t));
+    std::memcpy(words.data(), code.data(), code.size());
+
+    if (words[0] != SPIRV_MAGIC)
+    {
+        return false;
+    }
+
+    // The id bound sizes the id table, a real module never has more ids than words
+    if (words[3] > words.size())
+    {
+        return false;
+    }
+
+    SpirvModule module(words[3]);
+    std::vector<SpirvVariable> variables;
+    std::vector<size_t> memberInstructions;
+    VkShaderStageFlags stage = 0;
+
+    size_t position = SPIRV_HEADER_WORDS;
+    while (position < words.size())
+    {
+        uint32_t opcode = words[position] & 0xFFFF;
+        uint32_t wordCount = words[position] >> 16;
+        if (wordCount == 0 || position + wordCount > words.size())
+        {
+            return false;
+        }
+
+        const uint32_t* operands = &words[position + 1];
+        uint32_t operandCount = wordCount - 1;
+
+        switch (opcode)
+        {
+            case OP_NAME:
+                if (operandCount >= 2)
+                {
+                    if (SpirvId* id = module.get(operands[0]))
+                    {
+                        id->name = readString(operands + 1, operandCount - 1);
+                    }
+                }
+                break;
+
+            case OP_MEMBER_NAME:
+                if (operandCount >= 3)
+                {
+                    memberInstructions.push_back(position);
+                }
+                break;
+
+            case OP_ENTRY_POINT:
+                // Modules with several entry points are attributed to the first one
+                if (operandCount >= 1 && stage == 0)
+                {
+                    stage = convertExecutionModel(operands[0]);
+                }
+                break;
+
+            case OP_TYPE_INT:
+            case OP_TYPE_FLOAT:
+            case OP_TYPE_VECTOR:
+            case OP_TYPE_MATRIX:
+            case OP_TYPE_IMAGE:
+            case OP_TYPE_SAMPLER:
+            case OP_TYPE_SAMPLED_IMAGE:
+            case OP_TYPE_ARRAY:
+            case OP_TYPE_RUNTIME_ARRAY:
+            case OP_TYPE_STRUCT:
+            case OP_TYPE_POINTER:
+                if (operandCount >= 1)
+                {
+                    if (SpirvId* id = module.get(operands[0]))
+                    {
+                        id->opcode = opcode;
+                        id->operands.assign(operands + 1, operands + operandCount);
+                    }
+                }
+                break;
+
+            case OP_CONSTANT:
+                // Result type comes first, only the value of 32-bit constants is used
+                if (operandCount >= 3)
+                {
+                    if (SpirvId* id = module.get(operands[1]))
+                    {
+                        id->opcode = opcode;
+                        id->operands.assign(operands + 2, operands + operandCount);
+                    }
+                }
+                break;
+
+            case OP_VARIABLE:
+                if (operandCount >= 3)
+                {
+                    SpirvVariable variable;
+                    variable.pointerType = operands[0];
+                    variable.id = operands[1];
+                    variable.storageClass = operands[2];
+                    variables.push_back(variable);
+                }
+                break;
+
+            case OP_DECORATE:
+                if (operandCount >= 2)
+                {
+                    SpirvId* id = module.get(operands[0]);
+                    if (!id)
+                    {
+                        break;
+                    }
+
+                    uint32_t value = operandCount >= 3 ? operands[2] : 0;
+                    switch (operands[1])
+                    {
+                        case DECORATION_BUFFER_BLOCK:   id->bufferBlock = true; break;
+                        case DECORATION_ARRAY_STRIDE:   id->arrayStride = value; break;
+                        case DECORATION_BINDING:        id->binding = value; break;
+                        case DECORATION_DESCRIPTOR_SET: id->set = value; break;
+                        default: break;
+                    }
+                }
+                break;
+
+            case OP_MEMBER_DECORATE:
+                if (operandCount >= 4)
+                {
+                    memberInstructions.push_back(position);
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        position += wordCount;
+    }
+
+    // Member names and decorations come before the struct types they refer to,
+    // so their member indices are checked once all types are known
+    for (size_t memberPosition : memberInstructions)
+    {
+        uint32_t opcode = words[memberPosition] & 0xFFFF;
+        uint32_t operandCount = (words[memberPosition] >> 16) - 1;
+        const uint32_t* operands = &words[memberPosition + 1];
+
+        SpirvId* id = module.get(operands[0]);
+        if (!id || id->opcode != OP_TYPE_STRUCT || operands[1] >= id->operands.size())
+        {
+            return false;
+        }
+
+        growMembers(*id, operands[1]);
+        if (opcode == OP_MEMBER_NAME)
+        {
+            id->memberNames[operands[1]] = readString(operands + 2, operandCount - 2);
+        }
+        else if (operands[2] == DECORATION_OFFSET)
+        {
+            id->memberOffsets[operands[1]] = operands[3];
+        }
+        else if (operands[2] == DECORATION_MATRIX_STRIDE)
+        {
+            id->memberMatrixStrides[operands[1]] = operands[3];
+        }
+    }
+
+    reflection = ShaderReflection();
+    reflection.stages = stage;
+
+    uint32_t pushConstantBegin = UINT32_MAX;
+    uint32_t pushConstantEnd = 0;
+
+    for (const SpirvVariable& variable : variables)
+    {
+        SpirvId* pointer = module.get(variable.pointerType);
+        if (!pointer || pointer->opcode != OP_TYPE_POINTER || pointer->operands.size() < 2)
+        {
+            continue;
+        }
+        uint32_t typeId = pointer->operands[1];
+
+        if (variable.storageClass == STORAGE_PUSH_CONSTANT)
+        {
+            module.collectMembers(typeId, "", 0, reflection.pushConstantMembers);
+
+            // Only top level members define the range
+            SpirvId* block = module.get(typeId);
+            if (block && block->opcode == OP_TYPE_STRUCT)
+            {
+                for (uint32_t i = 0; i < block->operands.size(); i++)
+                {
+                    growMembers(*block, i);
+                    uint32_t offset = block->memberOffsets[i];
+                    uint32_t size = module.typeSize(block->operands[i], block->memberMatrixStrides[i]);
+                    pushConstantBegin = std::min(pushConstantBegin, offset);
+                    pushConstantEnd = std::max(pushConstantEnd, offset + size);
+                }
+            }
+            continue;
+        }
+
+        if (variable.storageClass != STORAGE_UNIFORM_CONSTANT &&
+            variable.storageClass != STORAGE_UNIFORM &&
+            variable.storageClass != STORAGE_STORAGE_BUFFER)
+        {
+            continue;
+        }
+
+        SpirvId* decorations = module.get(variable.id);
+        if (!decorations || decorations->binding == UINT32_MAX)
+        {
+            continue;
+        }
+
+        ReflectedBinding binding;
+        binding.set = decorations->set;
+        binding.binding = decorations->binding;
+        binding.count = 1;
+        binding.stages = stage;
+        binding.blockSize = 0;
+
+        // Arrays of descriptors
+        SpirvId* type = module.get(typeId);
+        while (type && (type->opcode == OP_TYPE_ARRAY || type->opcode == OP_TYPE_RUNTIME_ARRAY) &&
+               !type->operands.empty())
+        {
+            binding.count = type->opcode == OP_TYPE_ARRAY
+                ? binding.count * module.constantValue(type->operands[1])
+                : 0;
+            typeId = type->operands[0];
+            type = module.get(typeId);
+        }
+
+        if (!type)
+        {
+            continue;
+        }
+
+        switch (type->opcode)
+        {
+            case OP_TYPE_SAMPLED_IMAGE:
+                binding.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                break;
+            case OP_TYPE_SAMPLER:
+                binding.type = VK_DESCRIPTOR_TYPE_SAMPLER;
+                break;
+            case OP_TYPE_IMAGE:
+            {
+                // Operands: sampled type, dim, depth, arrayed, multisampled, sampled, format
+                uint32_t dim = type->operands.size() > 1 ? type->operands[1] : 0;
+                bool storage = type->operands.size() > 5 && type->operands[5] == 2;
+                if (dim == DIM_BUFFER)
+                {
+                    binding.type = storage ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER
+                                           : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+                }
+                else if (dim == DIM_SUBPASS_DATA)
+                {
+                    binding.type = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+                }
+                else
+                {
+                    binding.type = storage ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE
+                                           : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+                }
+                break;
+            }
+            case OP_TYPE_STRUCT:
+                binding.type = (variable.storageClass == STORAGE_STORAGE_BUFFER || type->bufferBlock)
+                    ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER
+                    : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                binding.blockSize = module.typeSize(typeId);
+                module.collectMembers(typeId, "", 0, binding.members);
+                break;
+            default:
+                continue;  // Acceleration structures and other types the renderer doesn't bind
+        }
+
+        reflection.bindings.push_back(std::move(binding));
+    }
+
+    if (pushConstantEnd > 0)
+    {
+        // Ranges must be 4 byte aligned
+        reflection.pushConstantRange.stageFlags = stage;
+        reflection.pushConstantRange.offset = pushConstantBegin / 4 * 4;
+        reflection.pushConstantRange.size = (pushConstantEnd + 3) / 4 * 4 - reflection.pushConstantRange.offset;
+    }
+
+    return true;
+}
+
+} // namespace VK
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+
+namespace VK
+{
+    // Byte range of a block member, nested struct members are named "outer.inner"
+    struct ReflectedMember
+    {
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    // Descriptor binding used by a shader
+    struct ReflectedBinding
+    {
+        uint32_t set;
+        uint32_t binding;
+        VkDescriptorType type;
+        uint32_t count;  // 0 for runtime-sized arrays
+        VkShaderStageFlags stages;
+
+        // Uniform and storage buffer blocks only
+        uint32_t blockSize;
+        std::unordered_map<std::string, ReflectedMember> members;
+    };
+
+    // Resource interface of a shader program, read from its SPIR-V
+    struct ShaderReflection
+    {
+        VkShaderStageFlags stages = 0;
+        std::vector<ReflectedBinding> bindings;
+
+        // Push constant members of all stages, pushConstantRange covers every one of them
+        // with the stages that declare a push constant block
+        std::unordered_map<std::string, ReflectedMember> pushConstantMembers;
+        VkPushConstantRange pushConstantRange{};
+
+        const ReflectedBinding* findBinding(uint32_t set, uint32_t binding) const;
+
+        // Combine with the reflection of another stage of the same program
+        void merge(const ShaderReflection& other);
+    };
+
+    // Parse the entry point, descriptor bindings and push constants of a SPIR-V module
+    // Returns false if the code is not valid SPIR-V
+    bool reflectSpirv(const std::vector<char>& code, ShaderReflection& reflection);
+
+} // namespace VK
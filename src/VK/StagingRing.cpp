@@ -0,0 +1,273 @@
+#include "StagingRing.h"
+#include "../Logger.h"
+#include <stdexcept>
+
+namespace VK
+{
+
+namespace
+{
+    // Whether space tagged with the upload or frame that uses it may be reused
+    bool isRetired(uint64_t uploadValue, uint64_t frameNumber,
+                   uint64_t completedUploadValue, uint64_t completedFrameNumber)
+    {
+        if (frameNumber != 0)
+        {
+            return frameNumber <= completedFrameNumber;
+        }
+        return uploadValue != 0 && uploadValue <= completedUploadValue;
+    }
+}
+
+StagingRing::StagingRing(VkDevice device, MemoryAllocator* allocator, const std::vector<uint32_t>& queueFamilies,
+                         VkDeviceSize capacity)
+    : m_device(device)
+    , m_allocator(allocator)
+    , m_queueFamilies(queueFamilies)
+    , m_buffer(VK_NULL_HANDLE)
+    , m_allocation{}
+    , m_mapped(nullptr)
+    , m_capacity(capacity)
+    , m_head(0)
+    , m_used(0)
+    , m_unsubmittedBytes(0)
+{
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = m_capacity;
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    setSharingMode(bufferInfo);
+
+    if (vkCreateBuffer(m_device, &bufferInfo, nullptr, &m_buffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create staging ring buffer");
+    }
+
+    m_allocation = m_allocator->allocateBufferMemory(m_buffer,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    vkBindBufferMemory(m_device, m_buffer, m_allocation.memory, m_allocation.offset);
+
+    // Mapped once for the lifetime of the ring
+    void* mapped = nullptr;
+    if (vkMapMemory(m_device, m_allocation.memory, m_allocation.offset, m_capacity, 0, &mapped) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to map staging ring buffer");
+    }
+    m_mapped = static_cast<uint8_t*>(mapped);
+
+    LOG_INFO("[Vulkan] Staging ring created: {} MB", m_capacity / (1024 * 1024));
+}
+
+StagingRing::~StagingRing()
+{
+    // The owner guarantees that no upload is still in flight
+    for (SpillBuffer& spill : m_spills)
+    {
+        vkDestroyBuffer(m_device, spill.buffer, nullptr);
+        m_allocator->free(spill.allocation);
+    }
+    m_spills.clear();
+
+    if (m_mapped)
+    {
+        vkUnmapMemory(m_device, m_allocation.memory);
+        m_mapped = nullptr;
+    }
+
+    if (m_buffer != VK_NULL_HANDLE)
+    {
+        vkDestroyBuffer(m_device, m_buffer, nullptr);
+        m_allocator->free(m_allocation);
+        m_buffer = VK_NULL_HANDLE;
+    }
+}
+
+StagingAllocation StagingRing::allocate(VkDeviceSize size, VkDeviceSize alignment)
+{
+    return allocateRange(size, alignment, 0);
+}
+
+StagingAllocation StagingRing::allocateForFrame(VkDeviceSize size, VkDeviceSize alignment, uint64_t frameNumber)
+{
+    return allocateRange(size, alignment, frameNumber);
+}
+
+StagingAllocation StagingRing::allocateRange(VkDeviceSize size, VkDeviceSize alignment, uint64_t frameNumber)
+{
+    if (alignment == 0)
+    {
+        alignment = 1;
+    }
+
+    if (size <= m_capacity)
+    {
+        VkDeviceSize offset = ((m_head + alignment - 1) / alignment) * alignment;
+        VkDeviceSize padding = offset - m_head;
+
+        // Wrap around, the tail end of the buffer is wasted until this range retires
+        if (offset + size > m_capacity)
+        {
+            padding = m_capacity - m_head;
+            offset = 0;
+        }
+
+        VkDeviceSize total = padding + size;
+        if (m_used + total <= m_capacity)
+        {
+            m_head = offset + size;
+            m_used += total;
+
+            if (frameNumber == 0)
+            {
+                m_unsubmittedBytes += total;
+            }
+            else
+            {
+                // Ranges retire in ring order, the uploads allocated before this range
+                // get their own one, tagged when they are submitted
+                if (m_unsubmittedBytes > 0)
+                {
+                    m_pendingRanges.push_back({m_unsubmittedBytes, 0, 0});
+                    m_unsubmittedBytes = 0;
+                }
+
+                if (!m_pendingRanges.empty() && m_pendingRanges.back().frameNumber == frameNumber)
+                {
+                    m_pendingRanges.back().bytes += total;
+                }
+                else
+                {
+                    m_pendingRanges.push_back({total, 0, frameNumber});
+                }
+            }
+
+            StagingAllocation allocation;
+            allocation.buffer = m_buffer;
+            allocation.offset = offset;
+            allocation.mapped = m_mapped + offset;
+            return allocation;
+        }
+    }
+
+    // Too large for the ring, or the ring is full of in-flight uploads
+    return allocateSpill(size, frameNumber);
+}
+
+StagingAllocation StagingRing::allocateSpill(VkDeviceSize size, uint64_t frameNumber)
+{
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    setSharingMode(bufferInfo);
+
+    SpillBuffer spill{};
+    if (vkCreateBuffer(m_device, &bufferInfo, nullptr, &spill.buffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create staging spill buffer");
+    }
+
+    // Dedicated so the memory is actually returned when the spill retires
+    spill.allocation = m_allocator->allocateBufferMemory(spill.buffer,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, true);
+    vkBindBufferMemory(m_device, spill.buffer, spill.allocation.memory, spill.allocation.offset);
+
+    void* mapped = nullptr;
+    if (vkMapMemory(m_device, spill.allocation.memory, spill.allocation.offset, size, 0, &mapped) != VK_SUCCESS)
+    {
+        vkDestroyBuffer(m_device, spill.buffer, nullptr);
+        m_allocator->free(spill.allocation);
+        throw std::runtime_error("Failed to map staging spill buffer");
+    }
+
+    spill.uploadValue = 0;
+    spill.frameNumber = frameNumber;
+    m_spills.push_back(spill);
+
+    LOG_DEBUG("[Vulkan] Staging upload of {} bytes spilled to a temporary buffer", size);
+
+    StagingAllocation allocation;
+    allocation.buffer = spill.buffer;
+    allocation.offset = 0;
+    allocation.mapped = mapped;
+    return allocation;
+}
+
+void StagingRing::markSubmitted(uint64_t uploadValue)
+{
+    // Upload ranges closed early by a frame's allocation
+    for (PendingRange& range : m_pendingRanges)
+    {
+        if (range.uploadValue == 0 && range.frameNumber == 0)
+        {
+            range.uploadValue = uploadValue;
+        }
+    }
+
+    if (m_unsubmittedBytes > 0)
+    {
+        PendingRange range;
+        range.bytes = m_unsubmittedBytes;
+        range.uploadValue = uploadValue;
+        range.frameNumber = 0;
+        m_pendingRanges.push_back(range);
+        m_unsubmittedBytes = 0;
+    }
+
+    for (SpillBuffer& spill : m_spills)
+    {
+        if (spill.uploadValue == 0 && spill.frameNumber == 0)
+        {
+            spill.uploadValue = uploadValue;
+        }
+    }
+}
+
+void StagingRing::reclaim(uint64_t completedUploadValue, uint64_t completedFrameNumber)
+{
+    // Ranges retire in ring order
+    while (!m_pendingRanges.empty() &&
+           isRetired(m_pendingRanges.front().uploadValue, m_pendingRanges.front().frameNumber,
+                     completedUploadValue, completedFrameNumber))
+    {
+        m_used -= m_pendingRanges.front().bytes;
+        m_pendingRanges.pop_front();
+    }
+
+    // Restart at the beginning once idle to keep large requests from wrapping
+    if (m_used == 0)
+    {
+        m_head = 0;
+    }
+
+    auto it = m_spills.begin();
+    while (it != m_spills.end())
+    {
+        if (isRetired(it->uploadValue, it->frameNumber, completedUploadValue, completedFrameNumber))
+        {
+            vkDestroyBuffer(m_device, it->buffer, nullptr);
+            m_allocator->free(it->allocation);
+            it = m_spills.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void StagingRing::setSharingMode(VkBufferCreateInfo& bufferInfo) const
+{
+    if (m_queueFamilies.size() > 1)
+    {
+        bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufferInfo.queueFamilyIndexCount = static_cast<uint32_t>(m_queueFamilies.size());
+        bufferInfo.pQueueFamilyIndices = m_queueFamilies.data();
+    }
+    else
+    {
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    }
+}
+
+} // namespace VK
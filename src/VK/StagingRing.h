@@ -0,0 +1,90 @@
+#pragma once
+
+#include "MemoryAllocator.h"
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <deque>
+#include <cstdint>
+
+namespace VK
+{
+    // Sub-allocated upload space, valid until the upload or frame it is used by has completed
+    struct StagingAllocation
+    {
+        VkBuffer buffer;
+        VkDeviceSize offset;
+        void* mapped;
+    };
+
+    // Persistently mapped ring buffer shared by all uploads
+    // Space is handed out in submission order and retired once the upload timeline
+    // value it was submitted with has been reached, or for copies recorded in a frame's
+    // command buffer once that frame has completed. Requests that don't fit spill
+    // to temporary buffers instead of stalling.
+    class StagingRing
+    {
+    public:
+        // Copies read the ring on every queue family given, more than one shares it concurrently
+        StagingRing(VkDevice device, MemoryAllocator* allocator, const std::vector<uint32_t>& queueFamilies,
+                    VkDeviceSize capacity = DEFAULT_CAPACITY);
+        ~StagingRing();
+
+        StagingRing(const StagingRing&) = delete;
+        StagingRing& operator=(const StagingRing&) = delete;
+
+        // Alignment does not need to be a power of two (e.g. RGB texel copies)
+        StagingAllocation allocate(VkDeviceSize size, VkDeviceSize alignment);
+
+        // For a copy recorded in the command buffer of frameNumber, retired with the frame
+        StagingAllocation allocateForFrame(VkDeviceSize size, VkDeviceSize alignment, uint64_t frameNumber);
+
+        // Tag everything allocated since the previous call with the upload that uses it
+        void markSubmitted(uint64_t uploadValue);
+
+        // Retire space of uploads and frames that have completed
+        void reclaim(uint64_t completedUploadValue, uint64_t completedFrameNumber);
+
+        VkDeviceSize getCapacity() const { return m_capacity; }
+
+        // 32MB: above MemoryAllocator's pooling threshold, so the ring gets its own allocation
+        static constexpr VkDeviceSize DEFAULT_CAPACITY = 32 * 1024 * 1024;
+
+    private:
+        // Either frameNumber is set, or uploadValue once the upload is submitted
+        struct PendingRange
+        {
+            VkDeviceSize bytes; // Including alignment and wrap padding
+            uint64_t uploadValue;
+            uint64_t frameNumber;
+        };
+
+        struct SpillBuffer
+        {
+            VkBuffer buffer;
+            Allocation allocation;
+            uint64_t uploadValue; // 0 until submitted
+            uint64_t frameNumber;
+        };
+
+        StagingAllocation allocateRange(VkDeviceSize size, VkDeviceSize alignment, uint64_t frameNumber);
+        StagingAllocation allocateSpill(VkDeviceSize size, uint64_t frameNumber);
+        void setSharingMode(VkBufferCreateInfo& bufferInfo) const;
+
+        VkDevice m_device;
+        MemoryAllocator* m_allocator;
+        std::vector<uint32_t> m_queueFamilies;
+
+        VkBuffer m_buffer;
+        Allocation m_allocation;
+        uint8_t* m_mapped;
+
+        VkDeviceSize m_capacity;
+        VkDeviceSize m_head;             // Next free byte
+        VkDeviceSize m_used;             // Bytes between the oldest in-flight range and m_head
+        VkDeviceSize m_unsubmittedBytes; // Allocated for uploads since the last pending range
+
+        std::deque<PendingRange> m_pendingRanges;
+        std::vector<SpillBuffer> m_spills;
+    };
+
+} // namespace VK
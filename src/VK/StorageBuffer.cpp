@@ -0,0 +1,100 @@
+#include "StorageBuffer.h"
+#include "Renderer.h"
+#include "../Logger.h"
+#include <vector>
+#include <stdexcept>
+
+namespace VK
+{
+
+StorageBuffer::StorageBuffer(Renderer* renderer)
+    : m_renderer(renderer)
+    , m_device(renderer->getDevice())
+    , m_buffer(VK_NULL_HANDLE)
+    , m_allocation{}
+    , m_size(0)
+{
+}
+
+StorageBuffer::~StorageBuffer()
+{
+    cleanup();
+}
+
+void StorageBuffer::setData(const void* data, size_t size, ::BufferUsage usage)
+{
+    // Frames in flight may still read the old buffer, the new contents get a fresh one
+    cleanup();
+
+    if (size == 0)
+    {
+        return;
+    }
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                       VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    m_renderer->applyUploadSharingMode(bufferInfo);
+
+    if (vkCreateBuffer(m_device, &bufferInfo, nullptr, &m_buffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create Vulkan storage buffer");
+    }
+
+    m_allocation = m_renderer->getMemoryAllocator()->allocateBufferMemory(m_buffer, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    vkBindBufferMemory(m_device, m_buffer, m_allocation.memory, m_allocation.offset);
+    m_size = size;
+
+    std::vector<uint8_t> zeroes;
+    if (!data)
+    {
+        zeroes.resize(size, 0);
+        data = zeroes.data();
+    }
+    m_renderer->uploadToBuffer(m_buffer, 0, data, size);
+
+    LOG_DEBUG("[Vulkan] StorageBuffer created with {} bytes", size);
+}
+
+void StorageBuffer::updateData(const void* data, size_t size, size_t offset)
+{
+    if (m_buffer == VK_NULL_HANDLE)
+    {
+        LOG_ERROR("[Vulkan] Cannot update storage buffer: buffer not initialized");
+        return;
+    }
+
+    if (offset + size > m_size)
+    {
+        LOG_ERROR("[Vulkan] Cannot update storage buffer: data exceeds buffer size");
+        return;
+    }
+
+    // Ordered with the dispatches and draws of the frame, the GPU may also write the buffer
+    m_renderer->updateBuffer(m_buffer, offset, data, size,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                             VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                             VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+                             VK_ACCESS_INDIRECT_COMMAND_READ_BIT);
+}
+
+void StorageBuffer::cleanup()
+{
+    if (m_buffer == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    // Destroyed once the frames that may still use the buffer have completed
+    m_renderer->cancelPendingUploads(m_buffer);
+    m_renderer->deferDeleteBuffer(m_buffer);
+    m_renderer->deferFreeAllocation(m_allocation);
+
+    m_buffer = VK_NULL_HANDLE;
+    m_allocation = Allocation{};
+    m_size = 0;
+}
+
+} // namespace VK
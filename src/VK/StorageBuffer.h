@@ -0,0 +1,39 @@
+#pragma once
+
+#include "../RenderAPI/IStorageBuffer.h"
+#include "MemoryAllocator.h"
+#include <vulkan/vulkan.h>
+
+namespace VK
+{
+    class Renderer;
+
+    // Device-local storage buffer, also usable as indirect dispatch arguments
+    // Contents are written through the transfer queue like static vertex data, the
+    // usage hint is ignored since compute programs write the buffer on the GPU anyway.
+    class StorageBuffer : public IStorageBuffer
+    {
+    public:
+        explicit StorageBuffer(Renderer* renderer);
+        ~StorageBuffer() override;
+
+        StorageBuffer(const StorageBuffer&) = delete;
+        StorageBuffer& operator=(const StorageBuffer&) = delete;
+
+        void setData(const void* data, size_t size, ::BufferUsage usage) override;
+        void updateData(const void* data, size_t size, size_t offset = 0) override;
+
+        size_t getSize() const override { return static_cast<size_t>(m_size); }
+
+        VkBuffer getBuffer() const { return m_buffer; }
+
+    private:
+        void cleanup();
+
+        Renderer* m_renderer;
+        VkDevice m_device;
+        VkBuffer m_buffer;
+        Allocation m_allocation;
+        VkDeviceSize m_size;
+    };
+}
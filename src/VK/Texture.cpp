@@ -2,6 +2,7 @@
 #include "Renderer.h"
 #include "../Logger.h"
 #include <stdexcept>
+#include <numeric>
 
 namespace VK
 {
@@ -15,6 +16,7 @@ Texture::Texture(VkDevice device, VkPhysicalDevice physicalDevice, Renderer* ren
     , m_imageView(VK_NULL_HANDLE)
     , m_sampler(VK_NULL_HANDLE)
     , m_descriptorSet(VK_NULL_HANDLE)
+    , m_bindlessIndex(Renderer::INVALID_BINDLESS_INDEX)
     , m_width(0)
     , m_height(0)
     , m_format(TextureFormat::RGBA)
@@ -40,6 +42,8 @@ Texture::Texture(Texture&& other) noexcept
     , m_imageMemory(other.m_imageMemory)
     , m_imageView(other.m_imageView)
     , m_sampler(other.m_sampler)
+    , m_descriptorSet(other.m_descriptorSet)
+    , m_bindlessIndex(other.m_bindlessIndex)
     , m_width(other.m_width)
     , m_height(other.m_height)
     , m_format(other.m_format)
@@ -54,6 +58,8 @@ Texture::Texture(Texture&& other) noexcept
     other.m_imageMemory = VK_NULL_HANDLE;
     other.m_imageView = VK_NULL_HANDLE;
     other.m_sampler = VK_NULL_HANDLE;
+    other.m_descriptorSet = VK_NULL_HANDLE;
+    other.m_bindlessIndex = Renderer::INVALID_BINDLESS_INDEX;
 }
 
 Texture& Texture::operator=(Texture&& other) noexcept
@@ -69,6 +75,8 @@ Texture& Texture::operator=(Texture&& other) noexcept
         m_imageMemory = other.m_imageMemory;
         m_imageView = other.m_imageView;
         m_sampler = other.m_sampler;
+        m_descriptorSet = other.m_descriptorSet;
+        m_bindlessIndex = other.m_bindlessIndex;
         m_width = other.m_width;
         m_height = other.m_height;
         m_format = other.m_format;
@@ -83,6 +91,8 @@ Texture& Texture::operator=(Texture&& other) noexcept
         other.m_imageMemory = VK_NULL_HANDLE;
         other.m_imageView = VK_NULL_HANDLE;
         other.m_sampler = VK_NULL_HANDLE;
+        other.m_descriptorSet = VK_NULL_HANDLE;
+        other.m_bindlessIndex = Renderer::INVALID_BINDLESS_INDEX;
     }
     return *this;
 }
@@ -111,6 +121,12 @@ void Texture::setData(const void* data, uint32_t width, uint32_t height, Texture
         return;
     }
 
+    if (!m_renderer)
+    {
+        LOG_ERROR("[Vulkan] Cannot set texture data - no renderer");
+        return;
+    }
+
     // Clean up existing resources if any
     cleanup();
 
@@ -131,58 +147,16 @@ void Texture::setData(const void* data, uint32_t width, uint32_t height, Texture
     }
     VkDeviceSize imageSize = width * height * bytesPerPixel;
 
-    // Create staging buffer
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-
-    VkBufferCreateInfo bufferInfo{};
-    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    bufferInfo.size = imageSize;
-    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-    if (vkCreateBuffer(m_device, &bufferInfo, nullptr, &stagingBuffer) != VK_SUCCESS)
-    {
-        throw std::runtime_error("Failed to create staging buffer for texture");
-    }
-
-    VkMemoryRequirements memRequirements;
-    vkGetBufferMemoryRequirements(m_device, stagingBuffer, &memRequirements);
-
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-    if (vkAllocateMemory(m_device, &allocInfo, nullptr, &stagingBufferMemory) != VK_SUCCESS)
-    {
-        vkDestroyBuffer(m_device, stagingBuffer, nullptr);
-        throw std::runtime_error("Failed to allocate staging buffer memory");
-    }
-
-    vkBindBufferMemory(m_device, stagingBuffer, stagingBufferMemory, 0);
-
-    // Copy data to staging buffer
-    void* mappedData;
-    vkMapMemory(m_device, stagingBufferMemory, 0, imageSize, 0, &mappedData);
-    memcpy(mappedData, data, static_cast<size_t>(imageSize));
-    vkUnmapMemory(m_device, stagingBufferMemory);
-
     // Create image
     createImage(width, height, m_vkFormat,
                 VK_IMAGE_TILING_OPTIMAL,
                 VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-    // Transition image layout and copy buffer
-    transitionImageLayout(VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-    copyBufferToImage(stagingBuffer, width, height);
-    transitionImageLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-
-    // Clean up staging resources
-    vkDestroyBuffer(m_device, stagingBuffer, nullptr);
-    vkFreeMemory(m_device, stagingBufferMemory, nullptr);
+    // Upload through the staging ring on the transfer queue, it completes asynchronously
+    // Buffer offsets of image copies must be a multiple of both the texel size and 4
+    m_renderer->uploadToImage(m_image, width, height, data, imageSize,
+                              std::lcm<VkDeviceSize>(bytesPerPixel, 4));
 
     // Create image view and sampler
     createImageView(m_vkFormat);
@@ -191,17 +165,9 @@ void Texture::setData(const void* data, uint32_t width, uint32_t height, Texture
     // Create descriptor set
     if (m_renderer)
     {
-        VkDescriptorSetAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        allocInfo.descriptorPool = m_renderer->getDescriptorPool();
-        allocInfo.descriptorSetCount = 1;
-        VkDescriptorSetLayout layout = m_renderer->getDescriptorSetLayout();
-        allocInfo.pSetLayouts = &layout;
-
-        if (vkAllocateDescriptorSets(m_device, &allocInfo, &m_descriptorSet) != VK_SUCCESS)
-        {
-            throw std::runtime_error("Failed to allocate descriptor set");
-        }
+        // Long-lived, recycled by the allocator once the texture is destroyed
+        m_descriptorSet = m_renderer->getDescriptorAllocator()->allocateStatic(
+            m_renderer->getDescriptorSetLayout());
 
         // Update descriptor set
         VkDescriptorImageInfo imageInfo{};
@@ -220,6 +186,11 @@ void Texture::setData(const void* data, uint32_t width, uint32_t height, Texture
 
         vkUpdateDescriptorSets(m_device, 1, &descriptorWrite, 0, nullptr);
         LOG_DEBUG("[Vulkan] Descriptor set created and updated");
+
+        if (m_renderer->isBindlessSupported())
+        {
+            m_bindlessIndex = m_renderer->registerBindlessTexture(m_imageView, m_sampler);
+        }
     }
 
     LOG_INFO("[Vulkan] Texture data set ({}x{}, format: {})", width, height, static_cast<int>(format));
@@ -249,25 +220,7 @@ void Texture::setFilter(TextureFilter minFilter, TextureFilter magFilter)
     }
     createSampler();
 
-    // Update descriptor set if it exists
-    if (m_descriptorSet != VK_NULL_HANDLE && m_renderer)
-    {
-        VkDescriptorImageInfo imageInfo{};
-        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        imageInfo.imageView = m_imageView;
-        imageInfo.sampler = m_sampler;
-
-        VkWriteDescriptorSet descriptorWrite{};
-        descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrite.dstSet = m_descriptorSet;
-        descriptorWrite.dstBinding = 0;
-        descriptorWrite.dstArrayElement = 0;
-        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        descriptorWrite.descriptorCount = 1;
-        descriptorWrite.pImageInfo = &imageInfo;
-
-        vkUpdateDescriptorSets(m_device, 1, &descriptorWrite, 0, nullptr);
-    }
+    updateDescriptors();
 }
 
 void Texture::setWrap(TextureWrap wrapS, TextureWrap wrapT)
@@ -287,8 +240,18 @@ void Texture::setWrap(TextureWrap wrapS, TextureWrap wrapT)
     }
     createSampler();
 
+    updateDescriptors();
+}
+
+void Texture::updateDescriptors()
+{
+    if (!m_renderer)
+    {
+        return;
+    }
+
     // Update descriptor set if it exists
-    if (m_descriptorSet != VK_NULL_HANDLE && m_renderer)
+    if (m_descriptorSet != VK_NULL_HANDLE)
     {
         VkDescriptorImageInfo imageInfo{};
         imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
@@ -306,6 +269,14 @@ void Texture::setWrap(TextureWrap wrapS, TextureWrap wrapT)
 
         vkUpdateDescriptorSets(m_device, 1, &descriptorWrite, 0, nullptr);
     }
+
+    // In-flight frames may still sample the old slot, move to a fresh one
+    // and let the old slot retire through deferred deletion
+    if (m_bindlessIndex != Renderer::INVALID_BINDLESS_INDEX)
+    {
+        m_renderer->releaseBindlessTexture(m_bindlessIndex);
+        m_bindlessIndex = m_renderer->registerBindlessTexture(m_imageView, m_sampler);
+    }
 }
 
 void Texture::generateMipmaps()
@@ -399,99 +370,6 @@ void Texture::createSampler()
     }
 }
 
-void Texture::transitionImageLayout(VkImageLayout oldLayout, VkImageLayout newLayout)
-{
-    if (!m_renderer)
-    {
-        LOG_ERROR("[Vulkan] Cannot transition image layout - no renderer");
-        return;
-    }
-
-    VkCommandBuffer commandBuffer = m_renderer->beginSingleTimeCommands();
-
-    VkImageMemoryBarrier barrier{};
-    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.oldLayout = oldLayout;
-    barrier.newLayout = newLayout;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.image = m_image;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-
-    VkPipelineStageFlags sourceStage;
-    VkPipelineStageFlags destinationStage;
-
-    if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
-    {
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-    }
-    else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
-    {
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-        destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-    }
-    else
-    {
-        LOG_ERROR("[Vulkan] Unsupported layout transition");
-        return;
-    }
-
-    vkCmdPipelineBarrier(
-        commandBuffer,
-        sourceStage, destinationStage,
-        0,
-        0, nullptr,
-        0, nullptr,
-        1, &barrier
-    );
-
-    m_renderer->endSingleTimeCommands(commandBuffer);
-    LOG_DEBUG("[Vulkan] Image layout transitioned from {} to {}", static_cast<int>(oldLayout), static_cast<int>(newLayout));
-}
-
-void Texture::copyBufferToImage(VkBuffer buffer, uint32_t width, uint32_t height)
-{
-    if (!m_renderer)
-    {
-        LOG_ERROR("[Vulkan] Cannot copy buffer to image - no renderer");
-        return;
-    }
-
-    VkCommandBuffer commandBuffer = m_renderer->beginSingleTimeCommands();
-
-    VkBufferImageCopy region{};
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;
-    region.bufferImageHeight = 0;
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = 1;
-    region.imageOffset = {0, 0, 0};
-    region.imageExtent = {width, height, 1};
-
-    vkCmdCopyBufferToImage(
-        commandBuffer,
-        buffer,
-        m_image,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        1,
-        &region
-    );
-
-    m_renderer->endSingleTimeCommands(commandBuffer);
-    LOG_DEBUG("[Vulkan] Buffer copied to image ({}x{})", width, height);
-}
-
 uint32_t Texture::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties)
 {
     VkPhysicalDeviceMemoryProperties memProperties;
@@ -547,35 +425,40 @@ void Texture::cleanup()
 {
     if (m_device != VK_NULL_HANDLE)
     {
-        // Wait for device to be idle before destroying resources
-        // This ensures no commands are still using this texture
-        vkDeviceWaitIdle(m_device);
-
-        // Note: Descriptor sets are owned by the descriptor pool and will be
-        // freed when the pool is destroyed. We just need to ensure the device
-        // is idle before destroying the resources they reference.
-        m_descriptorSet = VK_NULL_HANDLE;
-
-        if (m_sampler != VK_NULL_HANDLE)
-        {
-            vkDestroySampler(m_device, m_sampler, nullptr);
-            m_sampler = VK_NULL_HANDLE;
-        }
-        if (m_imageView != VK_NULL_HANDLE)
+        // Descriptor sets are owned by the allocator's pools, the set is handed
+        // back for reuse once the frames that may reference it have completed
+        if (m_descriptorSet != VK_NULL_HANDLE && m_renderer && m_renderer->getDescriptorAllocator())
         {
-            vkDestroyImageView(m_device, m_imageView, nullptr);
-            m_imageView = VK_NULL_HANDLE;
+            m_renderer->getDescriptorAllocator()->freeStatic(
+                m_renderer->getDescriptorSetLayout(), m_descriptorSet, m_renderer->getFrameNumber() + 1);
         }
-        if (m_image != VK_NULL_HANDLE)
+        m_descriptorSet = VK_NULL_HANDLE;
+
+        if (m_bindlessIndex != Renderer::INVALID_BINDLESS_INDEX && m_renderer)
         {
-            vkDestroyImage(m_device, m_image, nullptr);
-            m_image = VK_NULL_HANDLE;
+            m_renderer->releaseBindlessTexture(m_bindlessIndex);
         }
-        if (m_imageMemory != VK_NULL_HANDLE)
+        m_bindlessIndex = Renderer::INVALID_BINDLESS_INDEX;
+
+        if (m_renderer)
         {
-            vkFreeMemory(m_device, m_imageMemory, nullptr);
-            m_imageMemory = VK_NULL_HANDLE;
+            // Drop a copy still queued in an open upload batch
+            if (m_image != VK_NULL_HANDLE)
+            {
+                m_renderer->cancelPendingUploads(m_image);
+            }
+
+            // Destroyed once the frames that may still sample the texture have completed
+            m_renderer->deferDeleteSampler(m_sampler);
+            m_renderer->deferDeleteImageView(m_imageView);
+            m_renderer->deferDeleteImage(m_image);
+            m_renderer->deferDeleteDeviceMemory(m_imageMemory);
         }
+
+        m_sampler = VK_NULL_HANDLE;
+        m_imageView = VK_NULL_HANDLE;
+        m_image = VK_NULL_HANDLE;
+        m_imageMemory = VK_NULL_HANDLE;
     }
     LOG_DEBUG("[Vulkan] Texture cleaned up");
 }
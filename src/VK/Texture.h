@@ -10,7 +10,8 @@ namespace VK
     class Texture : public ITexture
     {
     public:
-        Texture(VkDevice device, VkPhysicalDevice physicalDevice, Renderer* renderer = nullptr);
+        // Required, destruction is deferred on the renderer's frame timeline
+        Texture(VkDevice device, VkPhysicalDevice physicalDevice, Renderer* renderer);
         ~Texture() override;
 
         Texture(const Texture&) = delete;
@@ -39,14 +40,16 @@ namespace VK
         VkSampler getSampler() const { return m_sampler; }
         VkDescriptorSet getDescriptorSet() const { return m_descriptorSet; }
 
+        // Slot in the renderer's bindless texture array, INVALID_BINDLESS_INDEX without one
+        uint32_t getBindlessIndex() const { return m_bindlessIndex; }
+
     private:
         void createImage(uint32_t width, uint32_t height, VkFormat format,
                         VkImageTiling tiling, VkImageUsageFlags usage,
                         VkMemoryPropertyFlags properties);
         void createImageView(VkFormat format);
         void createSampler();
-        void transitionImageLayout(VkImageLayout oldLayout, VkImageLayout newLayout);
-        void copyBufferToImage(VkBuffer buffer, uint32_t width, uint32_t height);
+        void updateDescriptors();
 
         uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
         VkFormat convertTextureFormat(TextureFormat format) const;
@@ -64,6 +67,7 @@ namespace VK
         VkImageView m_imageView;
         VkSampler m_sampler;
         VkDescriptorSet m_descriptorSet;
+        uint32_t m_bindlessIndex;
 
         uint32_t m_width;
         uint32_t m_height;
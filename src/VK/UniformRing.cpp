@@ -0,0 +1,137 @@
+#include "UniformRing.h"
+#include "DescriptorAllocator.h"
+#include "../Logger.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace VK
+{
+
+UniformRing::UniformRing(VkDevice device, MemoryAllocator* allocator, DescriptorAllocator* descriptorAllocator,
+                         VkDescriptorSetLayout setLayout, VkDeviceSize minOffsetAlignment, uint32_t frameSlotCount)
+    : m_device(device)
+    , m_allocator(allocator)
+    , m_descriptorAllocator(descriptorAllocator)
+    , m_setLayout(setLayout)
+    , m_alignment(std::max<VkDeviceSize>(minOffsetAlignment, 1))
+    , m_frames(frameSlotCount)
+    , m_currentSlot(0)
+{
+}
+
+UniformRing::~UniformRing()
+{
+    // The owner guarantees that no frame is still in flight
+    // Descriptor sets are released with the descriptor allocator's pools
+    for (FrameChunks& frame : m_frames)
+    {
+        for (Chunk& chunk : frame.chunks)
+        {
+            vkUnmapMemory(m_device, chunk.allocation.memory);
+            vkDestroyBuffer(m_device, chunk.buffer, nullptr);
+            m_allocator->free(chunk.allocation);
+        }
+        frame.chunks.clear();
+    }
+}
+
+void UniformRing::beginFrame(uint32_t frameSlot)
+{
+    m_currentSlot = frameSlot;
+
+    FrameChunks& frame = m_frames[frameSlot];
+    frame.current = 0;
+    frame.head = 0;
+}
+
+UniformAllocation UniformRing::allocate(uint32_t size)
+{
+    FrameChunks& frame = m_frames[m_currentSlot];
+
+    VkDeviceSize offset = ((frame.head + m_alignment - 1) / m_alignment) * m_alignment;
+
+    // The descriptor range is MAX_BLOCK_SIZE, so every block must fit inside its chunk
+    // with a full range behind it
+    while (frame.current >= frame.chunks.size() ||
+           offset + MAX_BLOCK_SIZE > frame.chunks[frame.current].size)
+    {
+        if (frame.current < frame.chunks.size())
+        {
+            frame.current++;
+            frame.head = 0;
+            offset = 0;
+            continue;
+        }
+
+        VkDeviceSize chunkSize = frame.chunks.empty()
+            ? INITIAL_CHUNK_SIZE
+            : std::min(frame.chunks.back().size * 2, MAX_CHUNK_SIZE);
+        frame.chunks.push_back(createChunk(chunkSize));
+        offset = 0;
+
+        LOG_DEBUG("[Vulkan] Uniform ring chunk of {} KB added to frame slot {}", chunkSize / 1024, m_currentSlot);
+    }
+
+    Chunk& chunk = frame.chunks[frame.current];
+    frame.head = offset + size;
+
+    UniformAllocation allocation;
+    allocation.set = chunk.set;
+    allocation.offset = static_cast<uint32_t>(offset);
+    allocation.mapped = chunk.mapped + offset;
+    return allocation;
+}
+
+UniformRing::Chunk UniformRing::createChunk(VkDeviceSize size)
+{
+    Chunk chunk{};
+    chunk.size = size;
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateBuffer(m_device, &bufferInfo, nullptr, &chunk.buffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create uniform ring buffer");
+    }
+
+    // Dedicated, pooled memory can't be mapped by more than one owner
+    chunk.allocation = m_allocator->allocateBufferMemory(chunk.buffer,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, true);
+    vkBindBufferMemory(m_device, chunk.buffer, chunk.allocation.memory, chunk.allocation.offset);
+
+    // Mapped once for the lifetime of the chunk
+    void* mapped = nullptr;
+    if (vkMapMemory(m_device, chunk.allocation.memory, chunk.allocation.offset, size, 0, &mapped) != VK_SUCCESS)
+    {
+        vkDestroyBuffer(m_device, chunk.buffer, nullptr);
+        m_allocator->free(chunk.allocation);
+        throw std::runtime_error("Failed to map uniform ring buffer");
+    }
+    chunk.mapped = static_cast<uint8_t*>(mapped);
+
+    chunk.set = m_descriptorAllocator->allocateStatic(m_setLayout);
+
+    VkDescriptorBufferInfo bufferDescriptor{};
+    bufferDescriptor.buffer = chunk.buffer;
+    bufferDescriptor.offset = 0;
+    bufferDescriptor.range = MAX_BLOCK_SIZE;
+
+    VkWriteDescriptorSet descriptorWrite{};
+    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrite.dstSet = chunk.set;
+    descriptorWrite.dstBinding = 0;
+    descriptorWrite.dstArrayElement = 0;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pBufferInfo = &bufferDescriptor;
+
+    vkUpdateDescriptorSets(m_device, 1, &descriptorWrite, 0, nullptr);
+
+    return chunk;
+}
+
+} // namespace VK
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "MemoryAllocator.h"
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <cstdint>
+
+namespace VK
+{
+    class DescriptorAllocator;
+
+    // Uniform block space for one draw, valid until the frame it was allocated in completes
+    struct UniformAllocation
+    {
+        VkDescriptorSet set;  // Bound with offset as its dynamic offset
+        uint32_t offset;
+        void* mapped;
+    };
+
+    // Persistently mapped uniform buffers bump-allocated per frame slot
+    // Every slot owns a list of chunks, each with a dynamic uniform buffer descriptor
+    // set covering MAX_BLOCK_SIZE bytes. When a chunk fills up the next one is used,
+    // created on first need, so once the chunks cover a frame's uniform data
+    // nothing is allocated anymore. The chunks of a slot are rewound in beginFrame().
+    class UniformRing
+    {
+    public:
+        UniformRing(VkDevice device, MemoryAllocator* allocator, DescriptorAllocator* descriptorAllocator,
+                    VkDescriptorSetLayout setLayout, VkDeviceSize minOffsetAlignment, uint32_t frameSlotCount);
+        ~UniformRing();
+
+        UniformRing(const UniformRing&) = delete;
+        UniformRing& operator=(const UniformRing&) = delete;
+
+        // Called once the frame that last used the slot has completed on the GPU
+        void beginFrame(uint32_t frameSlot);
+
+        // size must not exceed MAX_BLOCK_SIZE
+        UniformAllocation allocate(uint32_t size);
+
+        // Range of the descriptors, 16KB is the minimum maxUniformBufferRange
+        static constexpr uint32_t MAX_BLOCK_SIZE = 4096;
+
+    private:
+        struct Chunk
+        {
+            VkBuffer buffer;
+            Allocation allocation;
+            uint8_t* mapped;
+            VkDeviceSize size;
+            VkDescriptorSet set;
+        };
+
+        struct FrameChunks
+        {
+            std::vector<Chunk> chunks;
+            uint32_t current = 0;
+            VkDeviceSize head = 0;
+        };
+
+        Chunk createChunk(VkDeviceSize size);
+
+        VkDevice m_device;
+        MemoryAllocator* m_allocator;
+        DescriptorAllocator* m_descriptorAllocator;
+        VkDescriptorSetLayout m_setLayout;
+        VkDeviceSize m_alignment;
+        std::vector<FrameChunks> m_frames;  // One chunk list per frame slot
+        uint32_t m_currentSlot;
+
+        // Chunks double in size up to MAX_CHUNK_SIZE
+        static constexpr VkDeviceSize INITIAL_CHUNK_SIZE = 256 * 1024;
+        static constexpr VkDeviceSize MAX_CHUNK_SIZE = 8 * 1024 * 1024;
+    };
+
+} // namespace VK
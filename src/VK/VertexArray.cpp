@@ -3,6 +3,7 @@
 #include "IndexBuffer.h"
 #include "Renderer.h"
 #include "../Logger.h"
+#include <cstdint>
 
 namespace VK
 {
@@ -10,33 +11,37 @@ namespace VK
 VertexArray::VertexArray(Renderer* renderer)
     : m_renderer(renderer)
     , m_vertexBuffer(nullptr)
+    , m_instanceBuffer(nullptr)
+    , m_arrayBuffer(nullptr)
     , m_indexBuffer(nullptr)
-    , m_stride(0)
-    , m_bindingInitialized(false)
 {
-    m_binding = {};
-    m_binding.binding = 0;
-    m_binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+    m_vertexInput.computeHash();
 }
 
 VertexArray::~VertexArray()
 {
+    // Pipeline keys are built from the bound array, don't leave it dangling
+    if (m_renderer && m_renderer->getActiveVertexArray() == this)
+    {
+        m_renderer->setActiveVertexArray(nullptr);
+    }
 }
 
 VertexArray::VertexArray(VertexArray&& other) noexcept
     : m_renderer(other.m_renderer)
-    , m_attributes(std::move(other.m_attributes))
-    , m_binding(other.m_binding)
+    , m_vertexInput(other.m_vertexInput)
     , m_vertexBuffer(other.m_vertexBuffer)
+    , m_instanceBuffer(other.m_instanceBuffer)
+    , m_arrayBuffer(other.m_arrayBuffer)
     , m_indexBuffer(other.m_indexBuffer)
-    , m_stride(other.m_stride)
-    , m_bindingInitialized(other.m_bindingInitialized)
 {
     other.m_renderer = nullptr;
+    other.m_vertexInput = VertexInputLayout{};
+    other.m_vertexInput.computeHash();
     other.m_vertexBuffer = nullptr;
+    other.m_instanceBuffer = nullptr;
+    other.m_arrayBuffer = nullptr;
     other.m_indexBuffer = nullptr;
-    other.m_stride = 0;
-    other.m_bindingInitialized = false;
 }
 
 VertexArray& VertexArray::operator=(VertexArray&& other) noexcept
@@ -44,18 +49,19 @@ VertexArray& VertexArray::operator=(VertexArray&& other) noexcept
     if (this != &other)
     {
         m_renderer = other.m_renderer;
-        m_attributes = std::move(other.m_attributes);
-        m_binding = other.m_binding;
+        m_vertexInput = other.m_vertexInput;
         m_vertexBuffer = other.m_vertexBuffer;
+        m_instanceBuffer = other.m_instanceBuffer;
+        m_arrayBuffer = other.m_arrayBuffer;
         m_indexBuffer = other.m_indexBuffer;
-        m_stride = other.m_stride;
-        m_bindingInitialized = other.m_bindingInitialized;
 
         other.m_renderer = nullptr;
+        other.m_vertexInput = VertexInputLayout{};
+        other.m_vertexInput.computeHash();
         other.m_vertexBuffer = nullptr;
+        other.m_instanceBuffer = nullptr;
+        other.m_arrayBuffer = nullptr;
         other.m_indexBuffer = nullptr;
-        other.m_stride = 0;
-        other.m_bindingInitialized = false;
     }
     return *this;
 }
@@ -72,45 +78,80 @@ void VertexArray::bind()
 
 void VertexArray::unbind()
 {
-    // In Vulkan, there's no explicit unbind
-    // This is a no-op for compatibility with the interface
+    // No command buffer state to reset, but buffers filled after this must not
+    // be associated with the array anymore
+    if (m_renderer && m_renderer->getActiveVertexArray() == this)
+    {
+        m_renderer->setActiveVertexArray(nullptr);
+    }
 }
 
 void VertexArray::addAttribute(const ::VertexAttribute& attribute)
 {
+    // Redefining a location replaces its attribute, like glVertexAttribPointer
+    uint32_t slot = 0;
+    while (slot < m_vertexInput.attributeCount && m_vertexInput.attributes[slot].location != attribute.index)
+    {
+        slot++;
+    }
+
+    if (slot >= VertexInputLayout::MAX_ATTRIBUTES)
+    {
+        LOG_WARNING("[Vulkan] VertexArray: Attribute {} ignored, at most {} attributes are supported",
+                    attribute.index, VertexInputLayout::MAX_ATTRIBUTES);
+        return;
+    }
+
+    // Without VK_EXT_vertex_attribute_divisor instance attributes advance every instance,
+    // see VertexAttribute::divisor
+    if (attribute.divisor > 1)
+    {
+        LOG_WARNING("[Vulkan] VertexArray: Attribute {} divisor {} is unsupported, it advances every instance",
+                    attribute.index, attribute.divisor);
+    }
+    bool perInstance = attribute.divisor > 0;
+
     VkVertexInputAttributeDescription vkAttribute{};
-    vkAttribute.binding = 0;
+    vkAttribute.binding = perInstance ? VertexInputLayout::INSTANCE_BINDING : VertexInputLayout::VERTEX_BINDING;
     vkAttribute.location = attribute.index;
-    vkAttribute.format = getVulkanFormat(attribute.type, attribute.size);
-    vkAttribute.offset = reinterpret_cast<uint32_t>(attribute.offset);
+    vkAttribute.format = getVulkanFormat(attribute.type, attribute.size, attribute.normalized);
+    // The offset is passed as a pointer, OpenGL style
+    vkAttribute.offset = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(attribute.offset));
 
-    m_attributes.push_back(vkAttribute);
+    m_vertexInput.attributes[slot] = vkAttribute;
+    if (slot == m_vertexInput.attributeCount)
+    {
+        m_vertexInput.attributeCount++;
+    }
 
-    // Update stride if this is the first attribute or if stride is larger
-    if (!m_bindingInitialized)
+    if (perInstance)
+    {
+        // Per-instance attributes share one binding, read from the buffer bound when
+        // they're added. The last one added sets its buffer and stride.
+        m_instanceBuffer = m_arrayBuffer;
+        m_vertexInput.instanceStride = static_cast<uint32_t>(attribute.stride);
+    }
+    else if (m_vertexInput.stride == 0)
     {
-        m_stride = attribute.stride;
-        m_binding.stride = m_stride;
-        m_bindingInitialized = true;
+        // Per-vertex attributes share one interleaved binding, the first one sets its stride
+        m_vertexInput.stride = static_cast<uint32_t>(attribute.stride);
     }
 
+    m_vertexInput.computeHash();
+
     LOG_DEBUG("[Vulkan] VertexArray: Added attribute {} at location {} with offset {}",
               attribute.index, vkAttribute.location, vkAttribute.offset);
 }
 
-const std::vector<VkVertexInputAttributeDescription>& VertexArray::getAttributeDescriptions() const
-{
-    return m_attributes;
-}
-
-const VkVertexInputBindingDescription& VertexArray::getBindingDescription() const
-{
-    return m_binding;
-}
-
 void VertexArray::setVertexBuffer(VertexBuffer* buffer)
 {
-    m_vertexBuffer = buffer;
+    m_arrayBuffer = buffer;
+
+    // Refilling the instance buffer while the array is bound keeps it per-instance
+    if (buffer != m_instanceBuffer)
+    {
+        m_vertexBuffer = buffer;
+    }
 }
 
 void VertexArray::setIndexBuffer(IndexBuffer* buffer)
@@ -118,8 +159,9 @@ void VertexArray::setIndexBuffer(IndexBuffer* buffer)
     m_indexBuffer = buffer;
 }
 
-VkFormat VertexArray::getVulkanFormat(DataType type, int size) const
+VkFormat VertexArray::getVulkanFormat(DataType type, int size, bool normalized) const
 {
+    // Same component counts as glVertexAttribPointer, normalized integers read as [0,1] / [-1,1]
     switch (type)
     {
         case DataType::Float:
@@ -131,6 +173,15 @@ VkFormat VertexArray::getVulkanFormat(DataType type, int size) const
                 case 4: return VK_FORMAT_R32G32B32A32_SFLOAT;
                 default: return VK_FORMAT_R32_SFLOAT;
             }
+        case DataType::HalfFloat:
+            switch (size)
+            {
+                case 1: return VK_FORMAT_R16_SFLOAT;
+                case 2: return VK_FORMAT_R16G16_SFLOAT;
+                case 3: return VK_FORMAT_R16G16B16_SFLOAT;
+                case 4: return VK_FORMAT_R16G16B16A16_SFLOAT;
+                default: return VK_FORMAT_R16_SFLOAT;
+            }
         case DataType::Int:
             switch (size)
             {
@@ -149,23 +200,41 @@ VkFormat VertexArray::getVulkanFormat(DataType type, int size) const
                 case 4: return VK_FORMAT_R32G32B32A32_UINT;
                 default: return VK_FORMAT_R32_UINT;
             }
+        case DataType::Short:
+            switch (size)
+            {
+                case 1: return normalized ? VK_FORMAT_R16_SNORM : VK_FORMAT_R16_SINT;
+                case 2: return normalized ? VK_FORMAT_R16G16_SNORM : VK_FORMAT_R16G16_SINT;
+                case 3: return normalized ? VK_FORMAT_R16G16B16_SNORM : VK_FORMAT_R16G16B16_SINT;
+                case 4: return normalized ? VK_FORMAT_R16G16B16A16_SNORM : VK_FORMAT_R16G16B16A16_SINT;
+                default: return normalized ? VK_FORMAT_R16_SNORM : VK_FORMAT_R16_SINT;
+            }
+        case DataType::UnsignedShort:
+            switch (size)
+            {
+                case 1: return normalized ? VK_FORMAT_R16_UNORM : VK_FORMAT_R16_UINT;
+                case 2: return normalized ? VK_FORMAT_R16G16_UNORM : VK_FORMAT_R16G16_UINT;
+                case 3: return normalized ? VK_FORMAT_R16G16B16_UNORM : VK_FORMAT_R16G16B16_UINT;
+                case 4: return normalized ? VK_FORMAT_R16G16B16A16_UNORM : VK_FORMAT_R16G16B16A16_UINT;
+                default: return normalized ? VK_FORMAT_R16_UNORM : VK_FORMAT_R16_UINT;
+            }
         case DataType::Byte:
             switch (size)
             {
-                case 1: return VK_FORMAT_R8_SINT;
-                case 2: return VK_FORMAT_R8G8_SINT;
-                case 3: return VK_FORMAT_R8G8B8_SINT;
-                case 4: return VK_FORMAT_R8G8B8A8_SINT;
-                default: return VK_FORMAT_R8_SINT;
+                case 1: return normalized ? VK_FORMAT_R8_SNORM : VK_FORMAT_R8_SINT;
+                case 2: return normalized ? VK_FORMAT_R8G8_SNORM : VK_FORMAT_R8G8_SINT;
+                case 3: return normalized ? VK_FORMAT_R8G8B8_SNORM : VK_FORMAT_R8G8B8_SINT;
+                case 4: return normalized ? VK_FORMAT_R8G8B8A8_SNORM : VK_FORMAT_R8G8B8A8_SINT;
+                default: return normalized ? VK_FORMAT_R8_SNORM : VK_FORMAT_R8_SINT;
             }
         case DataType::UnsignedByte:
             switch (size)
             {
-                case 1: return VK_FORMAT_R8_UINT;
-                case 2: return VK_FORMAT_R8G8_UINT;
-                case 3: return VK_FORMAT_R8G8B8_UINT;
-                case 4: return VK_FORMAT_R8G8B8A8_UINT;
-                default: return VK_FORMAT_R8_UINT;
+                case 1: return normalized ? VK_FORMAT_R8_UNORM : VK_FORMAT_R8_UINT;
+                case 2: return normalized ? VK_FORMAT_R8G8_UNORM : VK_FORMAT_R8G8_UINT;
+                case 3: return normalized ? VK_FORMAT_R8G8B8_UNORM : VK_FORMAT_R8G8B8_UINT;
+                case 4: return normalized ? VK_FORMAT_R8G8B8A8_UNORM : VK_FORMAT_R8G8B8A8_UINT;
+                default: return normalized ? VK_FORMAT_R8_UNORM : VK_FORMAT_R8_UINT;
             }
         default:
             return VK_FORMAT_R32_SFLOAT;
@@ -1,8 +1,8 @@
 #pragma once
 
 #include "../RenderAPI/IVertexArray.h"
+#include "PipelineState.h"
 #include <vulkan/vulkan.h>
-#include <vector>
 #include <memory>
 
 namespace VK
@@ -28,23 +28,27 @@ namespace VK
         void addAttribute(const ::VertexAttribute& attribute) override;
 
         // Vulkan-specific methods
-        const std::vector<VkVertexInputAttributeDescription>& getAttributeDescriptions() const;
-        const VkVertexInputBindingDescription& getBindingDescription() const;
+        // Vertex input of pipelines drawing from this array, part of their pipeline key
+        const VertexInputLayout& getVertexInputLayout() const { return m_vertexInput; }
+        bool hasAttributes() const { return m_vertexInput.attributeCount > 0; }
         void setVertexBuffer(VertexBuffer* buffer);
         VertexBuffer* getVertexBuffer() const { return m_vertexBuffer; }
+        // Stand-in for GL_ARRAY_BUFFER, captured by the per-instance attributes added next
+        void setArrayBuffer(VertexBuffer* buffer) { m_arrayBuffer = buffer; }
+        VertexBuffer* getInstanceBuffer() const { return m_instanceBuffer; }
+        bool hasInstanceAttributes() const { return m_vertexInput.instanceStride > 0; }
         void setIndexBuffer(IndexBuffer* buffer);
         IndexBuffer* getIndexBuffer() const { return m_indexBuffer; }
 
     private:
-        VkFormat getVulkanFormat(DataType type, int size) const;
+        VkFormat getVulkanFormat(DataType type, int size, bool normalized) const;
 
         Renderer* m_renderer;
-        std::vector<VkVertexInputAttributeDescription> m_attributes;
-        VkVertexInputBindingDescription m_binding;
+        VertexInputLayout m_vertexInput;
         VertexBuffer* m_vertexBuffer;
+        VertexBuffer* m_instanceBuffer;
+        VertexBuffer* m_arrayBuffer;
         IndexBuffer* m_indexBuffer;
-        uint32_t m_stride;
-        bool m_bindingInitialized;
     };
 }
 
@@ -15,6 +15,7 @@ VertexBuffer::VertexBuffer(VkDevice device, VkPhysicalDevice physicalDevice, Ren
     , m_buffer(VK_NULL_HANDLE)
     , m_memory(VK_NULL_HANDLE)
     , m_size(0)
+    , m_deviceLocal(false)
 {
 }
 
@@ -30,6 +31,7 @@ VertexBuffer::VertexBuffer(VertexBuffer&& other) noexcept
     , m_buffer(other.m_buffer)
     , m_memory(other.m_memory)
     , m_size(other.m_size)
+    , m_deviceLocal(other.m_deviceLocal)
 {
     other.m_renderer = nullptr;
     other.m_buffer = VK_NULL_HANDLE;
@@ -49,6 +51,7 @@ VertexBuffer& VertexBuffer::operator=(VertexBuffer&& other) noexcept
         m_buffer = other.m_buffer;
         m_memory = other.m_memory;
         m_size = other.m_size;
+        m_deviceLocal = other.m_deviceLocal;
 
         other.m_renderer = nullptr;
         other.m_buffer = VK_NULL_HANDLE;
@@ -61,7 +64,15 @@ VertexBuffer& VertexBuffer::operator=(VertexBuffer&& other) noexcept
 void VertexBuffer::bind()
 {
     // In Vulkan, binding is done via vkCmdBindVertexBuffers in the command buffer
-    // This method is a no-op for compatibility with the interface
+    // Attributes added to the bound vertex array next read from this buffer
+    if (m_renderer)
+    {
+        VertexArray* boundVAO = m_renderer->getActiveVertexArray();
+        if (boundVAO)
+        {
+            boundVAO->setArrayBuffer(this);
+        }
+    }
 }
 
 void VertexBuffer::unbind()
@@ -76,15 +87,28 @@ void VertexBuffer::setData(const void* data, size_t size, ::BufferUsage usage)
 
     m_size = size;
 
-    // Create buffer with host visible memory for simplicity
-    createBuffer(size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    // Static data lives in device-local memory and is uploaded through the staging ring,
+    // data that changes often stays host visible and is filled directly on creation
+    m_deviceLocal = (usage == ::BufferUsage::Static && m_renderer != nullptr);
 
-    // Copy data to buffer
-    void* mappedData;
-    vkMapMemory(m_device, m_memory, 0, size, 0, &mappedData);
-    std::memcpy(mappedData, data, size);
-    vkUnmapMemory(m_device, m_memory);
+    if (m_deviceLocal)
+    {
+        createBuffer(size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        m_renderer->uploadToBuffer(m_buffer, 0, data, size);
+    }
+    else
+    {
+        // Updates are still copied in the frame's command buffer, see updateData()
+        createBuffer(size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+        // Copy data to buffer
+        void* mappedData;
+        vkMapMemory(m_device, m_memory, 0, size, 0, &mappedData);
+        std::memcpy(mappedData, data, size);
+        vkUnmapMemory(m_device, m_memory);
+    }
 
     // Associate with the currently bound vertex array (like OpenGL behavior)
     if (m_renderer)
@@ -114,10 +138,10 @@ void VertexBuffer::updateData(const void* data, size_t size, size_t offset)
         return;
     }
 
-    void* mappedData;
-    vkMapMemory(m_device, m_memory, offset, size, 0, &mappedData);
-    std::memcpy(mappedData, data, size);
-    vkUnmapMemory(m_device, m_memory);
+    // Ordered with the draws of the frame, frames in flight keep reading the old contents.
+    // Host-visible buffers too: written in place, the data would change under those frames.
+    m_renderer->updateBuffer(m_buffer, offset, data, size,
+                             VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
 }
 
 void VertexBuffer::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties)
@@ -128,6 +152,12 @@ void VertexBuffer::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkM
     bufferInfo.usage = usage;
     bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
+    // Device-local buffers are written by the transfer queue
+    if (m_deviceLocal)
+    {
+        m_renderer->applyUploadSharingMode(bufferInfo);
+    }
+
     if (vkCreateBuffer(m_device, &bufferInfo, nullptr, &m_buffer) != VK_SUCCESS)
     {
         throw std::runtime_error("Failed to create Vulkan vertex buffer");
@@ -170,24 +200,20 @@ void VertexBuffer::cleanup()
 {
     if (m_buffer != VK_NULL_HANDLE || m_memory != VK_NULL_HANDLE)
     {
-        // CRITICAL: Wait for device to finish using this buffer before destroying it
-        // This prevents validation errors about destroying in-use resources
-        if (m_device != VK_NULL_HANDLE)
-        {
-            vkDeviceWaitIdle(m_device);
-        }
-
-        if (m_buffer != VK_NULL_HANDLE)
-        {
-            vkDestroyBuffer(m_device, m_buffer, nullptr);
-            m_buffer = VK_NULL_HANDLE;
-        }
-
-        if (m_memory != VK_NULL_HANDLE)
+        if (m_renderer)
         {
-            vkFreeMemory(m_device, m_memory, nullptr);
-            m_memory = VK_NULL_HANDLE;
+            // Drop a copy still queued in an open upload batch
+            if (m_deviceLocal)
+            {
+                m_renderer->cancelPendingUploads(m_buffer);
+            }
+
+            // Destroyed once the frames that may still read the buffer have completed
+            m_renderer->deferDeleteBuffer(m_buffer);
+            m_renderer->deferDeleteDeviceMemory(m_memory);
         }
+        m_buffer = VK_NULL_HANDLE;
+        m_memory = VK_NULL_HANDLE;
 
         m_size = 0;
     }
@@ -11,7 +11,8 @@ namespace VK
     class VertexBuffer : public IVertexBuffer
     {
     public:
-        VertexBuffer(VkDevice device, VkPhysicalDevice physicalDevice, Renderer* renderer = nullptr);
+        // Required, destruction is deferred on the renderer's frame timeline
+        VertexBuffer(VkDevice device, VkPhysicalDevice physicalDevice, Renderer* renderer);
         ~VertexBuffer() override;
 
         VertexBuffer(const VertexBuffer&) = delete;
@@ -39,6 +40,7 @@ namespace VK
         VkBuffer m_buffer;
         VkDeviceMemory m_memory;
         VkDeviceSize m_size;
+        bool m_deviceLocal;  // Static data, written through the staging ring
     };
 }
 